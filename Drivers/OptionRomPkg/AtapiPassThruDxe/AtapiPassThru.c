@@ -239,6 +239,7 @@ Returns:
                     );
   if (!EFI_ERROR (Status)) {
     Supports &= (EFI_PCI_DEVICE_ENABLE               |
+                 EFI_PCI_IO_ATTRIBUTE_BUS_MASTER     |
                  EFI_PCI_IO_ATTRIBUTE_IDE_PRIMARY_IO |
                  EFI_PCI_IO_ATTRIBUTE_IDE_SECONDARY_IO);
     Status = PciIo->Attributes (
@@ -369,6 +370,20 @@ Returns:
     return Status;
   }
 
+  AtapiPassThruReportThroughput (AtapiScsiPrivate);
+
+  if (AtapiScsiPrivate->PrdTable != NULL) {
+    AtapiScsiPrivate->PciIo->Unmap (
+                               AtapiScsiPrivate->PciIo,
+                               AtapiScsiPrivate->PrdTableMap
+                               );
+    AtapiScsiPrivate->PciIo->FreeBuffer (
+                               AtapiScsiPrivate->PciIo,
+                               ATAPI_PRD_TABLE_PAGES,
+                               AtapiScsiPrivate->PrdTable
+                               );
+  }
+
   //
   // Restore original PCI attributes
   //
@@ -416,6 +431,8 @@ Returns:
   EFI_STATUS                Status;
   ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate;
   IDE_REGISTERS_BASE_ADDR   IdeRegsBaseAddr[ATAPI_MAX_CHANNEL];
+  VOID                      *PrdTable;
+  UINTN                     Bytes;
 
   AtapiScsiPrivate = AllocateZeroPool (sizeof (ATAPI_SCSI_PASS_THRU_DEV));
   if (AtapiScsiPrivate == NULL) {
@@ -442,6 +459,68 @@ Returns:
 
   InitAtapiIoPortRegisters(AtapiScsiPrivate, IdeRegsBaseAddr);
 
+  //
+  // The bus master engine fetches its PRD table from memory, so it needs a
+  // common buffer below 4GB. If any of this fails the controller is still
+  // usable through PIO.
+  //
+  if (IdeRegsBaseAddr[IdePrimary].BusMasterBaseAddr != 0) {
+    Status = PciIo->AllocateBuffer (
+                      PciIo,
+                      AllocateAnyPages,
+                      EfiBootServicesData,
+                      ATAPI_PRD_TABLE_PAGES,
+                      &PrdTable,
+                      0
+                      );
+    if (!EFI_ERROR (Status)) {
+      Bytes  = EFI_PAGES_TO_SIZE (ATAPI_PRD_TABLE_PAGES);
+      Status = PciIo->Map (
+                        PciIo,
+                        EfiPciIoOperationBusMasterCommonBuffer,
+                        PrdTable,
+                        &Bytes,
+                        &AtapiScsiPrivate->PrdTablePhyAddr,
+                        &AtapiScsiPrivate->PrdTableMap
+                        );
+      if (EFI_ERROR (Status) ||
+          Bytes != EFI_PAGES_TO_SIZE (ATAPI_PRD_TABLE_PAGES) ||
+          AtapiScsiPrivate->PrdTablePhyAddr > MAX_UINT32) {
+        if (!EFI_ERROR (Status)) {
+          PciIo->Unmap (PciIo, AtapiScsiPrivate->PrdTableMap);
+        }
+        PciIo->FreeBuffer (PciIo, ATAPI_PRD_TABLE_PAGES, PrdTable);
+      } else {
+        AtapiScsiPrivate->PrdTable = PrdTable;
+      }
+    }
+  }
+
+  DEBUG ((
+    EFI_D_INFO,
+    "AtapiPassThru: bus master BAR 0x%x, data transfers use %a\n",
+    IdeRegsBaseAddr[IdePrimary].BusMasterBaseAddr,
+    (AtapiScsiPrivate->PrdTable != NULL) ? "DMA" : "PIO"
+    ));
+
+  //
+  // The timestamp source is optional; without it only commands and bytes
+  // are counted.
+  //
+  Status = gBS->LocateProtocol (
+                  &gEfiTimestampProtocolGuid,
+                  NULL,
+                  (VOID **) &AtapiScsiPrivate->Timestamp
+                  );
+  if (!EFI_ERROR (Status)) {
+    Status = AtapiScsiPrivate->Timestamp->GetProperties (
+                                            &AtapiScsiPrivate->TimestampProperties
+                                            );
+  }
+  if (EFI_ERROR (Status) || AtapiScsiPrivate->TimestampProperties.Frequency == 0) {
+    AtapiScsiPrivate->Timestamp = NULL;
+  }
+
   //
   // Initialize the LatestTargetId to MAX_TARGET_ID.
   //
@@ -449,6 +528,10 @@ Returns:
   AtapiScsiPrivate->LatestLun       = 0;
 
   Status = InstallScsiPassThruProtocols (&Controller, AtapiScsiPrivate);
+  if (EFI_ERROR (Status) && AtapiScsiPrivate->PrdTable != NULL) {
+    PciIo->Unmap (PciIo, AtapiScsiPrivate->PrdTableMap);
+    PciIo->FreeBuffer (PciIo, ATAPI_PRD_TABLE_PAGES, AtapiScsiPrivate->PrdTable);
+  }
 
   return Status;
 }
@@ -844,6 +927,11 @@ Returns:
     }
   }
 
+  //
+  // Devices may fall back to their default transfer mode, check again.
+  //
+  ZeroMem (AtapiScsiPrivate->DmaState, sizeof (AtapiScsiPrivate->DmaState));
+
   if (ResetFlag) {
     return EFI_SUCCESS;
   }
@@ -1358,6 +1446,11 @@ Returns:
     }
   }
 
+  //
+  // Devices may fall back to their default transfer mode, check again.
+  //
+  ZeroMem (AtapiScsiPrivate->DmaState, sizeof (AtapiScsiPrivate->DmaState));
+
   if (ResetFlag) {
     return EFI_SUCCESS;
   }
@@ -1568,6 +1661,7 @@ Returns:
 {
   EFI_STATUS  Status;
   PCI_TYPE00  PciData;
+  UINT16      BusMasterBaseAddr;
 
   Status = PciIo->Pci.Read (
                         PciIo,
@@ -1617,6 +1711,23 @@ Returns:
     (UINT16) ((PciData.Device.Bar[3] & 0x0000fffc) + 2);
   }
 
+  //
+  // Bus master registers live in the IO BAR4 when the Programming Interface
+  // advertises bus master capability, in either operating mode.
+  //
+  BusMasterBaseAddr = 0;
+  if ((PciData.Hdr.ClassCode[0] & IDE_BUS_MASTER_CAPABLE) != 0 &&
+      (PciData.Device.Bar[4] & BIT0) != 0) {
+    BusMasterBaseAddr = (UINT16) (PciData.Device.Bar[4] & 0x0000fff0);
+  }
+
+  IdeRegsBaseAddr[IdePrimary].BusMasterBaseAddr   = BusMasterBaseAddr;
+  IdeRegsBaseAddr[IdeSecondary].BusMasterBaseAddr = 0;
+  if (BusMasterBaseAddr != 0) {
+    IdeRegsBaseAddr[IdeSecondary].BusMasterBaseAddr =
+    (UINT16) (BusMasterBaseAddr + BUS_MASTER_CHANNEL_STRIDE);
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -1646,6 +1757,7 @@ Returns:
   UINT8               IdeChannel;
   UINT16              CommandBlockBaseAddr;
   UINT16              ControlBlockBaseAddr;
+  UINT16              BusMasterBaseAddr;
   IDE_BASE_REGISTERS  *RegisterPointer;
 
 
@@ -1671,6 +1783,13 @@ Returns:
 
     (*(UINT16 *) &RegisterPointer->Alt) = ControlBlockBaseAddr;
     RegisterPointer->DriveAddress = (UINT16) (ControlBlockBaseAddr + 0x01);
+
+    BusMasterBaseAddr = IdeRegsBaseAddr[IdeChannel].BusMasterBaseAddr;
+    if (BusMasterBaseAddr != 0) {
+      RegisterPointer->BusMasterCommand  = (UINT16) (BusMasterBaseAddr + BMIC_OFFSET);
+      RegisterPointer->BusMasterStatus   = (UINT16) (BusMasterBaseAddr + BMIS_OFFSET);
+      RegisterPointer->BusMasterPrdTable = (UINT16) (BusMasterBaseAddr + BMIDTP_OFFSET);
+    }
   }
 
 }
@@ -2171,10 +2290,20 @@ Returns:
 --*/
 {
 
-  UINT16      *CommandIndex;
-  UINT8       Count;
-  EFI_STATUS  Status;
+  UINT16            *CommandIndex;
+  UINT8             Count;
+  EFI_STATUS        Status;
+  BOOLEAN           UseDma;
+  BOOLEAN           AllowDma;
+  VOID              *DmaMapping;
+  ATAPI_DMA_RESULT  DmaResult;
+  UINT32            BufferSize;
+  UINT64            StartTicks;
+
+  AllowDma   = TRUE;
+  BufferSize = *ByteCount;
 
+Retry:
   //
   // Set all the command parameters by fill related registers.
   // Before write to all the following registers, BSY must be 0.
@@ -2184,6 +2313,20 @@ Returns:
     return EFI_DEVICE_ERROR;
   }
 
+  //
+  // Map the buffer and build the PRD table before the command is issued,
+  // so that a buffer DMA cannot reach still goes out through PIO.
+  //
+  UseDma     = FALSE;
+  DmaMapping = NULL;
+  DmaResult  = AtapiDmaComplete;
+  if (AllowDma &&
+      AtapiPassThruIsDmaCandidate (AtapiScsiPrivate, PacketCommand, Buffer, *ByteCount, Direction) &&
+      AtapiPassThruDeviceDmaEnabled (AtapiScsiPrivate, Target)) {
+    Status = AtapiPassThruDmaPrepare (AtapiScsiPrivate, Buffer, *ByteCount, Direction, &DmaMapping);
+    UseDma = (BOOLEAN) !EFI_ERROR (Status);
+  }
+
 
   //
   // Select device via Device/Head Register.
@@ -2206,16 +2349,16 @@ Returns:
       Status = EFI_DEVICE_ERROR;
     }
     *ByteCount = 0;
-    return Status;
+    goto Exit;
   }
 
   //
-  // No OVL; No DMA (by setting feature register)
+  // No OVL; DMA only when the bus master engine has been prepared
   //
   WritePortB (
     AtapiScsiPrivate->PciIo,
     AtapiScsiPrivate->IoPort->Reg1.Feature,
-    0x00
+    (UINT8) (UseDma ? DMA : 0x00)
     );
 
   //
@@ -2235,12 +2378,14 @@ Returns:
 
   //
   //  DEFAULT_CTL:0x0a (0000,1010)
-  //  Disable interrupt
+  //  Disable interrupt for PIO. DMA completion is signalled through the
+  //  Interrupt bit of the bus master status register, which only latches
+  //  INTRQ while it is enabled.
   //
   WritePortB (
     AtapiScsiPrivate->PciIo,
     AtapiScsiPrivate->IoPort->Alt.DeviceControl,
-    DEFAULT_CTL
+    (UINT8) (UseDma ? 0x00 : DEFAULT_CTL)
     );
 
   //
@@ -2265,7 +2410,7 @@ Returns:
     }
 
     *ByteCount = 0;
-    return Status;
+    goto Exit;
   }
 
   //
@@ -2276,17 +2421,65 @@ Returns:
     WritePortW (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Data, *CommandIndex);
   }
 
+  StartTicks = 0;
+  if (AtapiScsiPrivate->Timestamp != NULL) {
+    StartTicks = AtapiScsiPrivate->Timestamp->GetTimestamp ();
+  }
+
+  if (UseDma) {
+    Status = AtapiPassThruDmaReadWriteData (
+               AtapiScsiPrivate,
+               ByteCount,
+               Direction,
+               TimeoutInMicroSeconds,
+               &DmaResult
+               );
+  } else {
+    //
+    // call AtapiPassThruPioReadWriteData() function to get
+    // requested transfer data form device.
+    //
+    Status = AtapiPassThruPioReadWriteData (
+               AtapiScsiPrivate,
+               Buffer,
+               ByteCount,
+               Direction,
+               TimeoutInMicroSeconds
+               );
+  }
+
+  if (!EFI_ERROR (Status) && *ByteCount != 0) {
+    AtapiPassThruRecordTransfer (
+      AtapiScsiPrivate,
+      UseDma ? AtapiTransferDma : AtapiTransferPio,
+      *ByteCount,
+      StartTicks
+      );
+  }
+
+Exit:
+  if (DmaMapping != NULL) {
+    AtapiScsiPrivate->PciIo->Unmap (AtapiScsiPrivate->PciIo, DmaMapping);
+  }
+
   //
-  // call AtapiPassThruPioReadWriteData() function to get
-  // requested transfer data form device.
+  // A DMA data phase that did not complete leaves the device in an unknown
+  // state. Reset the channel and send the command once more through PIO,
+  // which copes with any transfer length. A device that failed the DMA
+  // transfer itself stays on PIO from now on.
   //
-  return AtapiPassThruPioReadWriteData (
-          AtapiScsiPrivate,
-          Buffer,
-          ByteCount,
-          Direction,
-          TimeoutInMicroSeconds
-          );
+  if (UseDma && DmaResult != AtapiDmaComplete) {
+    if (DmaResult == AtapiDmaTransportError) {
+      AtapiScsiPrivate->DmaState[AtapiScsiPrivate->IoPort - AtapiScsiPrivate->AtapiIoPortRegisters][Target & 1] =
+        AtapiDmaDisabled;
+    }
+    AtapiPassThruResetIoChannel (AtapiScsiPrivate);
+    *ByteCount = BufferSize;
+    AllowDma   = FALSE;
+    goto Retry;
+  }
+
+  return Status;
 }
 
 EFI_STATUS
@@ -2415,6 +2608,617 @@ Arguments:
   return Status;
 }
 
+BOOLEAN
+AtapiPassThruIsDmaCandidate (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  UINT8                     *PacketCommand,
+  VOID                      *Buffer,
+  UINT32                    ByteCount,
+  DATA_DIRECTION            Direction
+  )
+/*++
+
+Routine Description:
+
+  Decide whether the data phase of an ATAPI command can use bus master DMA.
+  Only the medium read/write commands move enough data to amortize the
+  mapping; a buffer that does not match the CDB transfer length is caught
+  by AtapiPassThruDmaReadWriteData() and retried through PIO. Everything
+  else stays on PIO.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  PacketCommand:      Points to the ATAPI command packet.
+  Buffer:             Points to the transferred data.
+  ByteCount:          The buffer size.
+  Direction:          Indicates the data transfer direction.
+
+Returns:
+
+  TRUE if the transfer should use DMA, FALSE if it should use PIO.
+
+--*/
+{
+  if (AtapiScsiPrivate->PrdTable == NULL ||
+      AtapiScsiPrivate->IoPort->BusMasterCommand == 0) {
+    return FALSE;
+  }
+
+  if (Buffer == NULL || ByteCount == 0 || (ByteCount & BIT0) != 0) {
+    return FALSE;
+  }
+
+  if (Direction != DataIn && Direction != DataOut) {
+    return FALSE;
+  }
+
+  switch (PacketCommand[0]) {
+  case OP_READ_10:
+  case OP_READ_12:
+  case OP_READ_CD:
+  case OP_WRITE_10:
+  case OP_WRITE_12:
+  case OP_WRITE_AND_VERIFY:
+    return TRUE;
+
+  default:
+    return FALSE;
+  }
+}
+
+EFI_STATUS
+AtapiPassThruDmaPrepare (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  VOID                      *Buffer,
+  UINT32                    ByteCount,
+  DATA_DIRECTION            Direction,
+  VOID                      **Mapping
+  )
+/*++
+
+Routine Description:
+
+  Map the data buffer for bus master DMA, build the PRD table describing it
+  and program the bus master registers of the current channel. The engine
+  is not started.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Buffer:             Points to the transferred data.
+  ByteCount:          The buffer size.
+  Direction:          Indicates the data transfer direction.
+  Mapping:            Receives the mapping to release once the transfer ends.
+
+Returns:
+
+  EFI_SUCCESS         The transfer is ready to be started.
+  EFI_UNSUPPORTED     The buffer cannot be described; fall back to PIO.
+
+--*/
+{
+  EFI_STATUS            Status;
+  EFI_PCI_IO_PROTOCOL   *PciIo;
+  IDE_BASE_REGISTERS    *IoPort;
+  EFI_PHYSICAL_ADDRESS  DeviceAddress;
+  UINTN                 MappedBytes;
+  UINT32                Remaining;
+  UINT32                Length;
+  UINTN                 Index;
+  UINT8                 Command;
+
+  PciIo       = AtapiScsiPrivate->PciIo;
+  IoPort      = AtapiScsiPrivate->IoPort;
+  MappedBytes = ByteCount;
+  Status      = PciIo->Map (
+                         PciIo,
+                         (Direction == DataIn) ? EfiPciIoOperationBusMasterWrite :
+                                                 EfiPciIoOperationBusMasterRead,
+                         Buffer,
+                         &MappedBytes,
+                         &DeviceAddress,
+                         Mapping
+                         );
+  if (EFI_ERROR (Status)) {
+    *Mapping = NULL;
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // PRD entries carry 32-bit word aligned addresses and the whole buffer
+  // has to be covered by one command.
+  //
+  if (MappedBytes != ByteCount ||
+      (DeviceAddress & BIT0) != 0 ||
+      DeviceAddress + ByteCount - 1 > MAX_UINT32) {
+    goto Unsupported;
+  }
+
+  Index     = 0;
+  Remaining = ByteCount;
+  while (Remaining != 0) {
+    if (Index == ATAPI_PRD_MAX_ENTRIES) {
+      goto Unsupported;
+    }
+
+    //
+    // Stop each region at the next 64KB boundary.
+    //
+    Length = ATAPI_PRD_MAX_BYTE_COUNT - ((UINT32) DeviceAddress & (ATAPI_PRD_MAX_BYTE_COUNT - 1));
+    if (Length > Remaining) {
+      Length = Remaining;
+    }
+
+    AtapiScsiPrivate->PrdTable[Index].RegionBaseAddr = (UINT32) DeviceAddress;
+    AtapiScsiPrivate->PrdTable[Index].ByteCount      = (UINT16) Length;
+    AtapiScsiPrivate->PrdTable[Index].EndOfTable     = 0;
+
+    DeviceAddress += Length;
+    Remaining     -= Length;
+    Index++;
+  }
+  AtapiScsiPrivate->PrdTable[Index - 1].EndOfTable = ATAPI_PRD_EOT;
+
+  //
+  // Stop any previous transfer, clear the sticky Interrupt and Error bits
+  // and point the engine at the new table.
+  //
+  WritePortB (PciIo, IoPort->BusMasterCommand, 0);
+  WritePortB (
+    PciIo,
+    IoPort->BusMasterStatus,
+    (UINT8) (ReadPortB (PciIo, IoPort->BusMasterStatus) | BMIS_INTERRUPT | BMIS_ERROR)
+    );
+  WritePortDW (PciIo, IoPort->BusMasterPrdTable, (UINT32) AtapiScsiPrivate->PrdTablePhyAddr);
+
+  Command = (Direction == DataIn) ? BMIC_NREAD : 0;
+  WritePortB (PciIo, IoPort->BusMasterCommand, Command);
+
+  return EFI_SUCCESS;
+
+Unsupported:
+  PciIo->Unmap (PciIo, *Mapping);
+  *Mapping = NULL;
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+AtapiPassThruDmaReadWriteData (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  UINT32                    *ByteCount,
+  DATA_DIRECTION            Direction,
+  UINT64                    TimeoutInMicroSeconds,
+  ATAPI_DMA_RESULT          *DmaResult
+  )
+/*++
+
+Routine Description:
+
+  Starts the bus master engine prepared by AtapiPassThruDmaPrepare() after
+  the ATAPI command packet is sent and waits for the data phase to complete.
+  Completion is taken from the Interrupt bit of the bus master status
+  register or from the device leaving the data phase, the device status is
+  checked afterwards as in the PIO path.
+
+  The PRD table covers exactly the buffer, so the whole buffer has been
+  transferred when the engine has exhausted the table and the device has
+  completed. A device that completes while the engine is still active moved
+  less than the buffer, a device still requesting data once the table is
+  exhausted wants more. Neither length can be read back in DMA mode, so both
+  are reported as AtapiDmaLengthMismatch for the caller to retry through PIO.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  ByteCount:          When input,indicates the buffer size; when output,
+                      indicates the actually transferred data size.
+  Direction:          Indicates the data transfer direction.
+  TimeoutInMicroSeconds:
+                      The timeout, in micro second units, to wait for the
+                      transfer. A value of 0 means wait indefinitely.
+  DmaResult:          Receives whether the command has to be retried
+                      through PIO.
+
+Returns:
+
+  EFI_STATUS
+
+--*/
+{
+  EFI_PCI_IO_PROTOCOL *PciIo;
+  IDE_BASE_REGISTERS  *IoPort;
+  EFI_STATUS          Status;
+  UINT64              Delay;
+  UINT8               Command;
+  UINT8               BusMasterStatus;
+  UINT8               DeviceStatus;
+  UINTN               OverrunPolls;
+
+  PciIo   = AtapiScsiPrivate->PciIo;
+  IoPort  = AtapiScsiPrivate->IoPort;
+  Command = ReadPortB (PciIo, IoPort->BusMasterCommand);
+  WritePortB (PciIo, IoPort->BusMasterCommand, (UINT8) (Command | BMIC_START));
+
+  if (TimeoutInMicroSeconds == 0) {
+    Delay = 2;
+  } else {
+    Delay = DivU64x32 (TimeoutInMicroSeconds, (UINT32) 30) + 1;
+  }
+
+  *DmaResult   = AtapiDmaComplete;
+  OverrunPolls = 0;
+  do {
+    BusMasterStatus = ReadPortB (PciIo, IoPort->BusMasterStatus);
+    if ((BusMasterStatus & (BMIS_INTERRUPT | BMIS_ERROR)) != 0) {
+      break;
+    }
+
+    //
+    // Stall for 30 us
+    //
+    gBS->Stall (30);
+
+    //
+    // The device may also leave the data phase without the Interrupt bit
+    // being latched. Reading the alternate status does not acknowledge
+    // INTRQ. An exhausted table with DRQ still set has to be seen twice, the
+    // device needs a moment to drop DRQ after the last word.
+    //
+    DeviceStatus = ReadPortB (PciIo, IoPort->Alt.AltStatus);
+    if ((DeviceStatus & (BSY | DRQ)) == 0) {
+      BusMasterStatus = ReadPortB (PciIo, IoPort->BusMasterStatus);
+      break;
+    }
+
+    if ((DeviceStatus & (BSY | DRQ)) == DRQ &&
+        (ReadPortB (PciIo, IoPort->BusMasterStatus) & BMIS_ACTIVE) == 0) {
+      OverrunPolls++;
+      if (OverrunPolls == 2) {
+        BusMasterStatus = ReadPortB (PciIo, IoPort->BusMasterStatus);
+        break;
+      }
+    } else {
+      OverrunPolls = 0;
+    }
+
+    //
+    // Loop infinitely if not meeting expected condition
+    //
+    if (TimeoutInMicroSeconds == 0) {
+      Delay = 2;
+    }
+
+    Delay--;
+  } while (Delay);
+
+  //
+  // Stop the engine and clear its status whatever the outcome, then
+  // restore the PIO default of a masked INTRQ.
+  //
+  WritePortB (PciIo, IoPort->BusMasterCommand, (UINT8) (Command & ~BMIC_START));
+  WritePortB (
+    PciIo,
+    IoPort->BusMasterStatus,
+    (UINT8) (ReadPortB (PciIo, IoPort->BusMasterStatus) | BMIS_INTERRUPT | BMIS_ERROR)
+    );
+  WritePortB (PciIo, IoPort->Alt.DeviceControl, DEFAULT_CTL);
+
+  if (Delay == 0) {
+    DEBUG ((EFI_D_ERROR, "AtapiPassThruDmaReadWriteData: timeout, BMIS %02x\n", BusMasterStatus));
+    *DmaResult = AtapiDmaTransportError;
+    *ByteCount = 0;
+    return EFI_TIMEOUT;
+  }
+
+  if ((BusMasterStatus & BMIS_ERROR) != 0) {
+    DEBUG ((EFI_D_ERROR, "AtapiPassThruDmaReadWriteData: bus master error, BMIS %02x\n", BusMasterStatus));
+    *DmaResult = AtapiDmaTransportError;
+    *ByteCount = 0;
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (OverrunPolls == 2) {
+    DEBUG ((EFI_D_INFO, "AtapiPassThruDmaReadWriteData: device wants more than %d bytes\n", *ByteCount));
+    *DmaResult = AtapiDmaLengthMismatch;
+    *ByteCount = 0;
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  StatusWaitForBSYClear (AtapiScsiPrivate, TimeoutInMicroSeconds);
+
+  //
+  // Reading the status register also acknowledges INTRQ. A device reported
+  // error is final, the PIO path would end the same way.
+  //
+  Status = AtapiPassThruCheckErrorStatus (AtapiScsiPrivate);
+  if (EFI_ERROR (Status)) {
+    *ByteCount = 0;
+    return Status;
+  }
+
+  if ((BusMasterStatus & BMIS_ACTIVE) != 0) {
+    DEBUG ((EFI_D_INFO, "AtapiPassThruDmaReadWriteData: device moved less than %d bytes\n", *ByteCount));
+    *DmaResult = AtapiDmaLengthMismatch;
+    *ByteCount = 0;
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  return EFI_SUCCESS;
+}
+
+BOOLEAN
+AtapiPassThruDeviceDmaEnabled (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  UINT32                    Target
+  )
+/*++
+
+Routine Description:
+
+  Check whether a device on the current channel may use bus master DMA.
+  The first call reads the IDENTIFY PACKET DEVICE data: the device has to
+  support DMA, must not require the DMADIR bit, and must have a Multiword
+  or Ultra DMA mode selected. The driver does not select a mode itself as
+  the matching controller timings are chipset specific; it relies on the
+  mode the platform configured.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             The Target ID of the ATAPI device.
+
+Returns:
+
+  TRUE if the device supports DMA and has a DMA mode selected.
+
+--*/
+{
+  ATAPI_DMA_STATE  *DmaState;
+  UINT16           IdentifyData[ATAPI_ID_WORDS];
+  EFI_STATUS       Status;
+
+  DmaState = &AtapiScsiPrivate->DmaState[AtapiScsiPrivate->IoPort - AtapiScsiPrivate->AtapiIoPortRegisters][Target & 1];
+  if (*DmaState != AtapiDmaUnknown) {
+    return (BOOLEAN) (*DmaState == AtapiDmaEnabled);
+  }
+
+  *DmaState = AtapiDmaDisabled;
+  Status    = AtapiPassThruIdentifyPacketDevice (AtapiScsiPrivate, Target, IdentifyData);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_INFO, "AtapiPassThru: target %d identify failed - %r, using PIO\n", Target, Status));
+    return FALSE;
+  }
+
+  if ((IdentifyData[ATAPI_ID_CAPABILITIES] & BIT8) != 0 &&
+      (IdentifyData[ATAPI_ID_DMADIR] & BIT15) == 0) {
+    if ((IdentifyData[ATAPI_ID_MULTIWORD_DMA] & (BIT8 | BIT9 | BIT10)) != 0 ||
+        ((IdentifyData[ATAPI_ID_FIELD_VALIDITY] & BIT2) != 0 &&
+         (IdentifyData[ATAPI_ID_ULTRA_DMA] & 0x7F00) != 0)) {
+      *DmaState = AtapiDmaEnabled;
+    }
+  }
+
+  DEBUG ((
+    EFI_D_INFO,
+    "AtapiPassThru: target %d caps %04x MWDMA %04x UDMA %04x, using %a\n",
+    Target,
+    IdentifyData[ATAPI_ID_CAPABILITIES],
+    IdentifyData[ATAPI_ID_MULTIWORD_DMA],
+    IdentifyData[ATAPI_ID_ULTRA_DMA],
+    (*DmaState == AtapiDmaEnabled) ? "DMA" : "PIO"
+    ));
+
+  return (BOOLEAN) (*DmaState == AtapiDmaEnabled);
+}
+
+EFI_STATUS
+AtapiPassThruIdentifyPacketDevice (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  UINT32                    Target,
+  UINT16                    *IdentifyData
+  )
+/*++
+
+Routine Description:
+
+  Read the IDENTIFY PACKET DEVICE data of a device on the current channel.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             The Target ID of the ATAPI device.
+  IdentifyData:       Receives ATAPI_ID_WORDS words of identify data.
+
+Returns:
+
+  EFI_STATUS
+
+--*/
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  Status = StatusWaitForBSYClear (AtapiScsiPrivate, ATAPI_IDENTIFY_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Head,
+    (UINT8) ((Target << 4) | DEFAULT_CMD)
+    );
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Alt.DeviceControl,
+    DEFAULT_CTL
+    );
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Reg.Command,
+    ATAPI_IDENTIFY_CMD
+    );
+
+  Status = StatusDRQReady (AtapiScsiPrivate, ATAPI_IDENTIFY_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  for (Index = 0; Index < ATAPI_ID_WORDS; Index++) {
+    IdentifyData[Index] = ReadPortW (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Data);
+  }
+
+  StatusDRQClear (AtapiScsiPrivate, ATAPI_IDENTIFY_TIMEOUT);
+
+  return AtapiPassThruCheckErrorStatus (AtapiScsiPrivate);
+}
+
+VOID
+AtapiPassThruResetIoChannel (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate
+  )
+/*++
+
+Routine Description:
+
+  Soft reset the current channel after a failed DMA data phase.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+
+Returns:
+
+  None
+
+--*/
+{
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Alt.DeviceControl,
+    (UINT8) (SRST | IEN_L)
+    );
+
+  //
+  // Wait 10us
+  //
+  gBS->Stall (10);
+
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Alt.DeviceControl,
+    IEN_L
+    );
+
+  StatusWaitForBSYClear (AtapiScsiPrivate, ATAPI_RESET_TIMEOUT);
+}
+
+VOID
+AtapiPassThruRecordTransfer (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  ATAPI_TRANSFER_MODE       Mode,
+  UINT32                    ByteCount,
+  UINT64                    StartTicks
+  )
+/*++
+
+Routine Description:
+
+  Account one data phase to the throughput statistics of a transfer mode,
+  and report the mode's throughput whenever it crosses a report interval.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Mode:               The transfer mode used for the data phase.
+  ByteCount:          The number of bytes transferred.
+  StartTicks:         Timestamp taken before the data phase started.
+
+Returns:
+
+  None
+
+--*/
+{
+  ATAPI_TRANSFER_STATS  *Stats;
+  UINT64                EndTicks;
+  UINT64                PreviousBytes;
+
+  Stats = &AtapiScsiPrivate->TransferStats[Mode];
+
+  if (AtapiScsiPrivate->Timestamp != NULL) {
+    EndTicks = AtapiScsiPrivate->Timestamp->GetTimestamp ();
+    if (EndTicks >= StartTicks) {
+      Stats->Ticks += EndTicks - StartTicks;
+    } else {
+      Stats->Ticks += AtapiScsiPrivate->TimestampProperties.EndValue - StartTicks + EndTicks + 1;
+    }
+  }
+
+  PreviousBytes = Stats->Bytes;
+  Stats->Commands++;
+  Stats->Bytes += ByteCount;
+
+  if (DivU64x32 (PreviousBytes, ATAPI_STATS_REPORT_INTERVAL) !=
+      DivU64x32 (Stats->Bytes, ATAPI_STATS_REPORT_INTERVAL)) {
+    AtapiPassThruReportThroughput (AtapiScsiPrivate);
+  }
+}
+
+VOID
+AtapiPassThruReportThroughput (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate
+  )
+/*++
+
+Routine Description:
+
+  Print the accumulated throughput of each transfer mode.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the controller.
+
+Returns:
+
+  None
+
+--*/
+{
+  ATAPI_TRANSFER_STATS  *Stats;
+  UINTN                 Mode;
+  UINT64                KiloBytesPerSecond;
+
+  for (Mode = 0; Mode < AtapiTransferModeMax; Mode++) {
+    Stats = &AtapiScsiPrivate->TransferStats[Mode];
+    if (Stats->Commands == 0) {
+      continue;
+    }
+
+    KiloBytesPerSecond = 0;
+    if (Stats->Ticks != 0) {
+      KiloBytesPerSecond = DivU64x64Remainder (
+                             MultU64x64 (
+                               DivU64x32 (Stats->Bytes, SIZE_1KB),
+                               AtapiScsiPrivate->TimestampProperties.Frequency
+                               ),
+                             Stats->Ticks,
+                             NULL
+                             );
+    }
+
+    DEBUG ((
+      EFI_D_INFO,
+      "AtapiPassThru: %a %ld commands, %ld bytes, %ld KB/s\n",
+      (Mode == AtapiTransferDma) ? "DMA" : "PIO",
+      Stats->Commands,
+      Stats->Bytes,
+      KiloBytesPerSecond
+      ));
+  }
+}
+
 
 UINT8
 ReadPortB (
@@ -2558,6 +3362,40 @@ Returns:
               );
 }
 
+VOID
+WritePortDW (
+  IN  EFI_PCI_IO_PROTOCOL   *PciIo,
+  IN  UINT16                Port,
+  IN  UINT32                Data
+  )
+/*++
+
+Routine Description:
+
+  Write one dword to a specified I/O port.
+
+Arguments:
+
+  PciIo      - The pointer of EFI_PCI_IO_PROTOCOL
+  Port       - IO port
+  Data       - The data to write
+
+Returns:
+
+   NONE
+
+--*/
+{
+  PciIo->Io.Write (
+              PciIo,
+              EfiPciIoWidthUint32,
+              EFI_PCI_IO_PASS_THROUGH_BAR,
+              (UINT64) Port,
+              1,
+              &Data
+              );
+}
+
 EFI_STATUS
 StatusDRQClear (
   ATAPI_SCSI_PASS_THRU_DEV        *AtapiScsiPrivate,
@@ -17,6 +17,7 @@
 #include <Protocol/ScsiPassThruExt.h>
 #include <Protocol/PciIo.h>
 #include <Protocol/DriverSupportedEfiVersion.h>
+#include <Protocol/Timestamp.h>
 
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
@@ -68,6 +69,41 @@ typedef enum {
 #define IDE_PRIMARY_PROGRAMMABLE_INDICATOR    BIT1
 #define IDE_SECONDARY_OPERATING_MODE          BIT2
 #define IDE_SECONDARY_PROGRAMMABLE_INDICATOR  BIT3
+#define IDE_BUS_MASTER_CAPABLE                BIT7
+
+//
+// Bus master IDE registers, relative to each channel's base in BAR4.
+// The secondary channel's registers follow the primary's at offset 8.
+//
+#define BMIC_OFFSET               0x00  ///< Bus Master IDE Command
+#define BMIS_OFFSET               0x02  ///< Bus Master IDE Status
+#define BMIDTP_OFFSET             0x04  ///< Descriptor Table Pointer
+#define BUS_MASTER_CHANNEL_STRIDE 0x08
+
+#define BMIC_START                BIT0
+#define BMIC_NREAD                BIT3  ///< Bus master writes to memory
+
+#define BMIS_ACTIVE               BIT0
+#define BMIS_ERROR                BIT1
+#define BMIS_INTERRUPT            BIT2
+
+//
+// Physical Region Descriptor. Each region is word aligned, at most 64KB
+// long and may not cross a 64KB boundary. A ByteCount of 0 means 64KB.
+//
+#pragma pack(1)
+typedef struct {
+  UINT32  RegionBaseAddr;
+  UINT16  ByteCount;
+  UINT16  EndOfTable;
+} ATAPI_PRD_ENTRY;
+#pragma pack()
+
+#define ATAPI_PRD_EOT             BIT15
+#define ATAPI_PRD_MAX_BYTE_COUNT  SIZE_64KB
+#define ATAPI_PRD_TABLE_PAGES     1
+#define ATAPI_PRD_MAX_ENTRIES     \
+  (EFI_PAGES_TO_SIZE (ATAPI_PRD_TABLE_PAGES) / sizeof (ATAPI_PRD_ENTRY))
 
 
 #define ATAPI_MAX_CHANNEL 2
@@ -86,8 +122,54 @@ typedef struct {
   IDE_CMD_OR_STATUS               Reg;
   IDE_AltStatus_OR_DeviceControl  Alt;
   UINT16                          DriveAddress;
+  //
+  // Bus master registers, all 0 when the channel only supports PIO
+  //
+  UINT16                          BusMasterCommand;
+  UINT16                          BusMasterStatus;
+  UINT16                          BusMasterPrdTable;
 } IDE_BASE_REGISTERS;
 
+//
+// Bus master DMA use of one device, decided from its IDENTIFY PACKET DEVICE
+// data the first time a command could use DMA.
+//
+typedef enum {
+  AtapiDmaUnknown     = 0,
+  AtapiDmaDisabled    = 1,
+  AtapiDmaEnabled     = 2
+} ATAPI_DMA_STATE;
+
+//
+// Outcome of a DMA data phase. Anything but AtapiDmaComplete makes the
+// command go out again through PIO after a channel reset.
+//
+typedef enum {
+  AtapiDmaComplete        = 0,  ///< Done, or failed with a device reported error
+  AtapiDmaLengthMismatch  = 1,  ///< Device moved less or more than the buffer
+  AtapiDmaTransportError  = 2   ///< Timeout or bus master error
+} ATAPI_DMA_RESULT;
+
+typedef enum {
+  AtapiTransferPio    = 0,
+  AtapiTransferDma    = 1,
+  AtapiTransferModeMax
+} ATAPI_TRANSFER_MODE;
+
+///
+/// Data phase accounting for one transfer mode
+///
+typedef struct {
+  UINT64  Commands;
+  UINT64  Bytes;
+  UINT64  Ticks;
+} ATAPI_TRANSFER_STATS;
+
+//
+// Report throughput every time a mode moves another 16MB
+//
+#define ATAPI_STATS_REPORT_INTERVAL SIZE_16MB
+
 #define ATAPI_SCSI_PASS_THRU_DEV_SIGNATURE  SIGNATURE_32 ('a', 's', 'p', 't')
 
 typedef struct {
@@ -104,6 +186,23 @@ typedef struct {
   IDE_BASE_REGISTERS               AtapiIoPortRegisters[2];
   UINT32                           LatestTargetId;
   UINT64                           LatestLun;
+  //
+  // PRD table shared by both channels, NULL when bus master DMA is not
+  // available and all transfers use PIO.
+  //
+  ATAPI_PRD_ENTRY                  *PrdTable;
+  EFI_PHYSICAL_ADDRESS             PrdTablePhyAddr;
+  VOID                             *PrdTableMap;
+  //
+  // DMA use of each device, indexed by channel and Target
+  //
+  ATAPI_DMA_STATE                  DmaState[ATAPI_MAX_CHANNEL][2];
+  //
+  // Throughput accounting, timed when a timestamp source is present
+  //
+  EFI_TIMESTAMP_PROTOCOL           *Timestamp;
+  EFI_TIMESTAMP_PROPERTIES         TimestampProperties;
+  ATAPI_TRANSFER_STATS             TransferStats[AtapiTransferModeMax];
 } ATAPI_SCSI_PASS_THRU_DEV;
 
 //
@@ -112,6 +211,7 @@ typedef struct {
 typedef struct {
   UINT16  CommandBlockBaseAddr;
   UINT16  ControlBlockBaseAddr;
+  UINT16  BusMasterBaseAddr;
 } IDE_REGISTERS_BASE_ADDR;
 
 #define ATAPI_SCSI_PASS_THRU_DEV_FROM_THIS(a) \
@@ -177,6 +277,20 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gAtapiScsiPassThruDriverSuppor
 // ATA Command
 //
 #define ATAPI_SOFT_RESET_CMD  0x08
+#define ATAPI_IDENTIFY_CMD    0xA1
+
+//
+// IDENTIFY PACKET DEVICE words checked before DMA is used
+//
+#define ATAPI_ID_CAPABILITIES       49  ///< BIT8: DMA supported
+#define ATAPI_ID_FIELD_VALIDITY     53  ///< BIT2: word 88 valid
+#define ATAPI_ID_DMADIR             62  ///< BIT15: DMADIR bit required
+#define ATAPI_ID_MULTIWORD_DMA      63  ///< BIT8-10: Multiword DMA mode selected
+#define ATAPI_ID_ULTRA_DMA          88  ///< BIT8-14: Ultra DMA mode selected
+#define ATAPI_ID_WORDS              256
+
+#define ATAPI_IDENTIFY_TIMEOUT      3000000
+#define ATAPI_RESET_TIMEOUT         31000000
 
 typedef enum {
   DataIn  = 0,
@@ -1276,6 +1390,31 @@ Returns:
 --*/
 ;
 
+VOID
+WritePortDW (
+  IN  EFI_PCI_IO_PROTOCOL   *PciIo,
+  IN  UINT16                Port,
+  IN  UINT32                Data
+  )
+/*++
+
+Routine Description:
+
+  Write one dword to a specified I/O port.
+
+Arguments:
+
+  PciIo      - The pointer of EFI_PCI_IO_PROTOCOL
+  Port       - IO port
+  Data       - The data to write
+
+Returns:
+
+   NONE
+
+--*/
+;
+
 EFI_STATUS
 StatusDRQClear (
   ATAPI_SCSI_PASS_THRU_DEV        *AtapiScsiPrivate,
@@ -1526,6 +1665,219 @@ Arguments:
 --*/
 ;
 
+BOOLEAN
+AtapiPassThruIsDmaCandidate (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  UINT8                     *PacketCommand,
+  VOID                      *Buffer,
+  UINT32                    ByteCount,
+  DATA_DIRECTION            Direction
+  )
+/*++
+
+Routine Description:
+
+  Decide whether the data phase of an ATAPI command can use bus master DMA.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  PacketCommand:      Points to the ATAPI command packet.
+  Buffer:             Points to the transferred data.
+  ByteCount:          The buffer size.
+  Direction:          Indicates the data transfer direction.
+
+Returns:
+
+  TRUE if the transfer should use DMA, FALSE if it should use PIO.
+
+--*/
+;
+
+EFI_STATUS
+AtapiPassThruDmaPrepare (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  VOID                      *Buffer,
+  UINT32                    ByteCount,
+  DATA_DIRECTION            Direction,
+  VOID                      **Mapping
+  )
+/*++
+
+Routine Description:
+
+  Map the data buffer for bus master DMA, build the PRD table describing it
+  and program the bus master registers of the current channel. The engine
+  is not started.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Buffer:             Points to the transferred data.
+  ByteCount:          The buffer size.
+  Direction:          Indicates the data transfer direction.
+  Mapping:            Receives the mapping to release once the transfer ends.
+
+Returns:
+
+  EFI_SUCCESS         The transfer is ready to be started.
+  EFI_UNSUPPORTED     The buffer cannot be described; fall back to PIO.
+
+--*/
+;
+
+EFI_STATUS
+AtapiPassThruDmaReadWriteData (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  UINT32                    *ByteCount,
+  DATA_DIRECTION            Direction,
+  UINT64                    TimeoutInMicroSeconds,
+  ATAPI_DMA_RESULT          *DmaResult
+  )
+/*++
+
+Routine Description:
+
+  Starts the bus master engine prepared by AtapiPassThruDmaPrepare() after
+  the ATAPI command packet is sent and waits for the data phase to complete.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  ByteCount:          When input,indicates the buffer size; when output,
+                      indicates the actually transferred data size.
+  Direction:          Indicates the data transfer direction.
+  TimeoutInMicroSeconds:
+                      The timeout, in micro second units, to wait for the
+                      transfer. A value of 0 means wait indefinitely.
+  DmaResult:          Receives whether the command has to be retried
+                      through PIO.
+
+Returns:
+
+  EFI_STATUS
+
+--*/
+;
+
+BOOLEAN
+AtapiPassThruDeviceDmaEnabled (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  UINT32                    Target
+  )
+/*++
+
+Routine Description:
+
+  Check whether a device on the current channel may use bus master DMA.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             The Target ID of the ATAPI device.
+
+Returns:
+
+  TRUE if the device supports DMA and has a DMA mode selected.
+
+--*/
+;
+
+EFI_STATUS
+AtapiPassThruIdentifyPacketDevice (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  UINT32                    Target,
+  UINT16                    *IdentifyData
+  )
+/*++
+
+Routine Description:
+
+  Read the IDENTIFY PACKET DEVICE data of a device on the current channel.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             The Target ID of the ATAPI device.
+  IdentifyData:       Receives ATAPI_ID_WORDS words of identify data.
+
+Returns:
+
+  EFI_STATUS
+
+--*/
+;
+
+VOID
+AtapiPassThruResetIoChannel (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate
+  )
+/*++
+
+Routine Description:
+
+  Soft reset the current channel after a failed DMA data phase.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+
+Returns:
+
+  None
+
+--*/
+;
+
+VOID
+AtapiPassThruRecordTransfer (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
+  ATAPI_TRANSFER_MODE       Mode,
+  UINT32                    ByteCount,
+  UINT64                    StartTicks
+  )
+/*++
+
+Routine Description:
+
+  Account one data phase to the throughput statistics of a transfer mode,
+  and report the mode's throughput whenever it crosses a report interval.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Mode:               The transfer mode used for the data phase.
+  ByteCount:          The number of bytes transferred.
+  StartTicks:         Timestamp taken before the data phase started.
+
+Returns:
+
+  None
+
+--*/
+;
+
+VOID
+AtapiPassThruReportThroughput (
+  ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate
+  )
+/*++
+
+Routine Description:
+
+  Print the accumulated throughput of each transfer mode.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the controller.
+
+Returns:
+
+  None
+
+--*/
+;
+
 EFI_STATUS
 AtapiPassThruCheckErrorStatus (
   ATAPI_SCSI_PASS_THRU_DEV        *AtapiScsiPrivate
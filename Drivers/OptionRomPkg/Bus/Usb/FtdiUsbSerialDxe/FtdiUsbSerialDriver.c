@@ -204,109 +204,207 @@ SetStatusInternal (
 }
 
 /**
-  Initiates a read operation on the Usb Serial Device.
+  Returns the number of received bytes waiting in the receive ring.
+
+  @param  UsbSerialDevice[in]  Handle to the Usb Serial Device
+
+  @return The number of bytes that can be read from the ring
+
+**/
+UINT32
+RxRingCount (
+  IN USB_SER_DEV  *UsbSerialDevice
+  )
+{
+  return (UsbSerialDevice->DataBufferTail - UsbSerialDevice->DataBufferHead) &
+         (FTDI_RX_RING_SIZE - 1);
+}
+
+/**
+  Appends received bytes to the receive ring. The caller must have checked
+  that the ring has room for them and must be running at TPL_NOTIFY.
+
+  @param  UsbSerialDevice[in]  Handle to the Usb Serial Device
+  @param  Data[in]             The received bytes
+  @param  Length[in]           The number of bytes in Data
+
+**/
+VOID
+RxRingPut (
+  IN USB_SER_DEV  *UsbSerialDevice,
+  IN UINT8        *Data,
+  IN UINTN        Length
+  )
+{
+  UINTN  Chunk;
+
+  Chunk = FTDI_RX_RING_SIZE - UsbSerialDevice->DataBufferTail;
+  if (Chunk > Length) {
+    Chunk = Length;
+  }
+  CopyMem (&UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferTail], Data, Chunk);
+  CopyMem (UsbSerialDevice->DataBuffer, Data + Chunk, Length - Chunk);
+
+  UsbSerialDevice->DataBufferTail = (UINT32) ((UsbSerialDevice->DataBufferTail + Length) &
+                                              (FTDI_RX_RING_SIZE - 1));
+}
+
+/**
+  Removes up to Length bytes from the receive ring. The caller must be
+  running at TPL_NOTIFY.
+
+  @param  UsbSerialDevice[in]  Handle to the Usb Serial Device
+  @param  Buffer[out]          The buffer to return the data into
+  @param  Length[in]           The size of Buffer
+
+  @return The number of bytes copied into Buffer
+
+**/
+UINTN
+RxRingGet (
+  IN  USB_SER_DEV  *UsbSerialDevice,
+  OUT UINT8        *Buffer,
+  IN  UINTN        Length
+  )
+{
+  UINTN  Chunk;
+
+  if (Length > RxRingCount (UsbSerialDevice)) {
+    Length = RxRingCount (UsbSerialDevice);
+  }
+
+  Chunk = FTDI_RX_RING_SIZE - UsbSerialDevice->DataBufferHead;
+  if (Chunk > Length) {
+    Chunk = Length;
+  }
+  CopyMem (Buffer, &UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferHead], Chunk);
+  CopyMem (Buffer + Chunk, UsbSerialDevice->DataBuffer, Length - Chunk);
+
+  UsbSerialDevice->DataBufferHead = (UINT32) ((UsbSerialDevice->DataBufferHead + Length) &
+                                              (FTDI_RX_RING_SIZE - 1));
+  return Length;
+}
+
+/**
+  Drains the bulk-in endpoint of the Usb Serial Device into the receive ring.
+
+  Up to FTDI_RX_TRANSFERS_PER_POLL transfers are issued back to back. The
+  pass ends early on a short transfer, which means the device FIFO is empty,
+  or when the ring could not take another full transfer; in that case the
+  data stays in the device until the ring is read. The two status bytes that
+  start every packet are stripped, and all other bytes, including nulls, are
+  stored.
 
   @param  UsbSerialDevice[in]        Handle to the USB device to read
-  @param  BufferSize[in, out]        On input, the size of the Buffer. On output,
-                                     the amount of data returned in Buffer.
-                                     Setting this to zero will initiate a read
-                                     and store all data returned in the internal
-                                     buffer.
-  @param  Buffer [out]               The buffer to return the data into.
 
-  @retval EFI_SUCCESS                The data was read.
+  @retval EFI_SUCCESS                The endpoint was drained or the ring is
+                                     full.
   @retval EFI_DEVICE_ERROR           The device reported an error.
-  @retval EFI_TIMEOUT                The data write was stopped due to a timeout.
+  @retval EFI_TIMEOUT                The data read was stopped due to a timeout.
 
 **/
 EFI_STATUS
 EFIAPI
 ReadDataFromUsb (
-  IN USB_SER_DEV  *UsbSerialDevice,
-  IN OUT UINTN    *BufferSize,
-  OUT VOID        *Buffer
+  IN USB_SER_DEV  *UsbSerialDevice
   )
 {
   EFI_STATUS  Status;
   UINTN       ReadBufferSize;
   UINT8       *ReadBuffer;
-  UINTN       Index;
+  UINTN       PacketSize;
+  UINTN       Offset;
+  UINTN       Length;
+  UINTN       Transfer;
+  UINT32      Received;
   EFI_TPL     Tpl;
-  UINT8       StatusBuffer[2]; // buffer to store the status bytes
-
-  ReadBufferSize = 512;
-  ReadBuffer     = &(UsbSerialDevice->ReadBuffer[0]);
 
   if (UsbSerialDevice->Shutdown) {
     return EFI_DEVICE_ERROR;
   }
 
+  //
+  // Only one pass may own the bulk-in endpoint. A Read that finds the
+  // polling loop already draining the device just uses what it stored.
+  //
   Tpl = gBS->RaiseTPL (TPL_NOTIFY);
-
-  Status = UsbSerialDataTransfer (
-             UsbSerialDevice,
-             EfiUsbDataIn,
-             ReadBuffer,
-             &ReadBufferSize,
-             FTDI_TIMEOUT*2  //Padded because timers won't be exactly aligned
-             );
-  if (EFI_ERROR (Status)) {
+  if (UsbSerialDevice->Receiving) {
     gBS->RestoreTPL (Tpl);
-    if (Status == EFI_TIMEOUT) {
-      return EFI_TIMEOUT;
-    } else {
-      return EFI_DEVICE_ERROR;
-    }
+    return EFI_SUCCESS;
   }
+  UsbSerialDevice->Receiving = TRUE;
+  gBS->RestoreTPL (Tpl);
 
-  //
-  // Store the status bytes in the status buffer
-  //
-  for (Index = 0; Index < 2; Index++) {//only the first 2 bytes are status bytes
-    StatusBuffer[Index] = ReadBuffer[Index];
-  }
-  //
-  // update the statusvalue field of the usbserialdevice
-  //
-  Status = SetStatusInternal (UsbSerialDevice, StatusBuffer);
-  if (Status != EFI_SUCCESS) {
+  PacketSize = UsbSerialDevice->InEndpointDescriptor.MaxPacketSize;
+  if (PacketSize <= FTDI_STATUS_BYTE_COUNT) {
+    PacketSize = FTDI_RX_TRANSFER_SIZE;
   }
 
-  //
-  // Store the read data in the read buffer, start at 2 to ignore status bytes
-  //
-  for (Index = 2; Index < ReadBufferSize; Index++) {
-    if (((UsbSerialDevice->DataBufferTail + 1) % SW_FIFO_DEPTH) == UsbSerialDevice->DataBufferHead) {
+  ReadBuffer = &(UsbSerialDevice->ReadBuffer[0]);
+  Received   = 0;
+  Status     = EFI_SUCCESS;
+
+  for (Transfer = 0; Transfer < FTDI_RX_TRANSFERS_PER_POLL; Transfer++) {
+    if ((FTDI_RX_RING_SIZE - 1) - RxRingCount (UsbSerialDevice) < FTDI_RX_TRANSFER_SIZE) {
+      break;
+    }
+
+    ReadBufferSize = FTDI_RX_TRANSFER_SIZE;
+    Status = UsbSerialDataTransfer (
+               UsbSerialDevice,
+               EfiUsbDataIn,
+               ReadBuffer,
+               &ReadBufferSize,
+               FTDI_TIMEOUT*2  //Padded because timers won't be exactly aligned
+               );
+    if (EFI_ERROR (Status)) {
       break;
     }
-    if (ReadBuffer[Index] == 0x00) {
+
+    Tpl = gBS->RaiseTPL (TPL_NOTIFY);
+    for (Offset = 0; Offset < ReadBufferSize; Offset += PacketSize) {
+      Length = MIN (PacketSize, ReadBufferSize - Offset);
+      if (Length < FTDI_STATUS_BYTE_COUNT) {
+        break;
+      }
+
       //
-      // This is null, do not add
+      // update the statusvalue field of the usbserialdevice
       //
-    } else {
-      UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferTail] = ReadBuffer[Index];
-      UsbSerialDevice->DataBufferTail = (UsbSerialDevice->DataBufferTail + 1) % SW_FIFO_DEPTH;
+      SetStatusInternal (UsbSerialDevice, &ReadBuffer[Offset]);
+      if ((ReadBuffer[Offset + 1] & FTDI_LSR_OVERRUN) != 0) {
+        UsbSerialDevice->RxOverruns++;
+      }
+
+      Length -= FTDI_STATUS_BYTE_COUNT;
+      RxRingPut (UsbSerialDevice, &ReadBuffer[Offset + FTDI_STATUS_BYTE_COUNT], Length);
+      Received += (UINT32) Length;
     }
-  }
+    gBS->RestoreTPL (Tpl);
 
-  //
-  // Read characters out of the buffer to satisfy caller's request.
-  //
-  for (Index = 0; Index < *BufferSize; Index++) {
-    if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
+    if (ReadBufferSize < FTDI_RX_TRANSFER_SIZE) {
       break;
     }
-    //
-    // Still have characters in the buffer to return
-    //
-    ((UINT8 *)Buffer)[Index]        = UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferHead];
-    UsbSerialDevice->DataBufferHead = (UsbSerialDevice->DataBufferHead + 1) % SW_FIFO_DEPTH;
   }
-  //
-  // Return actual number of bytes returned.
-  //
-  *BufferSize = Index;
+
+  Tpl = gBS->RaiseTPL (TPL_NOTIFY);
+  UsbSerialDevice->RxBytes       += Received;
+  UsbSerialDevice->RxWindowBytes += Received;
+  if (RxRingCount (UsbSerialDevice) == 0) {
+    UsbSerialDevice->ControlBits |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
+  } else {
+    UsbSerialDevice->ControlBits &= ~(EFI_SERIAL_INPUT_BUFFER_EMPTY);
+  }
+  UsbSerialDevice->Receiving = FALSE;
   gBS->RestoreTPL (Tpl);
+
+  if (EFI_ERROR (Status)) {
+    if (Status == EFI_TIMEOUT) {
+      return EFI_TIMEOUT;
+    } else {
+      return EFI_DEVICE_ERROR;
+    }
+  }
   return EFI_SUCCESS;
 }
 
@@ -363,7 +461,7 @@ SetInitialStatus (
 /**
   UsbSerialDriverCheckInput.
   attempts to read data in from the device periodically, stores any read data
-  and updates the control attributes.
+  and updates the control attributes and the receive rate.
 
   @param  Event[in]
   @param  Context[in]....The current instance of the USB serial device
@@ -376,36 +474,63 @@ UsbSerialDriverCheckInput (
   IN  VOID       *Context
   )
 {
-  UINTN        BufferSize;
   USB_SER_DEV  *UsbSerialDevice;
+  EFI_TPL      Tpl;
+  UINT64       RxBytes;
+  UINT32       PollPeriodMs;
 
   UsbSerialDevice = (USB_SER_DEV*)Context;
 
-  if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
-    //
-    // Data buffer is empty, try to read from device
-    //
-    BufferSize = 0;
-    ReadDataFromUsb (UsbSerialDevice, &BufferSize, NULL);
-    if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
-      //
-      // Data buffer still has no data, set the EFI_SERIAL_INPUT_BUFFER_EMPTY
-      // flag
-      //
-      UsbSerialDevice->ControlBits |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
-    } else {
-      //
-      // Read has returned some data, clear the EFI_SERIAL_INPUT_BUFFER_EMPTY
-      // flag
-      //
-      UsbSerialDevice->ControlBits &= ~(EFI_SERIAL_INPUT_BUFFER_EMPTY);
-    }
+  Tpl = gBS->RaiseTPL (TPL_NOTIFY);
+  RxBytes = UsbSerialDevice->RxBytes;
+  gBS->RestoreTPL (Tpl);
+
+  ReadDataFromUsb (UsbSerialDevice);
+
+  Tpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  //
+  // Back off to the idle poll period while the line is quiet, and return to
+  // the fast period as soon as data arrives.
+  //
+  PollPeriodMs = UsbSerialDevice->RxPollPeriodMs;
+  if (UsbSerialDevice->RxBytes != RxBytes) {
+    UsbSerialDevice->RxIdlePolls = 0;
+    PollPeriodMs = FTDI_RX_POLL_PERIOD_MS;
+  } else if (UsbSerialDevice->RxIdlePolls < FTDI_RX_IDLE_POLLS) {
+    UsbSerialDevice->RxIdlePolls++;
   } else {
-    //
-    // Data buffer has data, no read attempt required
-    //
-    UsbSerialDevice->ControlBits &= ~(EFI_SERIAL_INPUT_BUFFER_EMPTY);
+    PollPeriodMs = FTDI_RX_IDLE_POLL_PERIOD_MS;
+  }
+
+  //
+  // Fold the bytes received over the last second into RxBytesPerSecond
+  //
+  UsbSerialDevice->RxWindowMs += UsbSerialDevice->RxPollPeriodMs;
+  if (UsbSerialDevice->RxWindowMs >= 1000) {
+    UsbSerialDevice->RxBytesPerSecond = UsbSerialDevice->RxWindowBytes * 1000 /
+                                        UsbSerialDevice->RxWindowMs;
+    UsbSerialDevice->RxWindowBytes    = 0;
+    UsbSerialDevice->RxWindowMs       = 0;
+    if (UsbSerialDevice->RxBytesPerSecond != 0) {
+      DEBUG ((
+        DEBUG_VERBOSE,
+        "FtdiUsbSerial: RX %u bytes/s, %lu overruns\n",
+        UsbSerialDevice->RxBytesPerSecond,
+        UsbSerialDevice->RxOverruns
+        ));
+    }
   }
+
+  if (PollPeriodMs != UsbSerialDevice->RxPollPeriodMs) {
+    UsbSerialDevice->RxPollPeriodMs = PollPeriodMs;
+    gBS->SetTimer (
+           Event,
+           TimerPeriodic,
+           EFI_TIMER_PERIOD_MILLISECONDS (PollPeriodMs)
+           );
+  }
+  gBS->RestoreTPL (Tpl);
 }
 
 /**
@@ -1361,6 +1486,51 @@ GetControlBitsInternal (
   return EFI_SUCCESS;
 }
 
+/**
+  Internal function that performs a Usb Control Transfer to set the latency
+  timer of the device, the time it waits before returning a partly filled
+  packet on the bulk-in endpoint.
+
+  @param  UsbIo[in]                  Usb Io Protocol instance pointer
+  @param  LatencyMs[in]              The latency in ms, between 1 and 255
+
+  @retval EFI_SUCCESS                The latency timer was set
+  @retval EFI_DEVICE_ERROR           The device is not functioning correctly
+
+**/
+EFI_STATUS
+EFIAPI
+SetLatencyTimerInternal (
+  IN EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN UINT8                LatencyMs
+  )
+{
+  EFI_STATUS              Status;
+  EFI_USB_DEVICE_REQUEST  DevReq;
+  UINT32                  ReturnValue;
+  UINT8                   ConfigurationValue;
+
+  DevReq.Request     = FTDI_COMMAND_SET_LATENCY_TIMER;
+  DevReq.RequestType = USB_REQ_TYPE_VENDOR;
+  DevReq.Value       = LatencyMs;
+  DevReq.Index       = FTDI_PORT_IDENTIFIER;
+  DevReq.Length      = 0; // indicates that there is no data phase in this request
+
+  Status = UsbIo->UsbControlTransfer (
+                    UsbIo,
+                    &DevReq,
+                    EfiUsbDataOut,
+                    WDR_SHORT_TIMEOUT,
+                    &ConfigurationValue,
+                    1,
+                    &ReturnValue
+                    );
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+  return Status;
+}
+
 /**
   Resets the USB Serial Device
 
@@ -1936,6 +2106,15 @@ UsbSerialDriverBindingStart (
 
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // A short latency timer lets an idle poll of the bulk-in endpoint return
+  // quickly. Devices that reject it keep the 16ms default.
+  //
+  Status = SetLatencyTimerInternal (UsbSerialDevice->UsbIo, FTDI_RX_LATENCY_MS);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "FtdiUsbSerial: failed to set latency timer - %r\n", Status));
+  }
+
   //
   // Publish Serial GUID and protocol
   //
@@ -1966,7 +2145,7 @@ UsbSerialDriverBindingStart (
   //
   // Allocate space for the receive buffer
   //
-  UsbSerialDevice->DataBuffer = AllocateZeroPool (SW_FIFO_DEPTH);
+  UsbSerialDevice->DataBuffer = AllocateZeroPool (FTDI_RX_RING_SIZE);
 
   //
   // Initialize data buffer pointers.
@@ -2006,13 +2185,15 @@ UsbSerialDriverBindingStart (
          &(UsbSerialDevice->PollingLoop)
          );
   //
-  // add code to set trigger time based on baud rate
-  // setting to 0.5s for now
+  // Poll often enough that the device FIFO (FTDI_MAX_RECEIVE_FIFO_DEPTH)
+  // does not overflow between two passes at high baud rates.
   //
+  UsbSerialDevice->RxPollPeriodMs = FTDI_RX_POLL_PERIOD_MS;
+  UsbSerialDevice->RxIdlePolls    = 0;
   gBS->SetTimer (
          UsbSerialDevice->PollingLoop,
          TimerPeriodic,
-         EFI_TIMER_PERIOD_MILLISECONDS (500)
+         EFI_TIMER_PERIOD_MILLISECONDS (FTDI_RX_POLL_PERIOD_MS)
          );
 
   //
@@ -2219,6 +2400,12 @@ UsbSerialDriverBindingStop (
                );
         gBS->CloseEvent (UsbSerialDevice->PollingLoop);
         UsbSerialDevice->Shutdown = TRUE;
+        DEBUG ((
+          DEBUG_INFO,
+          "FtdiUsbSerial: received %lu bytes, %lu overruns\n",
+          UsbSerialDevice->RxBytes,
+          UsbSerialDevice->RxOverruns
+          ));
         FreeUnicodeStringTable (UsbSerialDevice->ControllerNameTable);
         FreePool (UsbSerialDevice->DataBuffer);
         FreePool (UsbSerialDevice);
@@ -2462,9 +2649,9 @@ ReadSerialIo (
   )
 {
   UINTN        Index;
-  UINTN        RemainingCallerBufferSize;
   USB_SER_DEV  *UsbSerialDevice;
   EFI_STATUS   Status;
+  EFI_TPL      Tpl;
 
 
   if (*BufferSize == 0) {
@@ -2481,36 +2668,23 @@ ReadSerialIo (
   //
   // Clear out any data that we already have in our internal buffer
   //
-  for (Index = 0; Index < *BufferSize; Index++) {
-    if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
-      break;
-    }
-
-    //
-    // Still have characters in the buffer to return
-    //
-    ((UINT8 *)Buffer)[Index] = UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferHead];
-    UsbSerialDevice->DataBufferHead = (UsbSerialDevice->DataBufferHead + 1) % SW_FIFO_DEPTH;
-  }
+  Tpl   = gBS->RaiseTPL (TPL_NOTIFY);
+  Index = RxRingGet (UsbSerialDevice, Buffer, *BufferSize);
+  gBS->RestoreTPL (Tpl);
 
   //
   // If we haven't filled the caller's buffer using data that we already had on
-  // hand We need to generate an additional USB request to try and fill the
-  // caller's buffer
+  // hand, drain the device directly. This keeps callers running at or above
+  // TPL_CALLBACK, where the polling loop cannot run, making progress.
   //
   if (Index != *BufferSize) {
-    RemainingCallerBufferSize = *BufferSize - Index;
-    Status = ReadDataFromUsb (
-               UsbSerialDevice,
-               &RemainingCallerBufferSize,
-               (VOID *)(((CHAR8 *)Buffer) + Index)
-               );
-    if (!EFI_ERROR (Status)) {
-      *BufferSize = RemainingCallerBufferSize + Index;
-    } else {
-      *BufferSize = Index;
-    }
+    Status = ReadDataFromUsb (UsbSerialDevice);
+
+    Tpl    = gBS->RaiseTPL (TPL_NOTIFY);
+    Index += RxRingGet (UsbSerialDevice, (UINT8 *) Buffer + Index, *BufferSize - Index);
+    gBS->RestoreTPL (Tpl);
   }
+  *BufferSize = Index;
 
   if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
     //
@@ -168,9 +168,36 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define FTDI_ENDPOINT_ADDRESS_OUT  0x02 //the endpoint address for the out endpoint generated by the device
 
 //
-// Max buffer size for USB transfers
+// Receive pipeline. Each poll of the bulk-in endpoint issues up to
+// FTDI_RX_TRANSFERS_PER_POLL transfers of FTDI_RX_TRANSFER_SIZE bytes back to
+// back, and stops early once the device FIFO is drained. Received data lands
+// in a ring of FTDI_RX_RING_SIZE bytes, which must be a power of two.
 //
-#define SW_FIFO_DEPTH 1024
+// Every idle poll still waits out the latency timer in a synchronous
+// transfer, so after FTDI_RX_IDLE_POLLS polls without data the period is
+// lengthened to FTDI_RX_IDLE_POLL_PERIOD_MS, short enough for the device FIFO
+// to absorb the first characters at 115200 baud. The first poll that
+// receives data restores FTDI_RX_POLL_PERIOD_MS.
+//
+#define FTDI_RX_RING_SIZE            SIZE_16KB
+#define FTDI_RX_TRANSFER_SIZE        512
+#define FTDI_RX_TRANSFERS_PER_POLL   8
+#define FTDI_RX_POLL_PERIOD_MS       10
+#define FTDI_RX_IDLE_POLL_PERIOD_MS  25
+#define FTDI_RX_IDLE_POLLS           10
+
+//
+// Latency timer programmed into the device, in ms. An idle bulk-in poll
+// completes with a status-only packet after this delay.
+//
+#define FTDI_RX_LATENCY_MS           2
+
+//
+// Every bulk-in packet starts with two status bytes: the modem status
+// register, then the line status register.
+//
+#define FTDI_STATUS_BYTE_COUNT       2
+#define FTDI_LSR_OVERRUN             BIT1
 
 //
 // struct to define a usb device as a vendor and product id pair
@@ -239,12 +266,25 @@ typedef struct {
   UINT8                         *DataBuffer;
   EFI_SERIAL_IO_PROTOCOL        SerialIo;
   BOOLEAN                       Shutdown;
+  BOOLEAN                       Receiving;
   EFI_EVENT                     PollingLoop;
+  UINT32                        RxPollPeriodMs;
+  UINT32                        RxIdlePolls;
+  //
+  // Receive statistics. RxOverruns counts the overruns reported by the
+  // device in the line status byte, i.e. characters lost before the host
+  // could drain its FIFO.
+  //
+  UINT64                        RxBytes;
+  UINT64                        RxOverruns;
+  UINT32                        RxBytesPerSecond;
+  UINT32                        RxWindowBytes;
+  UINT32                        RxWindowMs;
   UINT32                        ControlBits;
   PREVIOUS_ATTRIBUTES           LastSettings;
   CONTROL_BITS                  ControlValues;
   STATUS_BITS                   StatusValues;
-  UINT8                         ReadBuffer[512];
+  UINT8                         ReadBuffer[FTDI_RX_TRANSFER_SIZE];
 } USB_SER_DEV;
 
 #define USB_SER_DEV_FROM_THIS(a) \
@@ -837,6 +837,8 @@ InitializeGraphicsMode (
   //
   ASSERT_EFI_ERROR (Status);
 
+  Private->BltSolidFill = (BOOLEAN) (DeviceId == CIRRUS_LOGIC_5446_DEVICE_ID);
+
   outw (Private, SEQ_ADDRESS_REGISTER, 0x1206);
   outw (Private, SEQ_ADDRESS_REGISTER, 0x0012);
 
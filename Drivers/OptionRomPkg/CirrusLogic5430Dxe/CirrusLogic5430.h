@@ -97,6 +97,7 @@ typedef struct {
   CIRRUS_LOGIC_5430_MODE_DATA           ModeData[CIRRUS_LOGIC_5430_MODE_COUNT];
   UINT8                                 *LineBuffer;
   BOOLEAN                               HardwareNeedsStarting;
+  BOOLEAN                               BltSolidFill;
 } CIRRUS_LOGIC_5430_PRIVATE_DATA;
 
 ///
@@ -152,6 +153,37 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gCirrusLogic5430DriverSupporte
 #define PALETTE_INDEX_REGISTER  0x3c8
 #define PALETTE_DATA_REGISTER   0x3c9
 
+//
+// BitBLT engine registers, indexed through GRAPH_ADDRESS_REGISTER
+//
+#define BLT_COLOR_BACKGROUND    0x00
+#define BLT_COLOR_FOREGROUND    0x01
+#define BLT_WIDTH               0x20  ///< 0x20-0x21, width in bytes - 1
+#define BLT_HEIGHT              0x22  ///< 0x22-0x23, height in lines - 1
+#define BLT_DEST_PITCH          0x24  ///< 0x24-0x25
+#define BLT_SOURCE_PITCH        0x26  ///< 0x26-0x27
+#define BLT_DEST_ADDRESS        0x28  ///< 0x28-0x2a
+#define BLT_SOURCE_ADDRESS      0x2c  ///< 0x2c-0x2e
+#define BLT_DEST_WRITE_MASK     0x2f
+#define BLT_MODE                0x30
+#define BLT_STATUS              0x31
+#define BLT_ROP                 0x32
+#define BLT_MODE_EXTENSIONS     0x33
+
+#define BLT_MODE_BACKWARDS      BIT0
+#define BLT_MODE_PATTERN_COPY   BIT6
+#define BLT_MODE_COLOR_EXPAND   BIT7
+
+#define BLT_STATUS_BUSY         BIT0
+#define BLT_STATUS_START        BIT1
+
+#define BLT_ROP_SRC_COPY        0x0d
+
+//
+// Solid fill is a GD5446 extension, emulated by QEMU's cirrus-vga
+//
+#define BLT_MODE_EXT_SOLID_FILL BIT2
+
 //
 // UGA Draw Hardware abstraction internal worker functions
 //
@@ -16,6 +16,107 @@ Abstract:
 #include "CirrusLogic5430.h"
 #include <IndustryStandard/Acpi.h>
 
+//
+// The palette programmed by SetDefaultPalette() is fixed, so the conversion
+// between GOP pixels and palette indexes is table driven in both directions.
+//
+STATIC UINT8                          mRedToPixel[256];
+STATIC UINT8                          mGreenToPixel[256];
+STATIC UINT8                          mBlueToPixel[256];
+STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL  mPixelToBltPixel[256];
+
+STATIC
+VOID
+CirrusLogic5430InitializeColorTables (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < 256; Index++) {
+    mRedToPixel[Index]   = RGB_BYTES_TO_PIXEL (Index, 0, 0);
+    mGreenToPixel[Index] = RGB_BYTES_TO_PIXEL (0, Index, 0);
+    mBlueToPixel[Index]  = RGB_BYTES_TO_PIXEL (0, 0, Index);
+
+    mPixelToBltPixel[Index].Red      = PIXEL_TO_RED_BYTE (Index);
+    mPixelToBltPixel[Index].Green    = PIXEL_TO_GREEN_BYTE (Index);
+    mPixelToBltPixel[Index].Blue     = PIXEL_TO_BLUE_BYTE (Index);
+    mPixelToBltPixel[Index].Reserved = 0;
+  }
+}
+
+/**
+  Run one operation on the BitBLT engine and wait for it to complete.
+
+  Offsets are byte offsets into video memory of the top left pixel of each
+  rectangle. Overlapping copies towards higher addresses are run backwards
+  so that source data is not overwritten before it is read.
+
+  @param  Private       The device private data.
+  @param  Offset        Destination offset.
+  @param  SourceOffset  Source offset, ignored for solid fills.
+  @param  Width         Width of the rectangle in pixels.
+  @param  Height        Height of the rectangle in lines.
+  @param  Pitch         Bytes per line of both rectangles.
+  @param  Mode          BLT_MODE_* bits for the operation.
+  @param  ModeExt       BLT_MODE_EXT_* bits for the operation.
+  @param  Color         Foreground color used by color expansion.
+
+**/
+STATIC
+VOID
+CirrusLogic5430BitBlt (
+  IN  CIRRUS_LOGIC_5430_PRIVATE_DATA  *Private,
+  IN  UINTN                           Offset,
+  IN  UINTN                           SourceOffset,
+  IN  UINTN                           Width,
+  IN  UINTN                           Height,
+  IN  UINTN                           Pitch,
+  IN  UINT8                           Mode,
+  IN  UINT8                           ModeExt,
+  IN  UINT8                           Color
+  )
+{
+  UINTN  LastPixel;
+
+  if ((Mode & BLT_MODE_COLOR_EXPAND) == 0 && Offset > SourceOffset) {
+    LastPixel     = (Height - 1) * Pitch + Width - 1;
+    Offset       += LastPixel;
+    SourceOffset += LastPixel;
+    Mode         |= BLT_MODE_BACKWARDS;
+  }
+
+  outw (Private, GRAPH_ADDRESS_REGISTER, BLT_COLOR_BACKGROUND);
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((Color << 8) | BLT_COLOR_FOREGROUND));
+
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((((Width - 1) << 8) & 0xff00) | BLT_WIDTH));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((Width - 1) & 0xff00) | (BLT_WIDTH + 1)));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((((Height - 1) << 8) & 0xff00) | BLT_HEIGHT));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((Height - 1) & 0xff00) | (BLT_HEIGHT + 1)));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((Pitch << 8) & 0xff00) | BLT_DEST_PITCH));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((Pitch & 0xff00) | (BLT_DEST_PITCH + 1)));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((Pitch << 8) & 0xff00) | BLT_SOURCE_PITCH));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((Pitch & 0xff00) | (BLT_SOURCE_PITCH + 1)));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((Offset << 8) & 0xff00) | BLT_DEST_ADDRESS));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((Offset & 0xff00) | (BLT_DEST_ADDRESS + 1)));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((Offset >> 8) & 0xff00) | (BLT_DEST_ADDRESS + 2)));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((SourceOffset << 8) & 0xff00) | BLT_SOURCE_ADDRESS));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((SourceOffset & 0xff00) | (BLT_SOURCE_ADDRESS + 1)));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((SourceOffset >> 8) & 0xff00) | (BLT_SOURCE_ADDRESS + 2)));
+  outw (Private, GRAPH_ADDRESS_REGISTER, BLT_DEST_WRITE_MASK);
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((Mode << 8) | BLT_MODE));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((BLT_ROP_SRC_COPY << 8) | BLT_ROP));
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((ModeExt << 8) | BLT_MODE_EXTENSIONS));
+  outw (Private, GRAPH_ADDRESS_REGISTER, 0x0034);
+  outw (Private, GRAPH_ADDRESS_REGISTER, 0x0035);
+
+  outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((BLT_STATUS_START << 8) | BLT_STATUS));
+
+  outb (Private, GRAPH_ADDRESS_REGISTER, BLT_STATUS);
+  while ((inb (Private, GRAPH_DATA_REGISTER) & BLT_STATUS_BUSY) == BLT_STATUS_BUSY)
+    ;
+}
+
 
 STATIC
 VOID
@@ -231,6 +332,7 @@ Returns:
   UINTN                           Offset;
   UINTN                           SourceOffset;
   UINT32                          CurrentMode;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *BltRow;
 
   Private = CIRRUS_LOGIC_5430_PRIVATE_DATA_FROM_GRAPHICS_OUTPUT_THIS (This);
 
@@ -320,12 +422,9 @@ Returns:
                               );
       }
 
+      BltRow = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) ((UINT8 *) BltBuffer + (DstY * Delta)) + DestinationX;
       for (X = 0; X < Width; X++) {
-        Blt         = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) ((UINT8 *) BltBuffer + (DstY * Delta) + (DestinationX + X) * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-
-        Blt->Red    = PIXEL_TO_RED_BYTE (Private->LineBuffer[X]);
-        Blt->Green  = PIXEL_TO_GREEN_BYTE (Private->LineBuffer[X]);
-        Blt->Blue   = PIXEL_TO_BLUE_BYTE (Private->LineBuffer[X]);
+        BltRow[X] = mPixelToBltPixel[Private->LineBuffer[X]];
       }
     }
     break;
@@ -338,42 +437,17 @@ Returns:
     SourceOffset  = (SourceY * Private->ModeData[CurrentMode].HorizontalResolution) + (SourceX);
     Offset        = (DestinationY * Private->ModeData[CurrentMode].HorizontalResolution) + (DestinationX);
 
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0000);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0010);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0012);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0014);
-
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0001);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0011);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0013);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0015);
-
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((Width << 8) & 0xff00) | 0x20));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((Width & 0xff00) | 0x21));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((Height << 8) & 0xff00) | 0x22));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((Height & 0xff00) | 0x23));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((ScreenWidth << 8) & 0xff00) | 0x24));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((ScreenWidth & 0xff00) | 0x25));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) (((ScreenWidth << 8) & 0xff00) | 0x26));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((ScreenWidth & 0xff00) | 0x27));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((((Offset) << 8) & 0xff00) | 0x28));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((((Offset) >> 0) & 0xff00) | 0x29));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((((Offset) >> 8) & 0xff00) | 0x2a));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((((SourceOffset) << 8) & 0xff00) | 0x2c));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((((SourceOffset) >> 0) & 0xff00) | 0x2d));
-    outw (Private, GRAPH_ADDRESS_REGISTER, (UINT16) ((((SourceOffset) >> 8) & 0xff00) | 0x2e));
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x002f);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0030);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0d32);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0033);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0034);
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0035);
-
-    outw (Private, GRAPH_ADDRESS_REGISTER, 0x0231);
-
-    outb (Private, GRAPH_ADDRESS_REGISTER, 0x31);
-    while ((inb (Private, GRAPH_DATA_REGISTER) & 0x01) == 0x01)
-      ;
+    CirrusLogic5430BitBlt (
+      Private,
+      Offset,
+      SourceOffset,
+      Width,
+      Height,
+      ScreenWidth,
+      0,
+      0,
+      0
+      );
     break;
 
   case EfiBltVideoFill:
@@ -382,7 +456,23 @@ Returns:
     WidePixel = (Pixel << 8) | Pixel;
     WidePixel = (WidePixel << 16) | WidePixel;
 
-    if (DestinationX == 0 && Width == Private->ModeData[CurrentMode].HorizontalResolution) {
+    if (Private->BltSolidFill) {
+      //
+      // Color expansion of a solid pattern, no frame buffer access at all
+      //
+      ScreenWidth = Private->ModeData[CurrentMode].HorizontalResolution;
+      CirrusLogic5430BitBlt (
+        Private,
+        (DestinationY * ScreenWidth) + DestinationX,
+        0,
+        Width,
+        Height,
+        ScreenWidth,
+        BLT_MODE_COLOR_EXPAND | BLT_MODE_PATTERN_COPY,
+        BLT_MODE_EXT_SOLID_FILL,
+        Pixel
+        );
+    } else if (DestinationX == 0 && Width == Private->ModeData[CurrentMode].HorizontalResolution) {
       Offset = DestinationY * Private->ModeData[CurrentMode].HorizontalResolution;
       if (((Offset & 0x03) == 0) && (((Width * Height) & 0x03) == 0)) {
         Private->PciIo->Mem.Write (
@@ -432,15 +522,11 @@ Returns:
   case EfiBltBufferToVideo:
     for (SrcY = SourceY, DstY = DestinationY; SrcY < (Height + SourceY); SrcY++, DstY++) {
 
+      BltRow = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) ((UINT8 *) BltBuffer + (SrcY * Delta)) + SourceX;
       for (X = 0; X < Width; X++) {
-        Blt =
-          (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) (
-              (UINT8 *) BltBuffer +
-              (SrcY * Delta) +
-              ((SourceX + X) * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL))
-            );
-        Private->LineBuffer[X]  =
-          RGB_BYTES_TO_PIXEL (Blt->Red, Blt->Green, Blt->Blue);
+        Private->LineBuffer[X] = (UINT8) (mRedToPixel[BltRow[X].Red] |
+                                          mGreenToPixel[BltRow[X].Green] |
+                                          mBlueToPixel[BltRow[X].Blue]);
       }
 
       Offset = (DstY * Private->ModeData[CurrentMode].HorizontalResolution) + DestinationX;
@@ -513,6 +599,8 @@ CirrusLogic5430GraphicsOutputConstructor (
   Private->HardwareNeedsStarting        = TRUE;
   Private->LineBuffer                   = NULL;
 
+  CirrusLogic5430InitializeColorTables ();
+
   //
   // Initialize the hardware
   //
@@ -478,11 +478,18 @@ IssueCB (
     OutByte (AdapterInfo, CU_START, AdapterInfo->ioaddr + SCBCmd);
   } else {
     //
-    // either active or suspended, give a resume
+    // either active or suspended, unlink the suspend bit in the previous
+    // command block. An active CU walks onto the new block by itself, so
+    // frames queued while it is busy share a single resume. A CU that
+    // latched the old suspend bit before we cleared it is kicked again
+    // from CheckCBList.
     //
 
     cmd_ptr->PrevTCBVirtualLinkPtr->cb_header.command &= ~(CmdSuspend | CmdIntr);
-    OutByte (AdapterInfo, CU_RESUME, AdapterInfo->ioaddr + SCBCmd);
+    status = InWord (AdapterInfo, AdapterInfo->ioaddr + SCBStatus);
+    if ((status & SCB_STATUS_CU_MASK) != SCB_STATUS_CU_ACTIVE) {
+      OutByte (AdapterInfo, CU_RESUME, AdapterInfo->ioaddr + SCBCmd);
+    }
   }
 
   return 0;
@@ -768,10 +775,12 @@ E100bInit (
   AdapterInfo->rx_ring        = (RxFD *) (UINTN) (AdapterInfo->MemoryPtr);
   AdapterInfo->tx_ring        = (TxCB *) (UINTN) (AdapterInfo->MemoryPtr + rx_size);
   AdapterInfo->statistics     = (struct speedo_stats *) (UINTN) (AdapterInfo->MemoryPtr + rx_size + tx_size);
+  AdapterInfo->tx_buffer      = (UINT8 *) (UINTN) (AdapterInfo->MemoryPtr + rx_size + tx_size + sizeof (struct speedo_stats));
 
   AdapterInfo->rx_phy_addr    = AdapterInfo->Mapped_MemoryPtr;
   AdapterInfo->tx_phy_addr    = AdapterInfo->Mapped_MemoryPtr + rx_size;
   AdapterInfo->stat_phy_addr  = AdapterInfo->tx_phy_addr + tx_size;
+  AdapterInfo->tx_buf_phy_addr = AdapterInfo->stat_phy_addr + sizeof (struct speedo_stats);
 
   //
   // auto detect.
@@ -1011,14 +1020,14 @@ E100bTransmit (
   PXE_CPB_TRANSMIT_FRAGMENTS  *tx_ptr_f;
   PXE_CPB_TRANSMIT            *tx_ptr_1;
   TxCB                        *tcb_ptr;
-  UINT64                      Tmp_ptr;
-  UINTN                       stat;
+  UINT8                       *copy_ptr;
+  UINT32                      frame_len;
   INT32                       Index;
   UINT16                      wait_sec;
+  UINT16                      status;
 
   tx_ptr_1  = (PXE_CPB_TRANSMIT *) (UINTN) cpb;
   tx_ptr_f  = (PXE_CPB_TRANSMIT_FRAGMENTS *) (UINTN) cpb;
-  Tmp_ptr = 0;
 
   //
   // stop reentrancy here
@@ -1028,6 +1037,27 @@ E100bTransmit (
 
   }
 
+  //
+  // The frame is gathered into the premapped buffer of the TCB, so it
+  // must fit in there. Anything larger is not a valid ethernet frame.
+  //
+  if ((opflags & PXE_OPFLAGS_TRANSMIT_FRAGMENTED) != 0) {
+    if (tx_ptr_f->FragCnt > MAX_XMIT_FRAGMENTS) {
+      return PXE_STATCODE_INVALID_PARAMETER;
+    }
+
+    frame_len = 0;
+    for (Index = 0; Index < tx_ptr_f->FragCnt; Index++) {
+      frame_len += tx_ptr_f->FragDesc[Index].FragLen;
+    }
+  } else {
+    frame_len = tx_ptr_1->DataLen + tx_ptr_1->MediaheaderLen;
+  }
+
+  if (frame_len > TX_COPY_BUFFER_SIZE) {
+    return PXE_STATCODE_INVALID_PARAMETER;
+  }
+
   AdapterInfo->in_transmit = TRUE;
 
   //
@@ -1056,59 +1086,32 @@ E100bTransmit (
   // 82557 multiplies the threashold value by 8, so give 256/8
   //
   tcb_ptr->Threshold = 32;
-  if ((opflags & PXE_OPFLAGS_TRANSMIT_FRAGMENTED) != 0) {
-
-    if (tx_ptr_f->FragCnt > MAX_XMIT_FRAGMENTS) {
-      SetFreeCB (AdapterInfo, tcb_ptr);
-      AdapterInfo->in_transmit = FALSE;
-      return PXE_STATCODE_INVALID_PARAMETER;
-    }
-
-    tcb_ptr->TBDCount = (UINT8) tx_ptr_f->FragCnt;
 
+  //
+  // copy the frame into the TCB's buffer instead of mapping the caller's
+  // fragments, the buffer stays mapped for the lifetime of the UNDI
+  //
+  copy_ptr = tcb_ptr->CopyBufPtr;
+  if ((opflags & PXE_OPFLAGS_TRANSMIT_FRAGMENTED) != 0) {
     for (Index = 0; Index < tx_ptr_f->FragCnt; Index++) {
-      stat = MapIt (
-              AdapterInfo,
-              tx_ptr_f->FragDesc[Index].FragAddr,
-              tx_ptr_f->FragDesc[Index].FragLen,
-              TO_DEVICE,
-              (UINT64)(UINTN) &Tmp_ptr
-              );
-      if (stat != 0) {
-        SetFreeCB (AdapterInfo, tcb_ptr);
-        AdapterInfo->in_transmit = FALSE;
-        return PXE_STATCODE_INVALID_PARAMETER;
-      }
-
-      tcb_ptr->TBDArray[Index].phys_buf_addr  = (UINT32) Tmp_ptr;
-      tcb_ptr->TBDArray[Index].buf_len        = tx_ptr_f->FragDesc[Index].FragLen;
+      CopyMem (
+        copy_ptr,
+        (VOID *) (UINTN) tx_ptr_f->FragDesc[Index].FragAddr,
+        tx_ptr_f->FragDesc[Index].FragLen
+        );
+      copy_ptr += tx_ptr_f->FragDesc[Index].FragLen;
     }
 
     tcb_ptr->free_data_ptr = tx_ptr_f->FragDesc[0].FragAddr;
-
   } else {
-    //
-    // non fragmented case
-    //
-    tcb_ptr->TBDCount = 1;
-    stat = MapIt (
-            AdapterInfo,
-            tx_ptr_1->FrameAddr,
-            tx_ptr_1->DataLen + tx_ptr_1->MediaheaderLen,
-            TO_DEVICE,
-            (UINT64)(UINTN) &Tmp_ptr
-            );
-    if (stat != 0) {
-      SetFreeCB (AdapterInfo, tcb_ptr);
-      AdapterInfo->in_transmit = FALSE;
-      return PXE_STATCODE_INVALID_PARAMETER;
-    }
-
-    tcb_ptr->TBDArray[0].phys_buf_addr  = (UINT32) (Tmp_ptr);
-    tcb_ptr->TBDArray[0].buf_len        = tx_ptr_1->DataLen + tx_ptr_1->MediaheaderLen;
-    tcb_ptr->free_data_ptr              = tx_ptr_1->FrameAddr;
+    CopyMem (copy_ptr, (VOID *) (UINTN) tx_ptr_1->FrameAddr, frame_len);
+    tcb_ptr->free_data_ptr = tx_ptr_1->FrameAddr;
   }
 
+  tcb_ptr->TBDCount                   = 1;
+  tcb_ptr->TBDArray[0].phys_buf_addr  = tcb_ptr->PhysCopyBufAddr;
+  tcb_ptr->TBDArray[0].buf_len        = frame_len;
+
   //
   // must wait for previous command completion only if it was a non-transmit
   //
@@ -1120,50 +1123,46 @@ E100bTransmit (
   // see if we need to wait for completion here
   //
   if ((opflags & PXE_OPFLAGS_TRANSMIT_BLOCK) != 0) {
+    //
+    // the caller gets its buffer back right away, so keep it out of the
+    // completion queue that GetStatus reports from
+    //
+    tcb_ptr->free_data_ptr = (UINT64) 0;
+
     //
     // don't wait for more than 1 second!!!
     //
     wait_sec = 1000;
     while (tcb_ptr->cb_header.status == 0) {
+      //
+      // A CU that latched the suspend bit of the previous block before
+      // IssueCB cleared it never reaches this frame on its own. The CU
+      // writes a block's status before it suspends on it, so a suspended
+      // CU with this block still pending stopped in front of it.
+      //
+      status = InWord (AdapterInfo, AdapterInfo->ioaddr + SCBStatus);
+      if (((status & SCB_STATUS_CU_MASK) == SCB_STATUS_CU_SUSPEND) &&
+          (tcb_ptr->cb_header.status == 0)) {
+        wait_for_cmd_done (AdapterInfo->ioaddr + SCBCmd);
+        OutByte (AdapterInfo, CU_RESUME, AdapterInfo->ioaddr + SCBCmd);
+      }
+
       DelayIt (AdapterInfo, 10);
       wait_sec--;
       if (wait_sec == 0) {
         break;
       }
     }
-    //
-    // we need to un-map any mapped buffers here
-    //
-    if ((opflags & PXE_OPFLAGS_TRANSMIT_FRAGMENTED) != 0) {
-
-      for (Index = 0; Index < tx_ptr_f->FragCnt; Index++) {
-        Tmp_ptr = tcb_ptr->TBDArray[Index].phys_buf_addr;
-        UnMapIt (
-          AdapterInfo,
-          tx_ptr_f->FragDesc[Index].FragAddr,
-          tx_ptr_f->FragDesc[Index].FragLen,
-          TO_DEVICE,
-          (UINT64) Tmp_ptr
-          );
-      }
-    } else {
-      Tmp_ptr = tcb_ptr->TBDArray[0].phys_buf_addr;
-      UnMapIt (
-        AdapterInfo,
-        tx_ptr_1->FrameAddr,
-        tx_ptr_1->DataLen + tx_ptr_1->MediaheaderLen,
-        TO_DEVICE,
-        (UINT64) Tmp_ptr
-        );
-    }
 
     if (tcb_ptr->cb_header.status == 0) {
-      SetFreeCB (AdapterInfo, tcb_ptr);
       AdapterInfo->in_transmit = FALSE;
       return PXE_STATCODE_DEVICE_FAILURE;
     }
 
-    SetFreeCB (AdapterInfo, tcb_ptr);
+    //
+    // reclaim in ring order, earlier frames may still be outstanding
+    //
+    CheckCBList (AdapterInfo);
   }
   //
   // CB will be set free later in get_status (or when we run out of xmit buffers
@@ -1337,6 +1336,11 @@ FreeRFD:
 
   if (pkt_type == PXE_FRAME_TYPE_NONE) {
     AdapterInfo->Int_Status &= (~SCB_STATUS_FR);
+
+    //
+    // ring is drained, hand back whatever is left of the current batch
+    //
+    Flush_RFD (AdapterInfo);
   }
 
   status = InWord (AdapterInfo, AdapterInfo->ioaddr + SCBStatus);
@@ -1455,7 +1459,11 @@ SetupCBlink (
     cur_ptr[Index].PhysArrayAddr      = (UINT32)(cur_ptr[Index].PhysTCBAddress + array_off);
     cur_ptr[Index].PhysTBDArrayAddres = (UINT32)(cur_ptr[Index].PhysTCBAddress + array_off);
 
-    cur_ptr->free_data_ptr = (UINT64) 0;
+    cur_ptr[Index].CopyBufPtr         = AdapterInfo->tx_buffer + (Index * TX_COPY_BUFFER_SIZE);
+    cur_ptr[Index].PhysCopyBufAddr    =
+    (UINT32) AdapterInfo->tx_buf_phy_addr + (Index * TX_COPY_BUFFER_SIZE);
+
+    cur_ptr[Index].free_data_ptr = (UINT64) 0;
 
     if (Index < AdapterInfo->TxBufCnt - 1) {
       cur_ptr[Index].cb_header.link             = cur_ptr[Index].PhysTCBAddress + sizeof (TxCB);
@@ -1592,31 +1600,40 @@ CheckCBList (
 {
   TxCB    *Tmp_ptr;
   UINT16  cnt;
+  UINT16  status;
 
   cnt = 0;
-  while (1) {
+  while (AdapterInfo->FreeCBCount < AdapterInfo->TxBufCnt) {
     Tmp_ptr = AdapterInfo->FreeTxTailPtr->NextTCBVirtualLinkPtr;
     if ((Tmp_ptr->cb_header.status & CMD_STATUS_MASK) != 0) {
       //
-      // check if Q is full
+      // check if Q is full, frames sent with the block flag and
+      // non-transmit commands have nothing to hand back
       //
-      if (next (AdapterInfo->xmit_done_tail) != AdapterInfo->xmit_done_head) {
+      if ((Tmp_ptr->free_data_ptr != 0) &&
+          (next (AdapterInfo->xmit_done_tail) != AdapterInfo->xmit_done_head)) {
         ASSERT (AdapterInfo->xmit_done_tail < TX_BUFFER_COUNT << 1);
         AdapterInfo->xmit_done[AdapterInfo->xmit_done_tail] = Tmp_ptr->free_data_ptr;
-
-        UnMapIt (
-          AdapterInfo,
-          Tmp_ptr->free_data_ptr,
-          Tmp_ptr->TBDArray[0].buf_len,
-          TO_DEVICE,
-          (UINT64) Tmp_ptr->TBDArray[0].phys_buf_addr
-          );
-
         AdapterInfo->xmit_done_tail = next (AdapterInfo->xmit_done_tail);
       }
 
       SetFreeCB (AdapterInfo, Tmp_ptr);
+      cnt++;
     } else {
+      //
+      // Tmp_ptr has been issued but is not done yet. If the CU sits
+      // suspended on the block before it, it missed the cleared suspend
+      // bit in IssueCB and needs a resume to pick up the queued frames.
+      // Tmp_ptr is checked again once the CU is seen suspended, in case it
+      // completed in between and the CU suspended on it legitimately.
+      //
+      status = InWord (AdapterInfo, AdapterInfo->ioaddr + SCBStatus);
+      if (((status & SCB_STATUS_CU_MASK) == SCB_STATUS_CU_SUSPEND) &&
+          ((Tmp_ptr->cb_header.status & CMD_STATUS_MASK) == 0)) {
+        wait_for_cmd_done (AdapterInfo->ioaddr + SCBCmd);
+        OutByte (AdapterInfo, CU_RESUME, AdapterInfo->ioaddr + SCBCmd);
+      }
+
       break;
     }
   }
@@ -1650,8 +1667,9 @@ SetupReceiveQueues (
   RxFD    *tail_ptr;
   UINT16  Index;
 
-  AdapterInfo->cur_rx_ind = 0;
-  rx_ptr                  = (&AdapterInfo->rx_ring[0]);
+  AdapterInfo->cur_rx_ind       = 0;
+  AdapterInfo->RxRecyclePending = 0;
+  rx_ptr                        = (&AdapterInfo->rx_ring[0]);
 
   for (Index = 0; Index < AdapterInfo->RxBufCnt; Index++) {
     rx_ptr[Index].cb_header.status  = 0;
@@ -1689,12 +1707,18 @@ SetupReceiveQueues (
 
 
 /**
-  TODO: Add function description
+  Returns a consumed RFD to the receive ring.
 
-  @param  AdapterInfo                     TODO: add argument description
-  @param  rx_index                        TODO: add argument description
+  The RFD is cleaned right away, but the EL bit is only moved forward once
+  RX_RECYCLE_BATCH RFDs have been consumed, so the RU sees one tail update
+  per batch instead of one per frame. Flush_RFD hands back a partial batch.
 
-  @return TODO: add return values
+  @param  AdapterInfo                     Pointer to the NIC data structure
+                                          information which the UNDI driver is
+                                          layering on.
+  @param  rx_index                        Index of the consumed RFD, which must
+                                          be the one following the last RFD
+                                          passed in.
 
 **/
 VOID
@@ -1704,29 +1728,61 @@ Recycle_RFD (
   )
 {
   RxFD  *rx_ptr;
-  RxFD  *tail_ptr;
+
+  rx_ptr                      = &AdapterInfo->rx_ring[rx_index];
+  rx_ptr->cb_header.command   = 0;
+  rx_ptr->cb_header.status    = 0;
+  rx_ptr->ActualCount         = 0;
+  rx_ptr->forwarded           = FALSE;
+
+  AdapterInfo->RxRecyclePending++;
+  if (AdapterInfo->RxRecyclePending >= RX_RECYCLE_BATCH) {
+    Flush_RFD (AdapterInfo);
+  }
+}
+
+
+/**
+  Hands all RFDs consumed since the last flush back to the RU.
+
+  @param  AdapterInfo                     Pointer to the NIC data structure
+                                          information which the UNDI driver is
+                                          layering on.
+
+**/
+VOID
+Flush_RFD (
+  IN NIC_DATA_INSTANCE *AdapterInfo
+  )
+{
+  RxFD    *rx_ptr;
+  RxFD    *tail_ptr;
+  UINT16  rx_index;
+
+  if (AdapterInfo->RxRecyclePending == 0) {
+    return ;
+  }
+
   //
-  // change the EL bit and change the AdapterInfo->RxTailPtr
-  // rx_ptr is assumed to be the head of the Q
-  // AdapterInfo->rx_forwarded[rx_index] = FALSE;
+  // the last consumed RFD becomes the new tail, RFDs between the old tail
+  // and it were cleaned by Recycle_RFD already
   //
-  rx_ptr                    = &AdapterInfo->rx_ring[rx_index];
-  tail_ptr                  = AdapterInfo->RFDTailPtr;
+  rx_index = (UINT16) (AdapterInfo->RFDTailPtr - AdapterInfo->rx_ring);
+  rx_index = (UINT16) ((rx_index + AdapterInfo->RxRecyclePending) % AdapterInfo->RxBufCnt);
+  rx_ptr   = &AdapterInfo->rx_ring[rx_index];
+  tail_ptr = AdapterInfo->RFDTailPtr;
+
   //
-  // set el_bit and suspend bit
+  // set el_bit and suspend bit on the new tail before releasing the old
+  // one, so the RU never runs past the end of the cleaned RFDs
   //
-  rx_ptr->cb_header.command = 0xc000;
-  rx_ptr->cb_header.status    = 0;
-  rx_ptr->ActualCount         = 0;
-  rx_ptr->forwarded           = FALSE;
-  AdapterInfo->RFDTailPtr     = rx_ptr;
+  rx_ptr->cb_header.command     = 0xc000;
+  AdapterInfo->RFDTailPtr       = rx_ptr;
+  AdapterInfo->RxRecyclePending = 0;
   //
   // resetting the el_bit.
   //
   tail_ptr->cb_header.command = 0;
-  //
-  // check the receive unit, fix if there is any problem
-  //
   return ;
 }
 //
@@ -56,6 +56,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MAX_ETHERNET_PKT_SIZE 1514  // including eth header
 #define RX_BUFFER_SIZE 1536  // including crc and padding
 #define TX_BUFFER_SIZE 64
+#define TX_COPY_BUFFER_SIZE 1536  // premapped per-TCB frame buffer
+#define RX_RECYCLE_BATCH 8  // RFDs handed back to the RU per EL move
 #define ETH_MTU 1500  // does not include ethernet header length
 
 #define SPEEDO3_TOTAL_SIZE 0x20
@@ -407,6 +409,9 @@ typedef struct s_TxCB {
   struct s_TxCB *NextTCBVirtualLinkPtr;
   struct s_TxCB *PrevTCBVirtualLinkPtr;
   UINT64 free_data_ptr;  // to be given to the upper layer when this xmit completes1
+  UINT8 *CopyBufPtr;      // premapped frame buffer owned by this TCB
+  UINT32 PhysCopyBufAddr; // its address as seen by the 82557
+  UINT32 junk;
 }TxCB;
 
 /* The Speedo3 Rx and Tx buffer descriptors. */
@@ -453,6 +458,7 @@ struct Krn_Mem{
   RxFD rx_ring[RX_BUFFER_COUNT];
   TxCB tx_ring[TX_BUFFER_COUNT];
   struct speedo_stats statistics;
+  UINT8 tx_buffer[TX_BUFFER_COUNT][TX_COPY_BUFFER_SIZE];
 };
 #define MEMORY_NEEDED  sizeof(struct Krn_Mem)
 
@@ -598,6 +604,7 @@ typedef struct s_data_instance {
   RxFD *rx_ring;  // array of rx buffers
   TxCB *tx_ring;  // array of tx buffers
   struct speedo_stats *statistics;
+  UINT8 *tx_buffer;  // premapped transmit frame buffers, one per TCB
   TxCB *FreeTxHeadPtr;
   TxCB *FreeTxTailPtr;
   RxFD *RFDTailPtr;
@@ -605,6 +612,7 @@ typedef struct s_data_instance {
   UINT64 rx_phy_addr;  // physical addresses
   UINT64 tx_phy_addr;
   UINT64 stat_phy_addr;
+  UINT64 tx_buf_phy_addr;
   UINT64 MemoryPtr;
   UINT64 Mapped_MemoryPtr;
 
@@ -612,6 +620,7 @@ typedef struct s_data_instance {
   UINT16 xmit_done_head;  // index into the xmit_done array
   UINT16 xmit_done_tail;  // where are we filling now (index into xmit_done)
   UINT16 cur_rx_ind;  // current RX Q head index
+  UINT16 RxRecyclePending;  // consumed RFDs not yet returned to the RU
   UINT16 FreeCBCount;
 
   BOOLEAN in_interrupt;
@@ -127,6 +127,7 @@ UINT8 SelectiveReset (NIC_DATA_INSTANCE *AdapterInfo);
 UINT16 InitializeChip (NIC_DATA_INSTANCE *AdapterInfo);
 UINT8 SetupReceiveQueues (NIC_DATA_INSTANCE *AdapterInfo);
 VOID  Recycle_RFD (NIC_DATA_INSTANCE *AdapterInfo, UINT16);
+VOID  Flush_RFD (NIC_DATA_INSTANCE *AdapterInfo);
 VOID XmitWaitForCompletion (NIC_DATA_INSTANCE *AdapterInfo);
 INT8 CommandWaitForCompletion (TxCB *cmd_ptr, NIC_DATA_INSTANCE *AdapterInfo);
 
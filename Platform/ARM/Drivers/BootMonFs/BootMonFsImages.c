@@ -129,57 +129,56 @@ BootMonFsIsImageValid (
   return TRUE;
 }
 
+//
+// Amount of media read at once while looking for image descriptions. Going
+// through BlockIo in large aligned chunks avoids one DiskIo call, and with it
+// one bounce-buffered block read, for every block of the device.
+//
+#define BOOTMON_FS_SCAN_CHUNK_SIZE    SIZE_2MB
+
 STATIC
 EFI_STATUS
-BootMonFsDiscoverNextImage (
-  IN     BOOTMON_FS_INSTANCE      *Instance,
-  IN OUT EFI_LBA                  *LbaStart,
-  IN OUT BOOTMON_FS_FILE          *File
+BootMonFsAddImage (
+  IN BOOTMON_FS_INSTANCE        *Instance,
+  IN HW_IMAGE_DESCRIPTION       *Desc,
+  IN EFI_LBA                    Lba
   )
 {
-  EFI_DISK_IO_PROTOCOL  *DiskIo;
-  EFI_LBA                CurrentLba;
-  UINT64                 DescOffset;
-  EFI_STATUS             Status;
-
-  DiskIo = Instance->DiskIo;
-
-  CurrentLba = *LbaStart;
-
-  // Look for images in the rest of this block
-  while (CurrentLba <= Instance->Media->LastBlock) {
-    // Work out the byte offset into media of the image description in this block
-    // If present, the image description is at the very end of the block.
-    DescOffset = ((CurrentLba + 1) * Instance->Media->BlockSize) - sizeof (HW_IMAGE_DESCRIPTION);
-
-    // Read the image description from media
-    Status = DiskIo->ReadDisk (DiskIo,
-                       Instance->Media->MediaId,
-                       DescOffset,
-                       sizeof (HW_IMAGE_DESCRIPTION),
-                       &File->HwDescription
-                       );
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
+  EFI_STATUS            Status;
+  BOOTMON_FS_FILE      *NewFile;
 
-    // If we found a valid image description...
-    if (BootMonFsIsImageValid (&File->HwDescription, (CurrentLba - Instance->Media->LowestAlignedLba))) {
-      DEBUG ((EFI_D_ERROR, "Found image: %a in block %d.\n",
-        &(File->HwDescription.Footer.Filename),
-        (UINTN)(CurrentLba - Instance->Media->LowestAlignedLba)
-        ));
-      File->HwDescAddress = DescOffset;
-
-      *LbaStart = CurrentLba + 1;
-      return EFI_SUCCESS;
-    } else {
-      CurrentLba++;
-    }
+  // Most blocks hold file data or nothing at all, reject them before
+  // allocating anything
+  if ((Desc->Footer.FooterSignature1 != HW_IMAGE_FOOTER_SIGNATURE_1) ||
+      (Desc->Footer.FooterSignature2 != HW_IMAGE_FOOTER_SIGNATURE_2)) {
+    return EFI_NOT_FOUND;
   }
 
-  *LbaStart = CurrentLba;
-  return EFI_NOT_FOUND;
+  NewFile = NULL;
+  Status = BootMonFsCreateFile (Instance, &NewFile);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  CopyMem (&NewFile->HwDescription, Desc, sizeof (HW_IMAGE_DESCRIPTION));
+
+  if (!BootMonFsIsImageValid (&NewFile->HwDescription, (Lba - Instance->Media->LowestAlignedLba))) {
+    // Free NewFile allocated by BootMonFsCreateFile ()
+    FreePool (NewFile);
+    return EFI_NOT_FOUND;
+  }
+
+  DEBUG ((EFI_D_ERROR, "Found image: %a in block %d.\n",
+    &(NewFile->HwDescription.Footer.Filename),
+    (UINTN)(Lba - Instance->Media->LowestAlignedLba)
+    ));
+
+  // If present, the image description is at the very end of the block
+  NewFile->HwDescAddress = ((Lba + 1) * Instance->Media->BlockSize) - sizeof (HW_IMAGE_DESCRIPTION);
+
+  // The scan goes up the media, so the file list stays in disk-order
+  InsertTailList (&Instance->RootFile->Link, &NewFile->Link);
+  return EFI_SUCCESS;
 }
 
 EFI_STATUS
@@ -188,29 +187,70 @@ BootMonFsInitialize (
   )
 {
   EFI_STATUS               Status;
+  EFI_BLOCK_IO_MEDIA      *Media;
   EFI_LBA                  Lba;
+  UINTN                    BlockSize;
+  UINTN                    ChunkBlocks;
+  UINTN                    BlockCount;
+  UINTN                    Index;
+  UINT8                   *Buffer;
   UINT32                   ImageCount;
-  BOOTMON_FS_FILE          *NewFile;
 
+  Media = Instance->Media;
+  BlockSize = Media->BlockSize;
   ImageCount = 0;
-  Lba = 0;
 
-  while (1) {
-    Status = BootMonFsCreateFile (Instance, &NewFile);
-    if (EFI_ERROR (Status)) {
-      return Status;
+  ChunkBlocks = BOOTMON_FS_SCAN_CHUNK_SIZE / BlockSize;
+  if (ChunkBlocks == 0) {
+    ChunkBlocks = 1;
+  }
+  if (ChunkBlocks > Media->LastBlock + 1) {
+    ChunkBlocks = (UINTN)(Media->LastBlock + 1);
+  }
+
+  // Page aligned, which satisfies any IoAlign the BlockIo may ask for
+  Buffer = AllocatePages (EFI_SIZE_TO_PAGES (ChunkBlocks * BlockSize));
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Lba = 0; Lba <= Media->LastBlock; Lba += BlockCount) {
+    BlockCount = ChunkBlocks;
+    if (BlockCount > Media->LastBlock + 1 - Lba) {
+      BlockCount = (UINTN)(Media->LastBlock + 1 - Lba);
     }
 
-    Status = BootMonFsDiscoverNextImage (Instance, &Lba, NewFile);
+    Status = Instance->BlockIo->ReadBlocks (
+                                  Instance->BlockIo,
+                                  Media->MediaId,
+                                  Lba,
+                                  BlockCount * BlockSize,
+                                  Buffer
+                                  );
     if (EFI_ERROR (Status)) {
-      // Free NewFile allocated by BootMonFsCreateFile ()
-      FreePool (NewFile);
       break;
     }
-    InsertTailList (&Instance->RootFile->Link, &NewFile->Link);
-    ImageCount++;
+
+    for (Index = 0; Index < BlockCount; Index++) {
+      Status = BootMonFsAddImage (
+                 Instance,
+                 (HW_IMAGE_DESCRIPTION *)(Buffer + ((Index + 1) * BlockSize) - sizeof (HW_IMAGE_DESCRIPTION)),
+                 Lba + Index
+                 );
+      if (Status == EFI_OUT_OF_RESOURCES) {
+        FreePages (Buffer, EFI_SIZE_TO_PAGES (ChunkBlocks * BlockSize));
+        return Status;
+      }
+      if (!EFI_ERROR (Status)) {
+        ImageCount++;
+      }
+    }
   }
 
+  FreePages (Buffer, EFI_SIZE_TO_PAGES (ChunkBlocks * BlockSize));
+
+  DEBUG ((DEBUG_INFO, "BootMonFs: %d image(s) found on %ld blocks.\n", ImageCount, Media->LastBlock + 1));
+
   Instance->Initialized = TRUE;
   return EFI_SUCCESS;
 }
@@ -539,6 +539,45 @@ HandleCmObjectSearchPlatformRepo (
   return Status;
 }
 
+/** Resolve a token to the index of the repository array entry it refers to.
+
+  The tokens handed out by this Configuration Manager are the addresses of
+  the repository entries, so the index is recovered from the token offset
+  rather than by comparing the token against every entry.
+
+  @param [in]  Token       Token to resolve.
+  @param [in]  Array       Base address of the repository array.
+  @param [in]  EntrySize   Size of one array entry.
+  @param [in]  EntryCount  Number of valid entries in the array.
+  @param [out] Index       Index of the entry referenced by the token.
+
+  @retval TRUE   The token references an entry of the array.
+  @retval FALSE  The token does not reference an entry of the array.
+**/
+BOOLEAN
+GetTokenIndex (
+  IN  CM_OBJECT_TOKEN   Token,
+  IN  CONST VOID        *Array,
+  IN  UINTN             EntrySize,
+  IN  UINTN             EntryCount,
+  OUT UINTN             *Index
+  )
+{
+  UINTN   Offset;
+
+  if (Token < (CM_OBJECT_TOKEN)Array) {
+    return FALSE;
+  }
+
+  Offset = (UINTN)(Token - (CM_OBJECT_TOKEN)Array);
+  if (((Offset % EntrySize) != 0) || ((Offset / EntrySize) >= EntryCount)) {
+    return FALSE;
+  }
+
+  *Index = Offset / EntrySize;
+  return TRUE;
+}
+
 /** Initialize the Platform Configuration Repository.
 
   @param [in]  PlatformRepo  Pointer to the Platform Configuration Repository.
@@ -621,7 +660,7 @@ GetGicCInfo (
   )
 {
   EDKII_COMMON_PLATFORM_REPOSITORY_INFO  * PlatformRepo;
-  UINT32                                   ObjIndex;
+  UINTN                                    ObjIndex;
 
   if ((This == NULL) || (CmObject == NULL)) {
     ASSERT (This != NULL);
@@ -631,17 +670,21 @@ GetGicCInfo (
 
   PlatformRepo = This->PlatRepoInfo->CommonPlatRepoInfo;
 
-  for (ObjIndex = 0; ObjIndex < PLAT_CPU_COUNT; ObjIndex++) {
-    if (SearchToken == (CM_OBJECT_TOKEN)&PlatformRepo->GicCInfo[ObjIndex]) {
-      CmObject->ObjectId = CmObjectId;
-      CmObject->Size = sizeof (PlatformRepo->GicCInfo[ObjIndex]);
-      CmObject->Data = (VOID*)&PlatformRepo->GicCInfo[ObjIndex];
-      CmObject->Count = 1;
-      return EFI_SUCCESS;
-    }
+  if (!GetTokenIndex (
+         SearchToken,
+         PlatformRepo->GicCInfo,
+         sizeof (PlatformRepo->GicCInfo[0]),
+         ARRAY_SIZE (PlatformRepo->GicCInfo),
+         &ObjIndex
+         )) {
+    return EFI_NOT_FOUND;
   }
 
-  return EFI_NOT_FOUND;
+  CmObject->ObjectId = CmObjectId;
+  CmObject->Size = sizeof (PlatformRepo->GicCInfo[ObjIndex]);
+  CmObject->Data = (VOID*)&PlatformRepo->GicCInfo[ObjIndex];
+  CmObject->Count = 1;
+  return EFI_SUCCESS;
 }
 
 /** Return a list of Configuration Manager object references pointed to by the
@@ -168,6 +168,26 @@ HandleCmObjectRefByToken (
   IN  OUT   CM_OBJ_DESCRIPTOR                     * CONST CmObjectDesc
   );
 
+/** Resolve a token to the index of the repository array entry it refers to.
+
+  @param [in]  Token       Token to resolve.
+  @param [in]  Array       Base address of the repository array.
+  @param [in]  EntrySize   Size of one array entry.
+  @param [in]  EntryCount  Number of valid entries in the array.
+  @param [out] Index       Index of the entry referenced by the token.
+
+  @retval TRUE   The token references an entry of the array.
+  @retval FALSE  The token does not reference an entry of the array.
+**/
+BOOLEAN
+GetTokenIndex (
+  IN  CM_OBJECT_TOKEN   Token,
+  IN  CONST VOID        *Array,
+  IN  UINTN             EntrySize,
+  IN  UINTN             EntryCount,
+  OUT UINTN             *Index
+  );
+
 /** The number of CPUs
 */
 #define PLAT_CPU_COUNT              4
@@ -353,7 +353,6 @@ GetItsIdentifierArray (
   )
 {
   EDKII_FVP_PLATFORM_REPOSITORY_INFO     * PlatformRepo;
-  UINTN                                    Count;
   UINTN                                    Index;
 
   if ((This == NULL) || (CmObject == NULL)) {
@@ -364,19 +363,21 @@ GetItsIdentifierArray (
 
   PlatformRepo = This->PlatRepoInfo->FvpPlatRepoInfo;
 
-  Count = ARRAY_SIZE (PlatformRepo->ItsIdentifierArray);
-
-  for (Index = 0; Index < Count; Index++) {
-    if (Token == (CM_OBJECT_TOKEN)&PlatformRepo->ItsIdentifierArray[Index]) {
-      CmObject->ObjectId = CmObjectId;
-      CmObject->Size = sizeof (PlatformRepo->ItsIdentifierArray[0]);
-      CmObject->Data = (VOID*)&PlatformRepo->ItsIdentifierArray[Index];
-      CmObject->Count = 1;
-      return EFI_SUCCESS;
-    }
+  if (!GetTokenIndex (
+         Token,
+         PlatformRepo->ItsIdentifierArray,
+         sizeof (PlatformRepo->ItsIdentifierArray[0]),
+         ARRAY_SIZE (PlatformRepo->ItsIdentifierArray),
+         &Index
+         )) {
+    return EFI_NOT_FOUND;
   }
 
-  return EFI_NOT_FOUND;
+  CmObject->ObjectId = CmObjectId;
+  CmObject->Size = sizeof (PlatformRepo->ItsIdentifierArray[0]);
+  CmObject->Data = (VOID*)&PlatformRepo->ItsIdentifierArray[Index];
+  CmObject->Count = 1;
+  return EFI_SUCCESS;
 }
 
 /** Return an ITS group info.
@@ -401,7 +402,6 @@ GetItsGroupInfo (
   )
 {
   EDKII_FVP_PLATFORM_REPOSITORY_INFO     * PlatformRepo;
-  UINTN                                    Count;
   UINTN                                    Index;
 
   if ((This == NULL) || (CmObject == NULL)) {
@@ -412,19 +412,21 @@ GetItsGroupInfo (
 
   PlatformRepo = This->PlatRepoInfo->FvpPlatRepoInfo;
 
-  Count = ARRAY_SIZE (PlatformRepo->ItsGroupInfo);
-
-  for (Index = 0; Index < Count; Index++) {
-    if (Token == (CM_OBJECT_TOKEN)&PlatformRepo->ItsGroupInfo[Index]) {
-      CmObject->ObjectId = CmObjectId;
-      CmObject->Size = sizeof (PlatformRepo->ItsGroupInfo[0]);
-      CmObject->Data = (VOID*)&PlatformRepo->ItsGroupInfo[Index];
-      CmObject->Count = 1;
-      return EFI_SUCCESS;
-    }
+  if (!GetTokenIndex (
+         Token,
+         PlatformRepo->ItsGroupInfo,
+         sizeof (PlatformRepo->ItsGroupInfo[0]),
+         ARRAY_SIZE (PlatformRepo->ItsGroupInfo),
+         &Index
+         )) {
+    return EFI_NOT_FOUND;
   }
 
-  return EFI_NOT_FOUND;
+  CmObject->ObjectId = CmObjectId;
+  CmObject->Size = sizeof (PlatformRepo->ItsGroupInfo[0]);
+  CmObject->Data = (VOID*)&PlatformRepo->ItsGroupInfo[Index];
+  CmObject->Count = 1;
+  return EFI_SUCCESS;
 }
 
 /** Return platform specific ARM namespace object.
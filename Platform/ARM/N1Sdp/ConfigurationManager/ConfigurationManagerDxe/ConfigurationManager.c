@@ -1231,6 +1231,22 @@ HandleCmObjectSearchPlatformRepo (
   return Status;
 }
 
+/** Number of entries returned for the ARM namespace objects, indexed by
+    object ID. The counts depend on the multichip mode and are computed once
+    by InitializePlatformRepository.
+*/
+STATIC UINT32  mArmObjCount[EArmObjMax];
+
+/** Number of entries returned for the ACPI table list.
+*/
+STATIC UINT32  mAcpiTableCount;
+
+/** Number of ID mappings referenced by each DeviceIdMapping token, indexed by
+    the flat DeviceIdMapping entry index. Entries which are not the head of
+    a referenced ID mapping list are zero.
+*/
+STATIC UINT8  mDeviceIdMappingRefCount[Devicemapping_max * 2];
+
 /** Initialize the Platform Configuration Repository.
   @param [in]  PlatRepoInfo   Pointer to the Configuration Manager Protocol.
   @retval EFI_SUCCESS           Success
@@ -1276,11 +1292,85 @@ InitializePlatformRepository (
       Length = RemoteDdrSize;
     PlatRepoInfo->MemAffInfo[REMOTE_DDR_REGION2]. \
       Flags = EFI_ACPI_6_3_MEMORY_ENABLED;
+
+    mArmObjCount[EArmObjGicRedistributorInfo] = 2;
+    mArmObjCount[EArmObjGicCInfo] = PLAT_CPU_COUNT * 2;
+    mArmObjCount[EArmObjProcHierarchyInfo] =
+      PLAT_PROC_HIERARCHY_NODE_COUNT * 2;
+    mArmObjCount[EArmObjGicItsInfo] = Its_max;
+    mArmObjCount[EArmObjItsGroup] = Its_max;
+    mArmObjCount[EArmObjGicItsIdentifierArray] = Its_max;
+    mArmObjCount[EArmObjSmmuV3] = Smmuv3info_max;
+    mArmObjCount[EArmObjIdMappingArray] = Devicemapping_max;
+    mArmObjCount[EArmObjRootComplex] = Root_pcie_max;
+    mArmObjCount[EArmObjPciConfigSpaceInfo] = Root_pcie_max;
+    mAcpiTableCount = ARRAY_SIZE (PlatRepoInfo->CmAcpiTableList);
+  } else {
+    mArmObjCount[EArmObjGicRedistributorInfo] = 1;
+    mArmObjCount[EArmObjGicCInfo] = PLAT_CPU_COUNT;
+    mArmObjCount[EArmObjProcHierarchyInfo] = PLAT_PROC_HIERARCHY_NODE_COUNT;
+    mArmObjCount[EArmObjGicItsInfo] = Its_master_chip_max;
+    mArmObjCount[EArmObjItsGroup] = Its_master_chip_max;
+    mArmObjCount[EArmObjGicItsIdentifierArray] = Its_master_chip_max;
+    mArmObjCount[EArmObjSmmuV3] = Smmuv3info_master_chip_max;
+    mArmObjCount[EArmObjIdMappingArray] = Devicemapping_master_chip_max;
+    mArmObjCount[EArmObjRootComplex] = Root_pcie_master_chip_max;
+    mArmObjCount[EArmObjPciConfigSpaceInfo] = Root_pcie_master_chip_max;
+    // The last ACPI table in the list is only installed in multichip mode
+    mAcpiTableCount = ARRAY_SIZE (PlatRepoInfo->CmAcpiTableList) - 1;
   }
 
+  // ID mapping lists referenced by the IORT nodes
+  mDeviceIdMappingRefCount[(Devicemapping_smmu_pcie * 2)] = 2;
+  mDeviceIdMappingRefCount[(Devicemapping_smmu_ccix * 2)] = 2;
+  mDeviceIdMappingRefCount[(Devicemapping_pcie * 2)] = 1;
+  mDeviceIdMappingRefCount[(Devicemapping_pcie * 2) + 1] = 1;
+  mDeviceIdMappingRefCount[(Devicemapping_remote_smmu_pcie * 2)] = 2;
+  mDeviceIdMappingRefCount[(Devicemapping_remote_pcie * 2)] = 1;
+
   return EFI_SUCCESS;
 }
 
+/** Resolve a token to the index of the repository array entry it refers to.
+
+  The tokens handed out by this Configuration Manager are the addresses of
+  the repository entries, so the index is recovered from the token offset
+  rather than by comparing the token against every entry.
+
+  @param [in]  Token       Token to resolve.
+  @param [in]  Array       Base address of the repository array.
+  @param [in]  EntrySize   Size of one array entry.
+  @param [in]  EntryCount  Number of valid entries in the array.
+  @param [out] Index       Index of the entry referenced by the token.
+
+  @retval TRUE   The token references an entry of the array.
+  @retval FALSE  The token does not reference an entry of the array.
+**/
+STATIC
+BOOLEAN
+GetTokenIndex (
+  IN  CM_OBJECT_TOKEN   Token,
+  IN  CONST VOID        *Array,
+  IN  UINTN             EntrySize,
+  IN  UINTN             EntryCount,
+  OUT UINTN             *Index
+  )
+{
+  UINTN   Offset;
+
+  if (Token < (CM_OBJECT_TOKEN)Array) {
+    return FALSE;
+  }
+
+  Offset = (UINTN)(Token - (CM_OBJECT_TOKEN)Array);
+  if (((Offset % EntrySize) != 0) || ((Offset / EntrySize) >= EntryCount)) {
+    return FALSE;
+  }
+
+  *Index = Offset / EntrySize;
+  return TRUE;
+}
+
 /** Return a GT Block timer frame info list.
 
   @param [in]        This        Pointer to the Configuration Manager Protocol.
@@ -1345,7 +1435,6 @@ GetItsIdentifierArray (
   )
 {
   EDKII_PLATFORM_REPOSITORY_INFO  * PlatformRepo;
-  UINTN                             Count;
   UINTN                             Index;
 
   if ((This == NULL) || (CmObject == NULL)) {
@@ -1356,19 +1445,21 @@ GetItsIdentifierArray (
 
   PlatformRepo = This->PlatRepoInfo;
 
-  Count = ARRAY_SIZE (PlatformRepo->ItsIdentifierArray);
-
-  for (Index = 0; Index < Count; Index++) {
-    if (Token == (CM_OBJECT_TOKEN)&PlatformRepo->ItsIdentifierArray[Index]) {
-      CmObject->ObjectId = CmObjectId;
-      CmObject->Size = sizeof (PlatformRepo->ItsIdentifierArray[0]);
-      CmObject->Data = (VOID*)&PlatformRepo->ItsIdentifierArray[Index];
-      CmObject->Count = 1;
-      return EFI_SUCCESS;
-    }
+  if (!GetTokenIndex (
+         Token,
+         PlatformRepo->ItsIdentifierArray,
+         sizeof (PlatformRepo->ItsIdentifierArray[0]),
+         ARRAY_SIZE (PlatformRepo->ItsIdentifierArray),
+         &Index
+         )) {
+    return EFI_NOT_FOUND;
   }
 
-  return EFI_NOT_FOUND;
+  CmObject->ObjectId = CmObjectId;
+  CmObject->Size = sizeof (PlatformRepo->ItsIdentifierArray[0]);
+  CmObject->Data = (VOID*)&PlatformRepo->ItsIdentifierArray[Index];
+  CmObject->Count = 1;
+  return EFI_SUCCESS;
 }
 
 /** Return an ITS group info.
@@ -1393,7 +1484,6 @@ GetItsGroupInfo (
   )
 {
   EDKII_PLATFORM_REPOSITORY_INFO  * PlatformRepo;
-  UINTN                             Count;
   UINTN                             Index;
 
   if ((This == NULL) || (CmObject == NULL)) {
@@ -1404,19 +1494,21 @@ GetItsGroupInfo (
 
   PlatformRepo = This->PlatRepoInfo;
 
-  Count = ARRAY_SIZE (PlatformRepo->ItsGroupInfo);
-
-  for (Index = 0; Index < Count; Index++) {
-    if (Token == (CM_OBJECT_TOKEN)&PlatformRepo->ItsGroupInfo[Index]) {
-      CmObject->ObjectId = CmObjectId;
-      CmObject->Size = sizeof (PlatformRepo->ItsGroupInfo[0]);
-      CmObject->Data = (VOID*)&PlatformRepo->ItsGroupInfo[Index];
-      CmObject->Count = 1;
-      return EFI_SUCCESS;
-    }
+  if (!GetTokenIndex (
+         Token,
+         PlatformRepo->ItsGroupInfo,
+         sizeof (PlatformRepo->ItsGroupInfo[0]),
+         ARRAY_SIZE (PlatformRepo->ItsGroupInfo),
+         &Index
+         )) {
+    return EFI_NOT_FOUND;
   }
 
-  return EFI_NOT_FOUND;
+  CmObject->ObjectId = CmObjectId;
+  CmObject->Size = sizeof (PlatformRepo->ItsGroupInfo[0]);
+  CmObject->Data = (VOID*)&PlatformRepo->ItsGroupInfo[Index];
+  CmObject->Count = 1;
+  return EFI_SUCCESS;
 }
 
 /** Return a device Id mapping array.
@@ -1442,6 +1534,7 @@ GetDeviceIdMappingArray (
 {
   EDKII_PLATFORM_REPOSITORY_INFO  * PlatformRepo;
   UINTN                             Count;
+  UINTN                             Index;
 
   if ((This == NULL) || (CmObject == NULL)) {
     ASSERT (This != NULL);
@@ -1451,36 +1544,28 @@ GetDeviceIdMappingArray (
 
   PlatformRepo = This->PlatRepoInfo;
 
-  DEBUG ((DEBUG_INFO, "DeviceIdMapping - Token = %p\n"));
-
-  if (Token == (CM_OBJECT_TOKEN)&PlatformRepo->DeviceIdMapping[0][0]) {
-    Count = 2;
-    DEBUG ((DEBUG_INFO, "DeviceIdMapping - Found DeviceIdMapping[0][0]\n"));
-  } else if (Token ==
-             (CM_OBJECT_TOKEN)&PlatformRepo->DeviceIdMapping[1][0]) {
-    Count = 2;
-    DEBUG ((DEBUG_INFO, "DeviceIdMapping - Found DeviceIdMapping[1][0]\n"));
-  } else if (Token ==
-             (CM_OBJECT_TOKEN)&PlatformRepo->DeviceIdMapping[2][0]) {
-    Count  = 1;
-    DEBUG ((DEBUG_INFO, "DeviceIdMapping - Found DeviceIdMapping[2][0]\n"));
-  } else if (Token ==
-             (CM_OBJECT_TOKEN)&PlatformRepo->DeviceIdMapping[2][1]) {
-    Count  = 1;
-    DEBUG ((DEBUG_INFO, "DeviceIdMapping - Found DeviceIdMapping[2][1]\n"));
-  } else if (Token ==
-             (CM_OBJECT_TOKEN)&PlatformRepo->DeviceIdMapping[Devicemapping_remote_smmu_pcie][0]) {
-    Count = 2;
-    DEBUG ((DEBUG_INFO, "DeviceIdMapping - Found DeviceIdMapping[Devicemapping_remote_smmu_pcie][0]\n"));
-  } else if (Token ==
-             (CM_OBJECT_TOKEN)&PlatformRepo->DeviceIdMapping[Devicemapping_remote_pcie][0]) {
-    Count  = 1;
-    DEBUG ((DEBUG_INFO, "DeviceIdMapping - Found DeviceIdMapping[Devicemapping_remote_pcie][0]\n"));
-  } else {
+  DEBUG ((DEBUG_INFO, "DeviceIdMapping - Token = %p\n", (VOID*)Token));
+
+  if (!GetTokenIndex (
+         Token,
+         PlatformRepo->DeviceIdMapping,
+         sizeof (PlatformRepo->DeviceIdMapping[0][0]),
+         ARRAY_SIZE (mDeviceIdMappingRefCount),
+         &Index
+         ) ||
+      (mDeviceIdMappingRefCount[Index] == 0)) {
     DEBUG ((DEBUG_INFO, "DeviceIdMapping - Not Found\n"));
     return EFI_NOT_FOUND;
   }
 
+  Count = mDeviceIdMappingRefCount[Index];
+  DEBUG ((
+    DEBUG_INFO,
+    "DeviceIdMapping - Found DeviceIdMapping[%u][%u]\n",
+    Index / 2,
+    Index % 2
+    ));
+
   CmObject->Data = (VOID*)Token;
   CmObject->ObjectId = CmObjectId;
   CmObject->Count = Count;
@@ -1512,9 +1597,7 @@ GetGicCInfo (
   )
 {
   EDKII_PLATFORM_REPOSITORY_INFO  * PlatformRepo;
-  NEOVERSEN1SOC_PLAT_INFO           *PlatInfo;
-  UINT32                            TotalObjCount;
-  UINT32                            ObjIndex;
+  UINTN                             ObjIndex;
 
   if ((This == NULL) || (CmObject == NULL)) {
     ASSERT (This != NULL);
@@ -1523,25 +1606,22 @@ GetGicCInfo (
   }
 
   PlatformRepo = This->PlatRepoInfo;
-  PlatInfo = (NEOVERSEN1SOC_PLAT_INFO *)NEOVERSEN1SOC_PLAT_INFO_STRUCT_BASE;
-
-  if (PlatInfo->MultichipMode == 1) {
-    TotalObjCount = PLAT_CPU_COUNT * 2;
-  } else {
-    TotalObjCount = PLAT_CPU_COUNT;
-  }
 
-  for (ObjIndex = 0; ObjIndex < TotalObjCount; ObjIndex++) {
-    if (SearchToken == (CM_OBJECT_TOKEN)&PlatformRepo->GicCInfo[ObjIndex]) {
-      CmObject->ObjectId = CmObjectId;
-      CmObject->Size = sizeof (PlatformRepo->GicCInfo[ObjIndex]);
-      CmObject->Data = (VOID*)&PlatformRepo->GicCInfo[ObjIndex];
-      CmObject->Count = 1;
-      return EFI_SUCCESS;
-    }
+  if (!GetTokenIndex (
+         SearchToken,
+         PlatformRepo->GicCInfo,
+         sizeof (PlatformRepo->GicCInfo[0]),
+         mArmObjCount[EArmObjGicCInfo],
+         &ObjIndex
+         )) {
+    return EFI_NOT_FOUND;
   }
 
-  return EFI_NOT_FOUND;
+  CmObject->ObjectId = CmObjectId;
+  CmObject->Size = sizeof (PlatformRepo->GicCInfo[ObjIndex]);
+  CmObject->Data = (VOID*)&PlatformRepo->GicCInfo[ObjIndex];
+  CmObject->Count = 1;
+  return EFI_SUCCESS;
 }
 
 /** Return a list of Configuration Manager object references pointed to by the
@@ -1623,8 +1703,6 @@ GetStandardNameSpaceObject (
 {
   EFI_STATUS                        Status;
   EDKII_PLATFORM_REPOSITORY_INFO  * PlatformRepo;
-  NEOVERSEN1SOC_PLAT_INFO           *PlatInfo;
-  UINT32                            AcpiTableCount;
 
   if ((This == NULL) || (CmObject == NULL)) {
     ASSERT (This != NULL);
@@ -1634,10 +1712,6 @@ GetStandardNameSpaceObject (
 
   Status = EFI_NOT_FOUND;
   PlatformRepo = This->PlatRepoInfo;
-  PlatInfo = (NEOVERSEN1SOC_PLAT_INFO *)NEOVERSEN1SOC_PLAT_INFO_STRUCT_BASE;
-  AcpiTableCount = ARRAY_SIZE (PlatformRepo->CmAcpiTableList);
-  if (PlatInfo->MultichipMode == 0)
-        AcpiTableCount -= 1;
 
   switch (GET_CM_OBJECT_ID (CmObjectId)) {
     case EStdObjCfgMgrInfo:
@@ -1654,7 +1728,7 @@ GetStandardNameSpaceObject (
                  CmObjectId,
                  &PlatformRepo->CmAcpiTableList,
                  sizeof (PlatformRepo->CmAcpiTableList),
-                 AcpiTableCount,
+                 mAcpiTableCount,
                  CmObject
                  );
       break;
@@ -1697,18 +1771,6 @@ GetArmNameSpaceObject (
 {
   EFI_STATUS                        Status;
   EDKII_PLATFORM_REPOSITORY_INFO  * PlatformRepo;
-  NEOVERSEN1SOC_PLAT_INFO           *PlatInfo;
-  UINT32                            GicRedistCount;
-  UINT32                            GicCpuCount;
-  UINT32                            ProcHierarchyInfoCount;
-  UINT32                            GicItsInfoCount;
-  UINT32                            ItsGroupInfoCount;
-  UINT32                            ItsIdentifierArrayCount;
-  UINT32                            SmmuV3InfoCount;
-  UINT32                            DeviceIdMappingCount;
-  UINT32                            RootComplexInfoCount;
-  UINT32                            PciConfigInfoCount;
-
   if ((This == NULL) || (CmObject == NULL)) {
     ASSERT (This != NULL);
     ASSERT (CmObject != NULL);
@@ -1718,32 +1780,6 @@ GetArmNameSpaceObject (
   Status = EFI_NOT_FOUND;
   PlatformRepo = This->PlatRepoInfo;
 
-  // Probe for multi chip information
-  PlatInfo = (NEOVERSEN1SOC_PLAT_INFO *)NEOVERSEN1SOC_PLAT_INFO_STRUCT_BASE;
-  if (PlatInfo->MultichipMode == 1) {
-    GicRedistCount = 2;
-    GicCpuCount = PLAT_CPU_COUNT * 2;
-    ProcHierarchyInfoCount = PLAT_PROC_HIERARCHY_NODE_COUNT * 2;
-    GicItsInfoCount = Its_max;
-    ItsGroupInfoCount = Its_max;
-    ItsIdentifierArrayCount = Its_max;
-    SmmuV3InfoCount = Smmuv3info_max;
-    DeviceIdMappingCount = Devicemapping_max;
-    RootComplexInfoCount = Root_pcie_max;
-    PciConfigInfoCount = Root_pcie_max;
-  } else {
-    GicRedistCount = 1;
-    GicCpuCount = PLAT_CPU_COUNT;
-    ProcHierarchyInfoCount = PLAT_PROC_HIERARCHY_NODE_COUNT;
-    GicItsInfoCount = Its_master_chip_max;
-    ItsGroupInfoCount = Its_master_chip_max;
-    ItsIdentifierArrayCount = Its_master_chip_max;
-    SmmuV3InfoCount = Smmuv3info_master_chip_max;
-    DeviceIdMappingCount = Devicemapping_master_chip_max;
-    RootComplexInfoCount = Root_pcie_master_chip_max;
-    PciConfigInfoCount = Root_pcie_master_chip_max;
-  }
-
   switch (GET_CM_OBJECT_ID (CmObjectId)) {
     case EArmObjBootArchInfo:
       Status = HandleCmObject (
@@ -1824,7 +1860,7 @@ GetArmNameSpaceObject (
                  CmObjectId,
                  PlatformRepo->GicCInfo,
                  sizeof (PlatformRepo->GicCInfo),
-                 GicCpuCount,
+                 mArmObjCount[EArmObjGicCInfo],
                  Token,
                  GetGicCInfo,
                  CmObject
@@ -1846,7 +1882,7 @@ GetArmNameSpaceObject (
                  CmObjectId,
                  PlatformRepo->GicRedistInfo,
                  sizeof (PlatformRepo->GicRedistInfo),
-                 GicRedistCount,
+                 mArmObjCount[EArmObjGicRedistributorInfo],
                  CmObject
                  );
       break;
@@ -1876,7 +1912,7 @@ GetArmNameSpaceObject (
                  CmObjectId,
                  PlatformRepo->GicItsInfo,
                  sizeof (PlatformRepo->GicItsInfo),
-                 GicItsInfoCount,
+                 mArmObjCount[EArmObjGicItsInfo],
                  CmObject
                  );
       break;
@@ -1886,7 +1922,7 @@ GetArmNameSpaceObject (
                  CmObjectId,
                  PlatformRepo->SmmuV3Info,
                  sizeof (PlatformRepo->SmmuV3Info),
-                 SmmuV3InfoCount,
+                 mArmObjCount[EArmObjSmmuV3],
                  CmObject
                  );
       break;
@@ -1897,7 +1933,7 @@ GetArmNameSpaceObject (
                  CmObjectId,
                  PlatformRepo->ItsGroupInfo,
                  sizeof (PlatformRepo->ItsGroupInfo),
-                 ItsGroupInfoCount,
+                 mArmObjCount[EArmObjItsGroup],
                  Token,
                  GetItsGroupInfo,
                  CmObject
@@ -1910,7 +1946,7 @@ GetArmNameSpaceObject (
                  CmObjectId,
                  PlatformRepo->ItsIdentifierArray,
                  sizeof (PlatformRepo->ItsIdentifierArray),
-                 ItsIdentifierArrayCount,
+                 mArmObjCount[EArmObjGicItsIdentifierArray],
                  Token,
                  GetItsIdentifierArray,
                  CmObject
@@ -1922,7 +1958,7 @@ GetArmNameSpaceObject (
                  CmObjectId,
                  PlatformRepo->RootComplexInfo,
                  sizeof (PlatformRepo->RootComplexInfo),
-                 RootComplexInfoCount,
+                 mArmObjCount[EArmObjRootComplex],
                  CmObject
                  );
       break;
@@ -1933,7 +1969,7 @@ GetArmNameSpaceObject (
                  CmObjectId,
                  PlatformRepo->DeviceIdMapping,
                  sizeof (PlatformRepo->DeviceIdMapping),
-                 DeviceIdMappingCount,
+                 mArmObjCount[EArmObjIdMappingArray],
                  Token,
                  GetDeviceIdMappingArray,
                  CmObject
@@ -1945,7 +1981,7 @@ GetArmNameSpaceObject (
                  CmObjectId,
                  PlatformRepo->ProcHierarchyInfo,
                  sizeof (PlatformRepo->ProcHierarchyInfo),
-                 ProcHierarchyInfoCount,
+                 mArmObjCount[EArmObjProcHierarchyInfo],
                  CmObject
                  );
       break;
@@ -1975,7 +2011,7 @@ GetArmNameSpaceObject (
                  CmObjectId,
                  PlatformRepo->PciConfigInfo,
                  sizeof (PlatformRepo->PciConfigInfo),
-                 PciConfigInfoCount,
+                 mArmObjCount[EArmObjPciConfigSpaceInfo],
                  CmObject
                  );
       break;
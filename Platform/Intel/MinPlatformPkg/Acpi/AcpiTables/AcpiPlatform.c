@@ -36,6 +36,36 @@ typedef union {
   } AcpiApicCommon;
 } ACPI_APIC_STRUCTURE_PTR;
 
+//
+// Generated MADT and MCFG cached across boots. The tables follow the header
+// back to back, each one sized by the Length of its own ACPI header.
+//
+#define ACPI_TABLE_CACHE_SIGNATURE      SIGNATURE_32 ('A', 'T', 'C', 'C')
+#define ACPI_TABLE_CACHE_MAX_TABLES     2
+#define ACPI_TABLE_CACHE_VARIABLE_NAME  L"AcpiTableCache"
+
+typedef struct {
+  UINT32   Signature;
+  UINT32   HardwareSignature;
+  UINT32   TopologyCrc;
+  UINT32   TableCount;
+  UINT32   DataSize;
+  UINT32   DataCrc;
+} ACPI_TABLE_CACHE_HEADER;
+
+typedef struct {
+  UINT32   NumberOfCpus;
+  UINT32   NumberOfEnabledCpus;
+  UINT32   BspApicId;
+  UINT32   X2ApicEnabled;
+  UINT32   NumOfBitShift;
+  UINT32   ApicIdCrc;
+  UINT32   PcIoApicEnable;
+  UINT32   PcIoApicCount;
+  UINT32   SegmentCount;
+  UINT32   SegmentCrc;
+} ACPI_TABLE_CACHE_KEY;
+
 #pragma pack()
 
 extern EFI_ACPI_6_3_FIRMWARE_ACPI_CONTROL_STRUCTURE     Facs;
@@ -62,6 +92,15 @@ EFI_CPU_ID_ORDER_MAP        *mCpuApicIdOrderTable = NULL;
 UINTN                       mNumberOfCpus = 0;
 UINTN                       mNumberOfEnabledCPUs = 0;
 
+UINT32                      mHardwareSignature;
+BOOLEAN                     mAcpiTableCacheHit;
+UINT32                      mAcpiTableCacheTopologyCrc;
+UINT32                      mAcpiTableCacheHardwareSignature;
+UINT8                       *mAcpiTableCacheData = NULL;
+UINTN                       mAcpiTableCacheDataSize = 0;
+UINTN                       mAcpiTableCacheCount = 0;
+UINTN                       mAcpiTableCacheHandle[ACPI_TABLE_CACHE_MAX_TABLES];
+
 
 /**
   The function is called by PerformQuickSort to compare int values.
@@ -728,6 +767,46 @@ BuildAcpiTable (
   return EFI_SUCCESS;
 }
 
+/**
+  Record a generated table that was just installed, so that it can be saved
+  to the ACPI table cache at End of DXE.
+
+  @param[in] Table          The installed table.
+  @param[in] TableHandle    The handle returned by InstallAcpiTable().
+**/
+VOID
+AcpiTableCacheAppend (
+  IN EFI_ACPI_DESCRIPTION_HEADER  *Table,
+  IN UINTN                        TableHandle
+  )
+{
+  UINT8  *NewData;
+
+  if (!FeaturePcdGet (PcdAcpiTableCacheEnable)) {
+    return;
+  }
+
+  if (mAcpiTableCacheCount >= ACPI_TABLE_CACHE_MAX_TABLES) {
+    ASSERT (mAcpiTableCacheCount < ACPI_TABLE_CACHE_MAX_TABLES);
+    return;
+  }
+
+  NewData = ReallocatePool (
+              mAcpiTableCacheDataSize,
+              mAcpiTableCacheDataSize + Table->Length,
+              mAcpiTableCacheData
+              );
+  if (NewData == NULL) {
+    DEBUG ((DEBUG_ERROR, "Could not grow the ACPI table cache\n"));
+    return;
+  }
+
+  CopyMem (NewData + mAcpiTableCacheDataSize, Table, Table->Length);
+  mAcpiTableCacheData     = NewData;
+  mAcpiTableCacheDataSize += Table->Length;
+  mAcpiTableCacheHandle[mAcpiTableCacheCount++] = TableHandle;
+}
+
 /**
   Build from scratch and install the MADT.
 
@@ -1015,6 +1094,9 @@ InstallMadtFromScratch (
                          NewMadtTable->Header.Length,
                          &TableHandle
                          );
+  if (!EFI_ERROR (Status)) {
+    AcpiTableCacheAppend (&NewMadtTable->Header, TableHandle);
+  }
 
 Done:
   //
@@ -1098,6 +1180,9 @@ InstallMcfgFromScratch (
                          McfgTable->Header.Length,
                          &TableHandle
                          );
+  if (!EFI_ERROR (Status)) {
+    AcpiTableCacheAppend (&McfgTable->Header, TableHandle);
+  }
 
   return Status;
 }
@@ -1354,9 +1439,281 @@ IsHardwareChange (
   //
   FacsPtr = (EFI_ACPI_6_3_FIRMWARE_ACPI_CONTROL_STRUCTURE *)(UINTN)pFADT->FirmwareCtrl;
   FacsPtr->HardwareSignature = CRC;
+  mHardwareSignature = CRC;
   FreePool (HWChange);
 }
 
+/**
+  Calculate the CRC of the CPU topology and platform configuration that the
+  generated MADT and MCFG are built from.
+
+  @return The CRC used as the ACPI table cache key, 0 if it cannot be
+          calculated and the cache must not be used.
+**/
+UINT32
+GetAcpiTableCacheTopologyCrc (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  ACPI_TABLE_CACHE_KEY      Key;
+  EFI_PROCESSOR_INFORMATION ProcessorInfoBuffer;
+  UINT32                    *ApicIds;
+  UINTN                     Index;
+  PCI_SEGMENT_INFO          *PciSegmentInfo;
+  UINTN                     SegmentCount;
+  UINT32                    Crc;
+
+  ZeroMem (&Key, sizeof (Key));
+  Key.NumberOfCpus        = (UINT32) mNumberOfCpus;
+  Key.NumberOfEnabledCpus = (UINT32) mNumberOfEnabledCPUs;
+  Key.BspApicId           = GetApicId ();
+  Key.X2ApicEnabled       = mX2ApicEnabled;
+  Key.NumOfBitShift       = mNumOfBitShift;
+  Key.PcIoApicEnable      = PcdGet32 (PcdPcIoApicEnable);
+  Key.PcIoApicCount       = PcdGet8 (PcdPcIoApicCount);
+
+  //
+  // The same CPU count with a different set of enabled APIC IDs must not
+  // hit the cache.
+  //
+  ApicIds = AllocateZeroPool (mNumberOfCpus * sizeof (UINT32));
+  if (ApicIds == NULL) {
+    return 0;
+  }
+  for (Index = 0; Index < mNumberOfCpus; Index++) {
+    Status = mMpService->GetProcessorInfo (mMpService, Index, &ProcessorInfoBuffer);
+    if (EFI_ERROR (Status) || (ProcessorInfoBuffer.StatusFlag & PROCESSOR_ENABLED_BIT) == 0) {
+      ApicIds[Index] = MAX_UINT32;
+    } else {
+      ApicIds[Index] = (UINT32) ProcessorInfoBuffer.ProcessorId;
+    }
+  }
+  gBS->CalculateCrc32 (ApicIds, mNumberOfCpus * sizeof (UINT32), &Key.ApicIdCrc);
+  FreePool (ApicIds);
+
+  PciSegmentInfo = GetPciSegmentInfo (&SegmentCount);
+  Key.SegmentCount = (UINT32) SegmentCount;
+  if (SegmentCount != 0) {
+    gBS->CalculateCrc32 (PciSegmentInfo, SegmentCount * sizeof (PCI_SEGMENT_INFO), &Key.SegmentCrc);
+  }
+
+  Crc = 0;
+  gBS->CalculateCrc32 (&Key, sizeof (Key), &Crc);
+  return Crc;
+}
+
+/**
+  Install the MADT and MCFG saved by a previous boot if the cache key still
+  matches the current CPU topology and platform configuration.
+
+  @retval EFI_SUCCESS     The cached tables were installed.
+  @retval EFI_NOT_FOUND   There is no usable cache, the tables must be built.
+**/
+EFI_STATUS
+InstallAcpiTablesFromCache (
+  VOID
+  )
+{
+  EFI_STATUS                    Status;
+  ACPI_TABLE_CACHE_HEADER       *CacheHeader;
+  UINTN                         CacheSize;
+  UINT8                         *CacheData;
+  EFI_ACPI_DESCRIPTION_HEADER   *Table;
+  UINTN                         Offset;
+  UINTN                         Index;
+  UINT32                        Crc;
+  UINTN                         TableHandle;
+
+  CacheSize = 0;
+  Status = GetLargeVariable (
+             ACPI_TABLE_CACHE_VARIABLE_NAME,
+             &gMinPlatformAcpiTableCacheGuid,
+             &CacheSize,
+             NULL
+             );
+  if ((Status != EFI_BUFFER_TOO_SMALL) || (CacheSize <= sizeof (ACPI_TABLE_CACHE_HEADER))) {
+    DEBUG ((DEBUG_INFO, "ACPI table cache not present\n"));
+    return EFI_NOT_FOUND;
+  }
+
+  CacheHeader = AllocatePool (CacheSize);
+  if (CacheHeader == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Status = GetLargeVariable (
+             ACPI_TABLE_CACHE_VARIABLE_NAME,
+             &gMinPlatformAcpiTableCacheGuid,
+             &CacheSize,
+             CacheHeader
+             );
+  if (EFI_ERROR (Status)) {
+    Status = EFI_NOT_FOUND;
+    goto Done;
+  }
+
+  Status = EFI_NOT_FOUND;
+  CacheData = (UINT8 *) (CacheHeader + 1);
+
+  if ((CacheHeader->Signature != ACPI_TABLE_CACHE_SIGNATURE) ||
+      (CacheHeader->TableCount != ACPI_TABLE_CACHE_MAX_TABLES) ||
+      (CacheHeader->DataSize != CacheSize - sizeof (ACPI_TABLE_CACHE_HEADER)) ||
+      (CacheHeader->TopologyCrc != mAcpiTableCacheTopologyCrc)) {
+    DEBUG ((DEBUG_INFO, "ACPI table cache key mismatch\n"));
+    goto Done;
+  }
+
+  Crc = 0;
+  gBS->CalculateCrc32 (CacheData, CacheHeader->DataSize, &Crc);
+  if (Crc != CacheHeader->DataCrc) {
+    DEBUG ((DEBUG_ERROR, "ACPI table cache is corrupted\n"));
+    goto Done;
+  }
+
+  //
+  // Validate every table before installing any of them.
+  //
+  for (Index = 0, Offset = 0; Index < CacheHeader->TableCount; Index++) {
+    Table = (EFI_ACPI_DESCRIPTION_HEADER *) (CacheData + Offset);
+    if ((CacheHeader->DataSize - Offset < sizeof (EFI_ACPI_DESCRIPTION_HEADER)) ||
+        (Table->Length < sizeof (EFI_ACPI_DESCRIPTION_HEADER)) ||
+        (Table->Length > CacheHeader->DataSize - Offset)) {
+      DEBUG ((DEBUG_ERROR, "ACPI table cache has a bad table length\n"));
+      goto Done;
+    }
+    Offset += Table->Length;
+  }
+  if (Offset != CacheHeader->DataSize) {
+    goto Done;
+  }
+
+  for (Index = 0, Offset = 0; Index < CacheHeader->TableCount; Index++) {
+    Table = (EFI_ACPI_DESCRIPTION_HEADER *) (CacheData + Offset);
+    Status = mAcpiTable->InstallAcpiTable (
+                           mAcpiTable,
+                           Table,
+                           Table->Length,
+                           &TableHandle
+                           );
+    if (EFI_ERROR (Status)) {
+      //
+      // Roll back so that every table is built from scratch instead.
+      //
+      while (Index > 0) {
+        Index--;
+        mAcpiTable->UninstallAcpiTable (mAcpiTable, mAcpiTableCacheHandle[Index]);
+      }
+      Status = EFI_NOT_FOUND;
+      goto Done;
+    }
+    mAcpiTableCacheHandle[Index] = TableHandle;
+    Offset += Table->Length;
+  }
+
+  mAcpiTableCacheHit               = TRUE;
+  mAcpiTableCacheCount             = CacheHeader->TableCount;
+  mAcpiTableCacheHardwareSignature = CacheHeader->HardwareSignature;
+  DEBUG ((DEBUG_INFO, "Installed MADT and MCFG from the ACPI table cache\n"));
+  Status = EFI_SUCCESS;
+
+Done:
+  FreePool (CacheHeader);
+  return Status;
+}
+
+/**
+  Validate the ACPI table cache against the hardware signature calculated at
+  End of DXE.
+
+  Tables installed from a cache saved under a different hardware signature
+  are uninstalled and built from scratch. Tables built from scratch during
+  this boot are saved, keyed by the CPU topology and hardware signature.
+
+  The cache variable is runtime accessible, so it is locked on every path to
+  keep the OS from planting tables that a later boot would install.
+**/
+VOID
+AcpiTableCacheSync (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  ACPI_TABLE_CACHE_HEADER   *CacheHeader;
+  ACPI_TABLE_CACHE_HEADER   EmptyCacheHeader;
+  UINTN                     CacheSize;
+  UINTN                     Index;
+
+  if (mAcpiTableCacheHit) {
+    if (mAcpiTableCacheHardwareSignature == mHardwareSignature) {
+      Status = LockLargeVariable (ACPI_TABLE_CACHE_VARIABLE_NAME, &gMinPlatformAcpiTableCacheGuid);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "Lock ACPI table cache - %r\n", Status));
+        SetLargeVariable (ACPI_TABLE_CACHE_VARIABLE_NAME, &gMinPlatformAcpiTableCacheGuid, FALSE, 0, NULL);
+      }
+      return;
+    }
+
+    DEBUG ((DEBUG_INFO, "Hardware signature changed, rebuilding MADT and MCFG\n"));
+    for (Index = 0; Index < mAcpiTableCacheCount; Index++) {
+      mAcpiTable->UninstallAcpiTable (mAcpiTable, mAcpiTableCacheHandle[Index]);
+    }
+    mAcpiTableCacheHit   = FALSE;
+    mAcpiTableCacheCount = 0;
+
+    InstallMadtFromScratch ();
+    InstallMcfgFromScratch ();
+  }
+
+  CacheHeader = NULL;
+  if ((mAcpiTableCacheTopologyCrc != 0) &&
+      (mAcpiTableCacheCount == ACPI_TABLE_CACHE_MAX_TABLES)) {
+    CacheHeader = AllocateZeroPool (sizeof (ACPI_TABLE_CACHE_HEADER) + mAcpiTableCacheDataSize);
+  }
+
+  if (CacheHeader != NULL) {
+    CacheHeader->Signature         = ACPI_TABLE_CACHE_SIGNATURE;
+    CacheHeader->HardwareSignature = mHardwareSignature;
+    CacheHeader->TopologyCrc       = mAcpiTableCacheTopologyCrc;
+    CacheHeader->TableCount        = (UINT32) mAcpiTableCacheCount;
+    CacheHeader->DataSize          = (UINT32) mAcpiTableCacheDataSize;
+    CopyMem (CacheHeader + 1, mAcpiTableCacheData, mAcpiTableCacheDataSize);
+    gBS->CalculateCrc32 (CacheHeader + 1, mAcpiTableCacheDataSize, &CacheHeader->DataCrc);
+    CacheSize = sizeof (ACPI_TABLE_CACHE_HEADER) + mAcpiTableCacheDataSize;
+  } else {
+    //
+    // Nothing to save. A header without tables is never installed, store and
+    // lock it so that neither a stale nor a planted cache can be used.
+    //
+    ZeroMem (&EmptyCacheHeader, sizeof (EmptyCacheHeader));
+    CacheSize = sizeof (EmptyCacheHeader);
+  }
+
+  Status = SetLargeVariable (
+             ACPI_TABLE_CACHE_VARIABLE_NAME,
+             &gMinPlatformAcpiTableCacheGuid,
+             TRUE,
+             CacheSize,
+             (CacheHeader != NULL) ? (VOID *) CacheHeader : (VOID *) &EmptyCacheHeader
+             );
+  DEBUG ((DEBUG_INFO, "Save ACPI table cache - %r\n", Status));
+  if (EFI_ERROR (Status)) {
+    //
+    // An unlocked cache must not survive this boot.
+    //
+    SetLargeVariable (ACPI_TABLE_CACHE_VARIABLE_NAME, &gMinPlatformAcpiTableCacheGuid, FALSE, 0, NULL);
+  }
+  if (CacheHeader != NULL) {
+    FreePool (CacheHeader);
+  }
+
+  if (mAcpiTableCacheData != NULL) {
+    FreePool (mAcpiTableCacheData);
+    mAcpiTableCacheData     = NULL;
+    mAcpiTableCacheDataSize = 0;
+  }
+}
+
 VOID
 UpdateLocalTable (
   VOID
@@ -1402,6 +1759,10 @@ AcpiEndOfDxeEvent (
   // Calculate Hardware Signature value based on current platform configurations
   //
   IsHardwareChange ();
+
+  if (FeaturePcdGet (PcdAcpiTableCacheEnable)) {
+    AcpiTableCacheSync ();
+  }
 }
 
 /**
@@ -1470,8 +1831,25 @@ InstallAcpiPlatform (
 
   UpdateLocalTable ();
 
-  InstallMadtFromScratch ();
-  InstallMcfgFromScratch ();
+  //
+  // The cache is only trusted when it can be locked at End of DXE.
+  //
+  Status = EFI_NOT_FOUND;
+  if (FeaturePcdGet (PcdAcpiTableCacheEnable) && VarLibIsVariableRequestToLockSupported ()) {
+    PERF_INMODULE_BEGIN ("AcpiTableCache");
+    mAcpiTableCacheTopologyCrc = GetAcpiTableCacheTopologyCrc ();
+    if (mAcpiTableCacheTopologyCrc != 0) {
+      Status = InstallAcpiTablesFromCache ();
+    }
+    PERF_INMODULE_END ("AcpiTableCache");
+  }
+
+  if (EFI_ERROR (Status)) {
+    PERF_INMODULE_BEGIN ("MadtMcfgFromScratch");
+    InstallMadtFromScratch ();
+    InstallMcfgFromScratch ();
+    PERF_INMODULE_END ("MadtMcfgFromScratch");
+  }
 
   return EFI_SUCCESS;
 }
@@ -36,6 +36,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/PciSegmentInfoLib.h>
 #include <Library/SortLib.h>
 #include <Library/LocalApicLib.h>
+#include <Library/LargeVariableReadLib.h>
+#include <Library/LargeVariableWriteLib.h>
+#include <Library/VariableWriteLib.h>
+#include <Library/PerformanceLib.h>
 
 #include <Protocol/AcpiTable.h>
 #include <Protocol/MpService.h>
@@ -179,6 +179,25 @@ TestPointEndOfPeiPciBusMasterDisabled (
   VOID
   );
 
+/**
+  This service verifies the boot performance budget at the end of PEI.
+
+  Test subject: PEI module and phase performance.
+  Test overview: Verify the time spent in each PEIM, as recorded in the FPDT extended
+                 performance records, is within the budget in PcdTestPointPerformanceModuleBudget,
+                 and the end of PEI is reached within PcdTestPointPerformanceEndOfPeiBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps results to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfPeiPerformanceBudget (
+  VOID
+  );
+
 /**
   This service verifies bus master enable (BME) is disabled after PCI enumeration.
 
@@ -264,6 +283,23 @@ TestPointEndOfDxeDmaProtectionEnabled (
   VOID
   );
 
+/**
+  This service verifies the boot performance budget at the end of DXE.
+
+  Test subject: DXE phase performance.
+  Test overview: Verify the end of DXE is reached within PcdTestPointPerformanceEndOfDxeBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps results to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfDxePerformanceBudget (
+  VOID
+  );
+
 /**
   This service verifies the validity of System Management RAM (SMRAM) alignment at SMM Ready To Lock.
 
@@ -350,6 +386,26 @@ TestPointReadyToBootGcdResourceFunctional (
   VOID
   );
 
+/**
+  This service verifies the boot performance budget at Ready To Boot.
+
+  Test subject: Module and boot performance.
+  Test overview: Verify the time spent in each PEIM, DXE driver and SMM driver, as recorded
+                 in the FPDT firmware boot performance table, is within the budget in
+                 PcdTestPointPerformanceModuleBudget, and Ready To Boot is reached within
+                 PcdTestPointPerformanceReadyToBootBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps results to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointReadyToBootPerformanceBudget (
+  VOID
+  );
+
 /**
   This service verifies the validity of the memory type information settings.
 
@@ -670,12 +726,15 @@ TestPointSmmExitBootServices (
 #define TEST_POINT_BYTE2_END_OF_PEI_SYSTEM_RESOURCE_FUNCTIONAL                              BIT0
 #define TEST_POINT_BYTE2_END_OF_PEI_MTRR_FUNCTIONAL                                         BIT1
 #define TEST_POINT_BYTE2_END_OF_PEI_PCI_BUS_MASTER_DISABLED                                 BIT2
+#define TEST_POINT_BYTE2_END_OF_PEI_PERFORMANCE_BUDGET                                      BIT3
 #define   TEST_POINT_BYTE2_END_OF_PEI_SYSTEM_RESOURCE_FUNCTIONAL_ERROR_CODE                      L"0x02000000"
 #define   TEST_POINT_BYTE2_END_OF_PEI_SYSTEM_RESOURCE_FUNCTIONAL_ERROR_STRING                    L"Invalid System Resource\r\n"
 #define   TEST_POINT_BYTE2_END_OF_PEI_MTRR_FUNCTIONAL_ERROR_CODE                                 L"0x02010000"
 #define   TEST_POINT_BYTE2_END_OF_PEI_MTRR_FUNCTIONAL_ERROR_STRING                               L"Invalid MTRR Setting\r\n"
 #define   TEST_POINT_BYTE2_END_OF_PEI_PCI_BUS_MASTER_DISABLED_ERROR_CODE                         L"0x02020000"
 #define   TEST_POINT_BYTE2_END_OF_PEI_PCI_BUS_MASTER_DISABLED_ERROR_STRING                       L"PCI Bus Master Enabled\r\n"
+#define   TEST_POINT_BYTE2_END_OF_PEI_PERFORMANCE_BUDGET_ERROR_CODE                              L"0x02030000"
+#define   TEST_POINT_BYTE2_END_OF_PEI_PERFORMANCE_BUDGET_ERROR_STRING                            L"Boot performance budget exceeded\r\n"
 
 // Byte 3/4/5 - DXE
 #define TEST_POINT_PCI_ENUMERATION_DONE                                                     L" - PCI Enumeration Done - "
@@ -689,6 +748,7 @@ TestPointSmmExitBootServices (
 #define TEST_POINT_BYTE3_END_OF_DXE_NO_THIRD_PARTY_PCI_OPTION_ROM                           BIT2
 #define TEST_POINT_BYTE3_END_OF_DXE_DMA_ACPI_TABLE_FUNCTIONAL                               BIT3
 #define TEST_POINT_BYTE3_END_OF_DXE_DMA_PROTECTION_ENABLED                                  BIT4
+#define TEST_POINT_BYTE3_END_OF_DXE_PERFORMANCE_BUDGET                                      BIT5
 #define   TEST_POINT_BYTE3_PCI_ENUMERATION_DONE_RESOURCE_ALLOCATED_ERROR_CODE                    L"0x03000000"
 #define   TEST_POINT_BYTE3_PCI_ENUMERATION_DONE_RESOURCE_ALLOCATED_ERROR_STRING                  L"Invalid PCI Resource\r\n"
 #define   TEST_POINT_BYTE3_PCI_ENUMERATION_DONE_BUS_MASTER_DISABLED_ERROR_CODE                   L"0x03010000"
@@ -699,6 +759,8 @@ TestPointSmmExitBootServices (
 #define   TEST_POINT_BYTE3_END_OF_DXE_DMA_ACPI_TABLE_FUNCTIONAL_ERROR_STRING                     L"No DMA ACPI table\r\n"
 #define   TEST_POINT_BYTE3_END_OF_DXE_DMA_PROTECTION_ENABLED_ERROR_CODE                          L"0x03040000"
 #define   TEST_POINT_BYTE3_END_OF_DXE_DXE_DMA_PROTECTION_ENABLED_ERROR_STRING                    L"DMA protection disabled\r\n"
+#define   TEST_POINT_BYTE3_END_OF_DXE_PERFORMANCE_BUDGET_ERROR_CODE                              L"0x03050000"
+#define   TEST_POINT_BYTE3_END_OF_DXE_PERFORMANCE_BUDGET_ERROR_STRING                            L"Boot performance budget exceeded\r\n"
 
 #define TEST_POINT_BYTE4_READY_TO_BOOT_MEMORY_TYPE_INFORMATION_FUNCTIONAL                   BIT0
 #define TEST_POINT_BYTE4_READY_TO_BOOT_UEFI_MEMORY_ATTRIBUTE_TABLE_FUNCTIONAL               BIT1
@@ -706,6 +768,7 @@ TestPointSmmExitBootServices (
 #define TEST_POINT_BYTE4_READY_TO_BOOT_UEFI_CONSOLE_VARIABLE_FUNCTIONAL                     BIT3
 #define TEST_POINT_BYTE4_READY_TO_BOOT_ACPI_TABLE_FUNCTIONAL                                BIT4
 #define TEST_POINT_BYTE4_READY_TO_BOOT_GCD_RESOURCE_FUNCTIONAL                              BIT5
+#define TEST_POINT_BYTE4_READY_TO_BOOT_PERFORMANCE_BUDGET                                   BIT6
 #define   TEST_POINT_BYTE4_READY_TO_BOOT_MEMORY_TYPE_INFORMATION_FUNCTIONAL_ERROR_CODE           L"0x04000000"
 #define   TEST_POINT_BYTE4_READY_TO_BOOT_MEMORY_TYPE_INFORMATION_FUNCTIONAL_ERROR_STRING         L"Invalid Memory Type Information\r\n"
 #define   TEST_POINT_BYTE4_READY_TO_BOOT_UEFI_MEMORY_ATTRIBUTE_TABLE_FUNCTIONAL_ERROR_CODE       L"0x04010000"
@@ -718,6 +781,8 @@ TestPointSmmExitBootServices (
 #define   TEST_POINT_BYTE4_READY_TO_BOOT_ACPI_TABLE_FUNCTIONAL_ERROR_STRING                      L"Invalid ACPI Table\r\n"
 #define   TEST_POINT_BYTE4_READY_TO_BOOT_GCD_RESOURCE_FUNCTIONAL_ERROR_CODE                      L"0x04050000"
 #define   TEST_POINT_BYTE4_READY_TO_BOOT_GCD_RESOURCE_FUNCTIONAL_ERROR_STRING                    L"Invalid GCD Resource\r\n"
+#define   TEST_POINT_BYTE4_READY_TO_BOOT_PERFORMANCE_BUDGET_ERROR_CODE                           L"0x04060000"
+#define   TEST_POINT_BYTE4_READY_TO_BOOT_PERFORMANCE_BUDGET_ERROR_STRING                         L"Boot performance budget exceeded\r\n"
 
 #define TEST_POINT_BYTE5_READY_TO_BOOT_UEFI_SECURE_BOOT_ENABLED                             BIT0
 #define TEST_POINT_BYTE5_READY_TO_BOOT_PI_SIGNED_FV_BOOT_ENABLED                            BIT1
@@ -782,6 +847,14 @@ typedef struct {
   CHAR16  End;
 } ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT;
 
+//
+// Entry of PcdTestPointPerformanceModuleBudget.
+//
+typedef struct {
+  EFI_GUID  ModuleGuid;  // FFS file name of the module
+  UINT32    BudgetUs;    // Maximum time from module start to module end, in microseconds
+} TEST_POINT_PERFORMANCE_BUDGET;
+
 #pragma pack ()
 
 #endif
@@ -0,0 +1,216 @@
+/** @file
+  Boot performance budget test points at End of DXE and Ready To Boot.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <PiDxe.h>
+#include <Library/TestPointCheckLib.h>
+#include <Library/TestPointLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PcdLib.h>
+#include <IndustryStandard/Acpi.h>
+
+EFI_STATUS
+TestPointCheckModulePerformance (
+  IN UINT8  *Records,
+  IN UINTN  RecordSize
+  );
+
+UINT64
+TestPointGetLatestTimestamp (
+  IN UINT8  *Records,
+  IN UINTN  RecordSize
+  );
+
+UINT64
+TestPointGetSecResetEnd (
+  VOID
+  );
+
+UINT64
+TestPointGetCurrentTimestamp (
+  VOID
+  );
+
+EFI_STATUS
+TestPointCheckElapsedTime (
+  IN UINT32  BudgetMs,
+  IN CHAR8   *Milestone,
+  IN UINT64  ResetEnd,
+  IN UINT64  Timestamp
+  );
+
+VOID *
+TestPointGetAcpi (
+  IN UINT32  Signature
+  );
+
+/**
+  Return the firmware basic boot performance table (FBPT) referenced by the FPDT.
+
+  @return The FBPT, or NULL if the FPDT is not installed.
+**/
+EFI_ACPI_5_0_FPDT_PERFORMANCE_TABLE_HEADER *
+TestPointGetFbpt (
+  VOID
+  )
+{
+  EFI_ACPI_DESCRIPTION_HEADER                                *Fpdt;
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER                *Record;
+  EFI_ACPI_5_0_FPDT_BOOT_PERFORMANCE_TABLE_POINTER_RECORD    *BootPointer;
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_TABLE_HEADER                 *Fbpt;
+  UINTN                                                      Offset;
+
+  Fpdt = TestPointGetAcpi (EFI_ACPI_5_0_FIRMWARE_PERFORMANCE_DATA_TABLE_SIGNATURE);
+  if (Fpdt == NULL) {
+    return NULL;
+  }
+
+  for (Offset = sizeof(EFI_ACPI_DESCRIPTION_HEADER);
+       Offset + sizeof(EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER) <= Fpdt->Length;
+       Offset += Record->Length) {
+    Record = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *)((UINT8 *)Fpdt + Offset);
+    if (Record->Length == 0) {
+      break;
+    }
+    if ((Record->Type == EFI_ACPI_5_0_FPDT_RECORD_TYPE_FIRMWARE_BASIC_BOOT_POINTER) &&
+        (Record->Length >= sizeof(EFI_ACPI_5_0_FPDT_BOOT_PERFORMANCE_TABLE_POINTER_RECORD))) {
+      BootPointer = (EFI_ACPI_5_0_FPDT_BOOT_PERFORMANCE_TABLE_POINTER_RECORD *)Record;
+      Fbpt = (EFI_ACPI_5_0_FPDT_PERFORMANCE_TABLE_HEADER *)(UINTN)BootPointer->BootPerformanceTablePointer;
+      if ((Fbpt == NULL) ||
+          (Fbpt->Signature != EFI_ACPI_5_0_FPDT_BOOT_PERFORMANCE_TABLE_SIGNATURE) ||
+          (Fbpt->Length < sizeof(*Fbpt))) {
+        return NULL;
+      }
+      return Fbpt;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Return the ResetEnd timestamp of the FPDT firmware basic boot record.
+
+  @param[in]  Fbpt  The firmware basic boot performance table.
+
+  @return ResetEnd in nanoseconds, 0 if the FBPT has no basic boot record.
+**/
+UINT64
+TestPointGetFbptResetEnd (
+  IN EFI_ACPI_5_0_FPDT_PERFORMANCE_TABLE_HEADER  *Fbpt
+  )
+{
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER  *Record;
+  UINTN                                        Offset;
+
+  for (Offset = sizeof(*Fbpt);
+       Offset + sizeof(EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER) <= Fbpt->Length;
+       Offset += Record->Length) {
+    Record = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *)((UINT8 *)Fbpt + Offset);
+    if (Record->Length == 0) {
+      break;
+    }
+    if ((Record->Type == EFI_ACPI_5_0_FPDT_RUNTIME_RECORD_TYPE_FIRMWARE_BASIC_BOOT) &&
+        (Record->Length >= sizeof(EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_RECORD))) {
+      return ((EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_RECORD *)Record)->ResetEnd;
+    }
+  }
+
+  return 0;
+}
+
+EFI_STATUS
+TestPointCheckEndOfDxePerformance (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  //
+  // The FBPT is not published before Ready To Boot, so the time is taken from
+  // the performance counter, and only when the counter cannot wrap.
+  //
+  Status = TestPointCheckElapsedTime (
+             PcdGet32 (PcdTestPointPerformanceEndOfDxeBudget),
+             "End Of DXE",
+             TestPointGetSecResetEnd (),
+             TestPointGetCurrentTimestamp ()
+             );
+  if (EFI_ERROR(Status)) {
+    TestPointLibAppendErrorString (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      TEST_POINT_BYTE3_END_OF_DXE_PERFORMANCE_BUDGET_ERROR_CODE \
+        TEST_POINT_END_OF_DXE \
+        TEST_POINT_BYTE3_END_OF_DXE_PERFORMANCE_BUDGET_ERROR_STRING
+      );
+  }
+
+  return Status;
+}
+
+EFI_STATUS
+TestPointCheckReadyToBootPerformance (
+  VOID
+  )
+{
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_TABLE_HEADER  *Fbpt;
+  EFI_STATUS                                  Status;
+  EFI_STATUS                                  ReturnStatus;
+  UINT64                                      ResetEnd;
+  UINT64                                      Timestamp;
+
+  ReturnStatus = EFI_SUCCESS;
+  ResetEnd     = 0;
+  Timestamp    = 0;
+
+  //
+  // The FBPT holds the PEI, DXE and SMM module records behind the basic boot record.
+  //
+  Fbpt = TestPointGetFbpt ();
+  if (Fbpt == NULL) {
+    DEBUG ((DEBUG_INFO, "No FPDT - module budgets not checked\n"));
+  } else {
+    Status = TestPointCheckModulePerformance (
+               (UINT8 *)(Fbpt + 1),
+               Fbpt->Length - sizeof(*Fbpt)
+               );
+    if (EFI_ERROR(Status)) {
+      ReturnStatus = Status;
+    }
+    ResetEnd  = TestPointGetFbptResetEnd (Fbpt);
+    Timestamp = TestPointGetLatestTimestamp (
+                  (UINT8 *)(Fbpt + 1),
+                  Fbpt->Length - sizeof(*Fbpt)
+                  );
+  }
+
+  //
+  // The last FBPT record approximates Ready To Boot.
+  //
+  Status = TestPointCheckElapsedTime (
+             PcdGet32 (PcdTestPointPerformanceReadyToBootBudget),
+             "Ready To Boot",
+             ResetEnd,
+             Timestamp
+             );
+  if (EFI_ERROR(Status)) {
+    ReturnStatus = Status;
+  }
+
+  if (EFI_ERROR(ReturnStatus)) {
+    TestPointLibAppendErrorString (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      TEST_POINT_BYTE4_READY_TO_BOOT_PERFORMANCE_BUDGET_ERROR_CODE \
+        TEST_POINT_READY_TO_BOOT \
+        TEST_POINT_BYTE4_READY_TO_BOOT_PERFORMANCE_BUDGET_ERROR_STRING
+      );
+  }
+
+  return ReturnStatus;
+}
@@ -153,6 +153,16 @@ TestPointGetAcpi (
   IN UINT32  Signature
   );
 
+EFI_STATUS
+TestPointCheckEndOfDxePerformance (
+  VOID
+  );
+
+EFI_STATUS
+TestPointCheckReadyToBootPerformance (
+  VOID
+  );
+
 GLOBAL_REMOVE_IF_UNREFERENCED ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT  mTestPointStruct = {
   PLATFORM_TEST_POINT_VERSION,
   PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
@@ -396,6 +406,50 @@ TestPointEndOfDxeNoThirdPartyPciOptionRom (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the boot performance budget at the end of DXE.
+
+  Test subject: DXE phase performance.
+  Test overview: Verify the end of DXE is reached within PcdTestPointPerformanceEndOfDxeBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps results to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfDxePerformanceBudget (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     Result;
+
+  if ((mFeatureImplemented[3] & TEST_POINT_BYTE3_END_OF_DXE_PERFORMANCE_BUDGET) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointEndOfDxePerformanceBudget - Enter\n"));
+  Result = TRUE;
+  Status = TestPointCheckEndOfDxePerformance ();
+  if (EFI_ERROR(Status)) {
+    Result = FALSE;
+  }
+
+  if (Result) {
+    TestPointLibSetFeaturesVerified (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      3,
+      TEST_POINT_BYTE3_END_OF_DXE_PERFORMANCE_BUDGET
+      );
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointEndOfDxePerformanceBudget - Exit\n"));
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies the validity of System Management RAM (SMRAM) alignment at SMM Ready To Lock.
 
@@ -779,6 +833,53 @@ TestPointReadyToBootGcdResourceFunctional (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the boot performance budget at Ready To Boot.
+
+  Test subject: Module and boot performance.
+  Test overview: Verify the time spent in each PEIM, DXE driver and SMM driver, as recorded
+                 in the FPDT firmware boot performance table, is within the budget in
+                 PcdTestPointPerformanceModuleBudget, and Ready To Boot is reached within
+                 PcdTestPointPerformanceReadyToBootBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps results to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointReadyToBootPerformanceBudget (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     Result;
+
+  if ((mFeatureImplemented[4] & TEST_POINT_BYTE4_READY_TO_BOOT_PERFORMANCE_BUDGET) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointReadyToBootPerformanceBudget - Enter\n"));
+  Result = TRUE;
+  Status = TestPointCheckReadyToBootPerformance ();
+  if (EFI_ERROR(Status)) {
+    Result = FALSE;
+  }
+
+  if (Result) {
+    TestPointLibSetFeaturesVerified (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      4,
+      TEST_POINT_BYTE4_READY_TO_BOOT_PERFORMANCE_BUDGET
+      );
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointReadyToBootPerformanceBudget - Exit\n"));
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies the validity of the memory type information settings.
 
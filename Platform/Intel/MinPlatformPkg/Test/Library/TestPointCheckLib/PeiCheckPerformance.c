@@ -0,0 +1,101 @@
+/** @file
+  Boot performance budget test point at End of PEI.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <PiPei.h>
+#include <Library/TestPointCheckLib.h>
+#include <Library/TestPointLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <Library/PcdLib.h>
+#include <Guid/ExtendedFirmwarePerformance.h>
+
+EFI_STATUS
+TestPointCheckModulePerformance (
+  IN UINT8  *Records,
+  IN UINTN  RecordSize
+  );
+
+UINT64
+TestPointGetLatestTimestamp (
+  IN UINT8  *Records,
+  IN UINTN  RecordSize
+  );
+
+UINT64
+TestPointGetSecResetEnd (
+  VOID
+  );
+
+EFI_STATUS
+TestPointCheckElapsedTime (
+  IN UINT32  BudgetMs,
+  IN CHAR8   *Milestone,
+  IN UINT64  ResetEnd,
+  IN UINT64  Timestamp
+  );
+
+EFI_STATUS
+TestPointCheckPeiPerformance (
+  VOID
+  )
+{
+  EFI_HOB_GUID_TYPE         *GuidHob;
+  FPDT_PEI_EXT_PERF_HEADER  *PeiPerformanceLogHeader;
+  EFI_STATUS                Status;
+  EFI_STATUS                ReturnStatus;
+  UINT64                    Timestamp;
+  UINT64                    LatestTimestamp;
+
+  ReturnStatus = EFI_SUCCESS;
+  LatestTimestamp = 0;
+
+  GuidHob = GetFirstGuidHob (&gEdkiiFpdtExtendedFirmwarePerformanceGuid);
+  while (GuidHob != NULL) {
+    PeiPerformanceLogHeader = GET_GUID_HOB_DATA (GuidHob);
+    Status = TestPointCheckModulePerformance (
+               (UINT8 *)(PeiPerformanceLogHeader + 1),
+               PeiPerformanceLogHeader->SizeOfAllEntries
+               );
+    if (EFI_ERROR(Status)) {
+      ReturnStatus = Status;
+    }
+    Timestamp = TestPointGetLatestTimestamp (
+                  (UINT8 *)(PeiPerformanceLogHeader + 1),
+                  PeiPerformanceLogHeader->SizeOfAllEntries
+                  );
+    if (Timestamp > LatestTimestamp) {
+      LatestTimestamp = Timestamp;
+    }
+    GuidHob = GetNextGuidHob (&gEdkiiFpdtExtendedFirmwarePerformanceGuid, GET_NEXT_HOB (GuidHob));
+  }
+
+  //
+  // The last PEI performance record approximates the end of PEI.
+  //
+  Status = TestPointCheckElapsedTime (
+             PcdGet32 (PcdTestPointPerformanceEndOfPeiBudget),
+             "End Of PEI",
+             TestPointGetSecResetEnd (),
+             LatestTimestamp
+             );
+  if (EFI_ERROR(Status)) {
+    ReturnStatus = Status;
+  }
+
+  if (EFI_ERROR(ReturnStatus)) {
+    TestPointLibAppendErrorString (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      TEST_POINT_BYTE2_END_OF_PEI_PERFORMANCE_BUDGET_ERROR_CODE \
+        TEST_POINT_END_OF_PEI \
+        TEST_POINT_BYTE2_END_OF_PEI_PERFORMANCE_BUDGET_ERROR_STRING
+      );
+  }
+
+  return ReturnStatus;
+}
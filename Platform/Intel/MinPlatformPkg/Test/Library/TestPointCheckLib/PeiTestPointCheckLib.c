@@ -52,6 +52,11 @@ TestPointVtdEngine (
   VOID
   );
 
+EFI_STATUS
+TestPointCheckPeiPerformance (
+  VOID
+  );
+
 GLOBAL_REMOVE_IF_UNREFERENCED ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT  mTestPointStruct = {
   PLATFORM_TEST_POINT_VERSION,
   PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
@@ -469,6 +474,55 @@ TestPointEndOfPeiPciBusMasterDisabled (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the boot performance budget at the end of PEI.
+
+  Test subject: PEI module and phase performance.
+  Test overview: Verify the time spent in each PEIM, as recorded in the FPDT extended
+                 performance records, is within the budget in PcdTestPointPerformanceModuleBudget,
+                 and the end of PEI is reached within PcdTestPointPerformanceEndOfPeiBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps results to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfPeiPerformanceBudget (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     Result;
+  UINT8       *FeatureImplemented;
+
+  FeatureImplemented = GetFeatureImplemented ();
+
+  if ((FeatureImplemented[2] & TEST_POINT_BYTE2_END_OF_PEI_PERFORMANCE_BUDGET) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointEndOfPeiPerformanceBudget - Enter\n"));
+  Result = TRUE;
+  Status = TestPointCheckPeiPerformance ();
+  if (EFI_ERROR(Status)) {
+    Result = FALSE;
+  }
+
+  if (Result) {
+    TestPointLibSetFeaturesVerified (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      2,
+      TEST_POINT_BYTE2_END_OF_PEI_PERFORMANCE_BUDGET
+      );
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointEndOfPeiPerformanceBudget - Exit\n"));
+  return EFI_SUCCESS;
+}
+
 /**
   Initialize feature data.
 
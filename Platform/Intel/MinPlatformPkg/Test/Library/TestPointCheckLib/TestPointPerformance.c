@@ -0,0 +1,283 @@
+/** @file
+  Helpers shared by the PEI and DXE boot performance budget test points.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/TestPointCheckLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PerformanceLib.h>
+#include <Library/TimerLib.h>
+#include <Library/HobLib.h>
+#include <IndustryStandard/Acpi.h>
+#include <Guid/ExtendedFirmwarePerformance.h>
+#include <Guid/FirmwarePerformance.h>
+
+//
+// A performance counter wrapping sooner than this, such as the 24-bit ACPI PM
+// timer, cannot time a boot phase.
+//
+#define TEST_POINT_MIN_COUNTER_PERIOD_S  (24 * 60 * 60)
+
+/**
+  Return the performance budget of a module.
+
+  @param[in]  ModuleGuid  The FFS file name of the module.
+
+  @return The budget in microseconds, 0 if the module has no budget.
+**/
+UINT32
+TestPointGetModuleBudget (
+  IN EFI_GUID  *ModuleGuid
+  )
+{
+  TEST_POINT_PERFORMANCE_BUDGET  *Budget;
+  UINTN                          Count;
+  UINTN                          Index;
+
+  Budget = PcdGetPtr (PcdTestPointPerformanceModuleBudget);
+  Count  = PcdGetSize (PcdTestPointPerformanceModuleBudget) / sizeof(TEST_POINT_PERFORMANCE_BUDGET);
+  for (Index = 0; Index < Count; Index++) {
+    if (CompareGuid (&Budget[Index].ModuleGuid, ModuleGuid)) {
+      return Budget[Index].BudgetUs;
+    }
+  }
+
+  return PcdGet32 (PcdTestPointPerformanceDefaultModuleBudget);
+}
+
+/**
+  Check whether a FPDT extended performance record is a module start or end record.
+
+  @param[in]  Record      The performance record.
+  @param[in]  ProgressId  MODULE_START_ID or MODULE_END_ID.
+
+  @retval TRUE   The record is a module record with the requested progress ID.
+  @retval FALSE  The record is not a module record with the requested progress ID.
+**/
+BOOLEAN
+TestPointIsModuleRecord (
+  IN FPDT_GUID_EVENT_RECORD  *Record,
+  IN UINT16                  ProgressId
+  )
+{
+  if ((Record->Header.Type != FPDT_GUID_EVENT_TYPE) &&
+      (Record->Header.Type != FPDT_DYNAMIC_STRING_EVENT_TYPE)) {
+    return FALSE;
+  }
+  if (Record->Header.Length < sizeof(FPDT_GUID_EVENT_RECORD)) {
+    return FALSE;
+  }
+  return (BOOLEAN)(Record->ProgressID == ProgressId);
+}
+
+/**
+  Check the time spent in each module against its budget.
+
+  Every module start record is paired with the next module end record of the
+  same module, and the time between the two is compared with the budget from
+  PcdTestPointPerformanceModuleBudget or PcdTestPointPerformanceDefaultModuleBudget.
+
+  @param[in]  Records     The FPDT extended performance records.
+  @param[in]  RecordSize  The size of the records in bytes.
+
+  @retval EFI_SUCCESS            All modules are within their budget.
+  @retval EFI_INVALID_PARAMETER  At least one module exceeds its budget.
+**/
+EFI_STATUS
+TestPointCheckModulePerformance (
+  IN UINT8  *Records,
+  IN UINTN  RecordSize
+  )
+{
+  FPDT_GUID_EVENT_RECORD  *StartRecord;
+  FPDT_GUID_EVENT_RECORD  *EndRecord;
+  UINTN                   StartOffset;
+  UINTN                   EndOffset;
+  BOOLEAN                 EndFound;
+  UINT32                  Budget;
+  UINT64                  Duration;
+  EFI_STATUS              Status;
+
+  Status = EFI_SUCCESS;
+  for (StartOffset = 0;
+       StartOffset + sizeof(EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER) <= RecordSize;
+       StartOffset += StartRecord->Header.Length) {
+    StartRecord = (FPDT_GUID_EVENT_RECORD *)(Records + StartOffset);
+    if ((StartRecord->Header.Length == 0) ||
+        (StartOffset + StartRecord->Header.Length > RecordSize)) {
+      break;
+    }
+    if (!TestPointIsModuleRecord (StartRecord, MODULE_START_ID)) {
+      continue;
+    }
+    Budget = TestPointGetModuleBudget (&StartRecord->Guid);
+    if (Budget == 0) {
+      continue;
+    }
+
+    EndFound = FALSE;
+    for (EndOffset = StartOffset + StartRecord->Header.Length;
+         EndOffset + sizeof(EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER) <= RecordSize;
+         EndOffset += EndRecord->Header.Length) {
+      EndRecord = (FPDT_GUID_EVENT_RECORD *)(Records + EndOffset);
+      if ((EndRecord->Header.Length == 0) ||
+          (EndOffset + EndRecord->Header.Length > RecordSize)) {
+        break;
+      }
+      if (TestPointIsModuleRecord (EndRecord, MODULE_END_ID) &&
+          CompareGuid (&EndRecord->Guid, &StartRecord->Guid)) {
+        EndFound = TRUE;
+        break;
+      }
+    }
+    if (!EndFound || (EndRecord->Timestamp < StartRecord->Timestamp)) {
+      continue;
+    }
+
+    Duration = DivU64x32 (EndRecord->Timestamp - StartRecord->Timestamp, 1000);
+    if (Duration > Budget) {
+      DEBUG ((DEBUG_ERROR, "Module %g - %ld us, budget %d us\n", &StartRecord->Guid, Duration, Budget));
+      Status = EFI_INVALID_PARAMETER;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Return the latest timestamp of the FPDT extended performance records.
+
+  @param[in]  Records     The FPDT extended performance records.
+  @param[in]  RecordSize  The size of the records in bytes.
+
+  @return The latest timestamp in nanoseconds, 0 if there is no record.
+**/
+UINT64
+TestPointGetLatestTimestamp (
+  IN UINT8  *Records,
+  IN UINTN  RecordSize
+  )
+{
+  FPDT_GUID_EVENT_RECORD  *Record;
+  UINTN                   Offset;
+  UINT64                  Timestamp;
+
+  Timestamp = 0;
+  for (Offset = 0;
+       Offset + sizeof(EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER) <= RecordSize;
+       Offset += Record->Header.Length) {
+    Record = (FPDT_GUID_EVENT_RECORD *)(Records + Offset);
+    if ((Record->Header.Length == 0) ||
+        (Offset + Record->Header.Length > RecordSize)) {
+      break;
+    }
+    //
+    // All extended record types share the FPDT_GUID_EVENT_RECORD layout up to the Timestamp.
+    //
+    if ((Record->Header.Type < FPDT_GUID_EVENT_TYPE) ||
+        (Record->Header.Type > FPDT_GUID_QWORD_STRING_EVENT_TYPE) ||
+        (Record->Header.Length < sizeof(FPDT_GUID_EVENT_RECORD))) {
+      continue;
+    }
+    if (Record->Timestamp > Timestamp) {
+      Timestamp = Record->Timestamp;
+    }
+  }
+
+  return Timestamp;
+}
+
+/**
+  Return the ResetEnd timestamp reported by SEC, the base of the FPDT timestamps.
+
+  @return ResetEnd in nanoseconds, 0 if SEC did not report it.
+**/
+UINT64
+TestPointGetSecResetEnd (
+  VOID
+  )
+{
+  EFI_HOB_GUID_TYPE         *GuidHob;
+  FIRMWARE_SEC_PERFORMANCE  *Performance;
+
+  GuidHob = GetFirstGuidHob (&gEfiFirmwarePerformanceGuid);
+  if (GuidHob == NULL) {
+    return 0;
+  }
+  Performance = GET_GUID_HOB_DATA (GuidHob);
+  return Performance->ResetEnd;
+}
+
+/**
+  Return the current time on the time base of the FPDT timestamps.
+
+  @return The current time in nanoseconds, 0 if the performance counter may
+          wrap during a boot and cannot be used.
+**/
+UINT64
+TestPointGetCurrentTimestamp (
+  VOID
+  )
+{
+  UINT64  Frequency;
+  UINT64  StartValue;
+  UINT64  EndValue;
+
+  Frequency = GetPerformanceCounterProperties (&StartValue, &EndValue);
+  if ((Frequency == 0) || (EndValue <= StartValue) ||
+      (DivU64x64Remainder (EndValue - StartValue, Frequency, NULL) < TEST_POINT_MIN_COUNTER_PERIOD_S)) {
+    return 0;
+  }
+
+  return GetTimeInNanoSecond (GetPerformanceCounter ());
+}
+
+/**
+  Check the time elapsed since reset against the budget of a boot milestone.
+
+  The elapsed time is the distance between two FPDT timestamps, so it does not
+  depend on the performance counter starting at reset.
+
+  @param[in]  BudgetMs   The budget in milliseconds, 0 to skip the check.
+  @param[in]  Milestone  The name of the milestone.
+  @param[in]  ResetEnd   The ResetEnd timestamp in nanoseconds, 0 if unknown.
+  @param[in]  Timestamp  The timestamp of the milestone in nanoseconds, 0 if unknown.
+
+  @retval EFI_SUCCESS            The milestone is reached within the budget, or
+                                 the elapsed time is unknown.
+  @retval EFI_INVALID_PARAMETER  The milestone exceeds the budget.
+**/
+EFI_STATUS
+TestPointCheckElapsedTime (
+  IN UINT32  BudgetMs,
+  IN CHAR8   *Milestone,
+  IN UINT64  ResetEnd,
+  IN UINT64  Timestamp
+  )
+{
+  UINT64  ElapsedMs;
+
+  if (BudgetMs == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if ((ResetEnd == 0) || (Timestamp <= ResetEnd)) {
+    DEBUG ((DEBUG_INFO, "%a - no timestamp relative to ResetEnd, budget not checked\n", Milestone));
+    return EFI_SUCCESS;
+  }
+
+  ElapsedMs = DivU64x32 (Timestamp - ResetEnd, 1000000);
+  DEBUG ((DEBUG_INFO, "%a - %ld ms, budget %d ms\n", Milestone, ElapsedMs, BudgetMs));
+  if (ElapsedMs > BudgetMs) {
+    DEBUG ((DEBUG_ERROR, "%a exceeds the budget\n", Milestone));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
@@ -193,6 +193,28 @@ TestPointEndOfPeiPciBusMasterDisabled (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the boot performance budget at the end of PEI.
+
+  Test subject: PEI module and phase performance.
+  Test overview: Verify the time spent in each PEIM, as recorded in the FPDT extended
+                 performance records, is within the budget in PcdTestPointPerformanceModuleBudget,
+                 and the end of PEI is reached within PcdTestPointPerformanceEndOfPeiBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps results to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfPeiPerformanceBudget (
+  VOID
+  )
+{
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies bus master enable (BME) is disabled after PCI enumeration.
 
@@ -253,6 +275,26 @@ TestPointEndOfDxeNoThirdPartyPciOptionRom (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the boot performance budget at the end of DXE.
+
+  Test subject: DXE phase performance.
+  Test overview: Verify the end of DXE is reached within PcdTestPointPerformanceEndOfDxeBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps results to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfDxePerformanceBudget (
+  VOID
+  )
+{
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies the DMA ACPI table is reported at the end of DXE.
 
@@ -394,6 +436,29 @@ TestPointReadyToBootGcdResourceFunctional (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the boot performance budget at Ready To Boot.
+
+  Test subject: Module and boot performance.
+  Test overview: Verify the time spent in each PEIM, DXE driver and SMM driver, as recorded
+                 in the FPDT firmware boot performance table, is within the budget in
+                 PcdTestPointPerformanceModuleBudget, and Ready To Boot is reached within
+                 PcdTestPointPerformanceReadyToBootBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps results to the debug log.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointReadyToBootPerformanceBudget (
+  VOID
+  )
+{
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies the validity of the memory type information settings.
 
@@ -33,6 +33,7 @@ UINTN                                         gPciHostBridgeNumber = 0;
 BOOLEAN                                       gFullEnumeration     = TRUE;
 UINT64                                        gAllOne              = 0xFFFFFFFFFFFFFFFFULL;
 UINT64                                        gAllZero             = 0;
+PCI_CONFIG_SHADOW_STATS                       gPciConfigShadowStats;
 
 EFI_PCI_PLATFORM_PROTOCOL                     *gPciPlatformProtocol;
 EFI_PCI_OVERRIDE_PROTOCOL                     *gPciOverrideProtocol;
@@ -237,6 +238,7 @@ PciBusDriverBindingStart (
   EFI_STATUS                      Status;
   EFI_DEVICE_PATH_PROTOCOL        *ParentDevicePath;
   EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL *PciRootBridgeIo;
+  UINT64                          StartTicks;
 
   //
   // Initialize PciRootBridgeIo to suppress incorrect compiler warning.
@@ -330,6 +332,8 @@ PciBusDriverBindingStart (
     );
 
   Status = EFI_SUCCESS;
+  ZeroMem (&gPciConfigShadowStats, sizeof (gPciConfigShadowStats));
+  StartTicks = GetPerformanceCounter ();
   //
   // Enumerate the entire host bridge
   // After enumeration, a database that records all the device information will be created
@@ -358,6 +362,16 @@ PciBusDriverBindingStart (
     Status = PciEnumeratorLight (Controller);
   }
 
+  DEBUG ((
+    DEBUG_INFO,
+    "PciBus: enumeration took %lu us, %lu devices, %lu batched BAR probes, %lu BAR probes and %lu capability reads served from shadow\n",
+    DivU64x32 (GetTimeInNanoSecond (GetPerformanceCounter () - StartTicks), 1000),
+    (UINT64) gPciConfigShadowStats.DeviceCount,
+    (UINT64) gPciConfigShadowStats.BarBatchCount,
+    (UINT64) gPciConfigShadowStats.BarShadowHits,
+    (UINT64) gPciConfigShadowStats.CapabilityReadsSaved
+    ));
+
   if (EFI_ERROR (Status)) {
     return Status;
   }
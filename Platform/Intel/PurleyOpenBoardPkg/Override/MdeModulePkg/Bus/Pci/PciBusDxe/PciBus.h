@@ -39,6 +39,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PcdLib.h>
+#include <Library/TimerLib.h>
 
 #include <IndustryStandard/Pci.h>
 #include <IndustryStandard/PeImage.h>
@@ -160,6 +161,30 @@ struct _PCI_BAR {
 
 #define PCI_IO_DEVICE_SIGNATURE               SIGNATURE_32 ('p', 'c', 'i', 'o')
 
+//
+// Maximum number of capability entries kept in the per-device shadow.
+// The standard list can hold at most 48 DWORD aligned entries in 0x40 - 0xFF.
+//
+#define PCI_CAPABILITY_SHADOW_MAX             48
+#define PCI_EXP_CAPABILITY_SHADOW_MAX         32
+
+typedef struct {
+  UINT16                                    Id;
+  UINT16                                    Offset;
+  UINT16                                    Next;
+} PCI_CAPABILITY_SHADOW_ENTRY;
+
+//
+// Configuration space accesses avoided by the per-device shadow, reported
+// once the enumeration of a host bridge is done.
+//
+typedef struct {
+  UINTN                                     DeviceCount;
+  UINTN                                     BarBatchCount;
+  UINTN                                     BarShadowHits;
+  UINTN                                     CapabilityReadsSaved;
+} PCI_CONFIG_SHADOW_STATS;
+
 struct _PCI_IO_DEVICE {
   UINT32                                    Signature;
   EFI_HANDLE                                Handle;
@@ -282,6 +307,26 @@ struct _PCI_IO_DEVICE {
   UINT16                                    BridgeIoAlignment;
   UINT32                                    ResizableBarOffset;
   UINT32                                    ResizableBarNumber;
+
+  //
+  // Shadow of the BAR sizing results, valid only while the BARs are parsed
+  // during enumeration. BarShadowCount is 0 when the shadow is not valid.
+  //
+  UINT8                                     BarShadowCount;
+  UINT32                                    BarShadowOriginal[PCI_MAX_BAR];
+  UINT32                                    BarShadowLength[PCI_MAX_BAR];
+
+  //
+  // Shadow of the standard and PCI Express extended capability lists,
+  // populated by the first capability lookup on this device.
+  //
+  BOOLEAN                                   CapabilityShadowValid;
+  UINT8                                     CapabilityShadowCount;
+  PCI_CAPABILITY_SHADOW_ENTRY               CapabilityShadow[PCI_CAPABILITY_SHADOW_MAX];
+  BOOLEAN                                   ExpCapabilityShadowValid;
+  BOOLEAN                                   ExpCapabilityShadowComplete;
+  UINT8                                     ExpCapabilityShadowCount;
+  PCI_CAPABILITY_SHADOW_ENTRY               ExpCapabilityShadow[PCI_EXP_CAPABILITY_SHADOW_MAX];
 };
 
 #define PCI_IO_DEVICE_FROM_PCI_IO_THIS(a) \
@@ -310,6 +355,7 @@ extern UINTN                                        gPciHostBridgeNumber;
 extern EFI_HANDLE                                   gPciHostBrigeHandles[PCI_MAX_HOST_BRIDGE_NUM];
 extern UINT64                                       gAllOne;
 extern UINT64                                       gAllZero;
+extern PCI_CONFIG_SHADOW_STATS                      gPciConfigShadowStats;
 extern EFI_PCI_PLATFORM_PROTOCOL                    *gPciPlatformProtocol;
 extern EFI_PCI_OVERRIDE_PROTOCOL                    *gPciOverrideProtocol;
 extern BOOLEAN                                      mReserveIsaAliases;
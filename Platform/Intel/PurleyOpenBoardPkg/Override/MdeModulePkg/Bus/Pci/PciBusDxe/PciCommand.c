@@ -89,6 +89,199 @@ PciCapabilitySupport (
   return FALSE;
 }
 
+/**
+  Populate the shadow of the standard capability list of the device.
+
+  @param PciIoDevice       A pointer to the PCI_IO_DEVICE.
+
+**/
+STATIC
+VOID
+PciBuildCapabilityShadow (
+  IN PCI_IO_DEVICE  *PciIoDevice
+  )
+{
+  UINT8                        CapabilityPtr;
+  UINT16                       CapabilityEntry;
+  PCI_CAPABILITY_SHADOW_ENTRY  *Entry;
+
+  CapabilityPtr = 0;
+  if (IS_CARDBUS_BRIDGE (&PciIoDevice->Pci)) {
+    PciIoDevice->PciIo.Pci.Read (
+                             &PciIoDevice->PciIo,
+                             EfiPciIoWidthUint8,
+                             EFI_PCI_CARDBUS_BRIDGE_CAPABILITY_PTR,
+                             1,
+                             &CapabilityPtr
+                             );
+  } else {
+    PciIoDevice->PciIo.Pci.Read (
+                             &PciIoDevice->PciIo,
+                             EfiPciIoWidthUint8,
+                             PCI_CAPBILITY_POINTER_OFFSET,
+                             1,
+                             &CapabilityPtr
+                             );
+  }
+
+  PciIoDevice->CapabilityShadowCount = 0;
+  while ((CapabilityPtr >= 0x40) && ((CapabilityPtr & 0x03) == 0x00) &&
+         (PciIoDevice->CapabilityShadowCount < PCI_CAPABILITY_SHADOW_MAX)) {
+    PciIoDevice->PciIo.Pci.Read (
+                             &PciIoDevice->PciIo,
+                             EfiPciIoWidthUint16,
+                             CapabilityPtr,
+                             1,
+                             &CapabilityEntry
+                             );
+
+    Entry         = &PciIoDevice->CapabilityShadow[PciIoDevice->CapabilityShadowCount++];
+    Entry->Id     = (UINT8) CapabilityEntry;
+    Entry->Offset = CapabilityPtr;
+    Entry->Next   = (UINT8) (CapabilityEntry >> 8);
+
+    //
+    // Certain PCI device may incorrectly have capability pointing to itself,
+    // break to avoid dead loop.
+    //
+    if (CapabilityPtr == Entry->Next) {
+      break;
+    }
+
+    CapabilityPtr = (UINT8) Entry->Next;
+  }
+
+  PciIoDevice->CapabilityShadowValid = TRUE;
+}
+
+/**
+  Populate the shadow of the PCI Express extended capability list of the device.
+
+  The shadow is marked incomplete if the list holds more entries than the
+  shadow can keep.
+
+  @param PciIoDevice       A pointer to the PCI_IO_DEVICE.
+
+**/
+STATIC
+VOID
+PciBuildExpCapabilityShadow (
+  IN PCI_IO_DEVICE  *PciIoDevice
+  )
+{
+  EFI_STATUS                   Status;
+  UINT32                       CapabilityPtr;
+  UINT32                       CapabilityEntry;
+  PCI_CAPABILITY_SHADOW_ENTRY  *Entry;
+
+  PciIoDevice->ExpCapabilityShadowCount    = 0;
+  PciIoDevice->ExpCapabilityShadowComplete = TRUE;
+
+  CapabilityPtr = EFI_PCIE_CAPABILITY_BASE_OFFSET;
+  while (CapabilityPtr != 0) {
+    if (PciIoDevice->ExpCapabilityShadowCount == PCI_EXP_CAPABILITY_SHADOW_MAX) {
+      PciIoDevice->ExpCapabilityShadowComplete = FALSE;
+      break;
+    }
+
+    //
+    // Mask it to DWORD alignment per PCI spec
+    //
+    CapabilityPtr &= 0xFFC;
+    Status = PciIoDevice->PciIo.Pci.Read (
+                                      &PciIoDevice->PciIo,
+                                      EfiPciIoWidthUint32,
+                                      CapabilityPtr,
+                                      1,
+                                      &CapabilityEntry
+                                      );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    if (CapabilityEntry == MAX_UINT32) {
+      DEBUG ((
+        DEBUG_WARN,
+        "%a: [%02x|%02x|%02x] failed to access config space at offset 0x%x\n",
+        __FUNCTION__,
+        PciIoDevice->BusNumber,
+        PciIoDevice->DeviceNumber,
+        PciIoDevice->FunctionNumber,
+        CapabilityPtr
+        ));
+      break;
+    }
+
+    Entry         = &PciIoDevice->ExpCapabilityShadow[PciIoDevice->ExpCapabilityShadowCount++];
+    Entry->Id     = (UINT16) CapabilityEntry;
+    Entry->Offset = (UINT16) CapabilityPtr;
+    Entry->Next   = (UINT16) ((CapabilityEntry >> 20) & 0xFFF);
+
+    CapabilityPtr = Entry->Next;
+  }
+
+  PciIoDevice->ExpCapabilityShadowValid = TRUE;
+}
+
+/**
+  Look up a capability in a capability list shadow.
+
+  @param Shadow            The capability list shadow.
+  @param Count             The number of entries in the shadow.
+  @param CapId             The capability ID.
+  @param Start             The offset of the entry to start from, 0 for the head of the list.
+  @param ReadsSaved        If not NULL, incremented by the number of configuration
+                           reads the lookup avoided.
+  @param Index             The index of the found entry returned.
+
+  @retval EFI_SUCCESS            The capability is found.
+  @retval EFI_NOT_FOUND          The capability is not in the shadow.
+  @retval EFI_INVALID_PARAMETER  Start is not the offset of any entry in the shadow.
+
+**/
+STATIC
+EFI_STATUS
+PciLookupCapabilityShadow (
+  IN     PCI_CAPABILITY_SHADOW_ENTRY  *Shadow,
+  IN     UINTN                        Count,
+  IN     UINT16                       CapId,
+  IN     UINT32                       Start,
+  IN OUT UINTN                        *ReadsSaved OPTIONAL,
+     OUT UINTN                        *Index
+  )
+{
+  UINTN  First;
+  UINTN  Walk;
+
+  First = 0;
+  if (Start != 0) {
+    while ((First < Count) && (Shadow[First].Offset != Start)) {
+      First++;
+    }
+
+    if (First == Count) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  for (Walk = First; Walk < Count; Walk++) {
+    if (Shadow[Walk].Id == CapId) {
+      break;
+    }
+  }
+
+  if (ReadsSaved != NULL) {
+    *ReadsSaved += (Walk < Count) ? (Walk - First + 1) : (Count - First);
+  }
+
+  if (Walk == Count) {
+    return EFI_NOT_FOUND;
+  }
+
+  *Index = Walk;
+  return EFI_SUCCESS;
+}
+
 /**
   Locate capability register block per capability ID.
 
@@ -110,9 +303,12 @@ LocateCapabilityRegBlock (
   OUT UINT8         *NextRegBlock OPTIONAL
   )
 {
-  UINT8   CapabilityPtr;
-  UINT16  CapabilityEntry;
-  UINT8   CapabilityID;
+  EFI_STATUS  Status;
+  UINT8       CapabilityPtr;
+  UINT16      CapabilityEntry;
+  UINT8       CapabilityID;
+  UINTN       *ReadsSaved;
+  UINTN       Index;
 
   //
   // To check the capability of this device supports
@@ -121,6 +317,37 @@ LocateCapabilityRegBlock (
     return EFI_UNSUPPORTED;
   }
 
+  //
+  // Serve the lookup from the capability list shadow, walking the list in
+  // configuration space only if the start offset is not a shadowed entry.
+  //
+  ReadsSaved = &gPciConfigShadowStats.CapabilityReadsSaved;
+  if (!PciIoDevice->CapabilityShadowValid) {
+    PciBuildCapabilityShadow (PciIoDevice);
+    ReadsSaved = NULL;
+  }
+
+  Status = PciLookupCapabilityShadow (
+             PciIoDevice->CapabilityShadow,
+             PciIoDevice->CapabilityShadowCount,
+             CapId,
+             *Offset,
+             ReadsSaved,
+             &Index
+             );
+  if (Status == EFI_SUCCESS) {
+    *Offset = (UINT8) PciIoDevice->CapabilityShadow[Index].Offset;
+    if (NextRegBlock != NULL) {
+      *NextRegBlock = (UINT8) PciIoDevice->CapabilityShadow[Index].Next;
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  if (Status == EFI_NOT_FOUND) {
+    return EFI_NOT_FOUND;
+  }
+
   if (*Offset != 0) {
     CapabilityPtr = *Offset;
   } else {
@@ -206,6 +433,8 @@ LocatePciExpressCapabilityRegBlock (
   UINT32               CapabilityPtr;
   UINT32               CapabilityEntry;
   UINT16               CapabilityID;
+  UINTN                *ReadsSaved;
+  UINTN                Index;
 
   //
   // To check the capability of this device supports
@@ -214,6 +443,38 @@ LocatePciExpressCapabilityRegBlock (
     return EFI_UNSUPPORTED;
   }
 
+  //
+  // Serve the lookup from the extended capability list shadow. The list is
+  // walked in configuration space only if the start offset is not a shadowed
+  // entry, or the capability is not found in an incomplete shadow.
+  //
+  ReadsSaved = &gPciConfigShadowStats.CapabilityReadsSaved;
+  if (!PciIoDevice->ExpCapabilityShadowValid) {
+    PciBuildExpCapabilityShadow (PciIoDevice);
+    ReadsSaved = NULL;
+  }
+
+  Status = PciLookupCapabilityShadow (
+             PciIoDevice->ExpCapabilityShadow,
+             PciIoDevice->ExpCapabilityShadowCount,
+             CapId,
+             *Offset & 0xFFC,
+             ReadsSaved,
+             &Index
+             );
+  if (Status == EFI_SUCCESS) {
+    *Offset = PciIoDevice->ExpCapabilityShadow[Index].Offset;
+    if (NextRegBlock != NULL) {
+      *NextRegBlock = PciIoDevice->ExpCapabilityShadow[Index].Next;
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  if ((Status == EFI_NOT_FOUND) && PciIoDevice->ExpCapabilityShadowComplete) {
+    return EFI_NOT_FOUND;
+  }
+
   if (*Offset != 0) {
     CapabilityPtr = *Offset;
   } else {
@@ -510,11 +510,13 @@ GatherDeviceInfo (
   }
 
   //
-  // Start to parse the bars
+  // Start to parse the bars, sizing all of them in a single batch first
   //
+  PciShadowBars (PciIoDevice, PCI_MAX_BAR);
   for (Offset = 0x10, BarIndex = 0; Offset <= 0x24 && BarIndex < PCI_MAX_BAR; BarIndex++) {
     Offset = PciParseBar (PciIoDevice, Offset, BarIndex);
   }
+  PciIoDevice->BarShadowCount = 0;
 
   //
   // Parse the SR-IOV VF bars
@@ -588,12 +590,14 @@ GatherPpbInfo (
   //
   // PPB can have two BARs
   //
+  PciShadowBars (PciIoDevice, PPB_BAR_1 + 1);
   if (PciParseBar (PciIoDevice, 0x10, PPB_BAR_0) == 0x14) {
     //
     // Not 64-bit bar
     //
     PciParseBar (PciIoDevice, 0x14, PPB_BAR_1);
   }
+  PciIoDevice->BarShadowCount = 0;
 
   PciIo = &PciIoDevice->PciIo;
 
@@ -862,9 +866,63 @@ VfBarExisted (
   }
 }
 
+/**
+  Size the first BarCount BARs of the device in one batch and keep the
+  results in the BAR shadow of the device.
+
+  All the BARs are saved, written with all ones, read back and restored with
+  one multi-DWORD configuration access each, instead of four accesses per BAR.
+  The shadow is consumed by BarExisted() and must be invalidated by the caller
+  by clearing BarShadowCount once the BARs are parsed.
+
+  @param PciIoDevice       A pointer to the PCI_IO_DEVICE.
+  @param BarCount          The number of BARs starting at offset 0x10.
+
+**/
+VOID
+PciShadowBars (
+  IN PCI_IO_DEVICE  *PciIoDevice,
+  IN UINTN          BarCount
+  )
+{
+  EFI_PCI_IO_PROTOCOL *PciIo;
+  UINT32              AllOnes[PCI_MAX_BAR];
+  EFI_TPL             OldTpl;
+
+  ASSERT (BarCount <= PCI_MAX_BAR);
+
+  PciIo = &PciIoDevice->PciIo;
+  SetMem32 (AllOnes, sizeof (AllOnes), MAX_UINT32);
+
+  //
+  // Raise TPL to high level to disable timer interrupt while the BARs are probed
+  //
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+
+  PciIo->Pci.Read (PciIo, EfiPciIoWidthUint32, PCI_BASE_ADDRESSREG_OFFSET, BarCount, PciIoDevice->BarShadowOriginal);
+  PciIo->Pci.Write (PciIo, EfiPciIoWidthUint32, PCI_BASE_ADDRESSREG_OFFSET, BarCount, AllOnes);
+  PciIo->Pci.Read (PciIo, EfiPciIoWidthUint32, PCI_BASE_ADDRESSREG_OFFSET, BarCount, PciIoDevice->BarShadowLength);
+
+  //
+  // Write back the original values
+  //
+  PciIo->Pci.Write (PciIo, EfiPciIoWidthUint32, PCI_BASE_ADDRESSREG_OFFSET, BarCount, PciIoDevice->BarShadowOriginal);
+
+  //
+  // Restore TPL to its original level
+  //
+  gBS->RestoreTPL (OldTpl);
+
+  PciIoDevice->BarShadowCount = (UINT8) BarCount;
+  gPciConfigShadowStats.BarBatchCount++;
+}
+
 /**
   Check whether the bar is existed or not.
 
+  The result of PciShadowBars() is used when the BAR is covered by a valid
+  BAR shadow, otherwise the BAR is probed.
+
   @param PciIoDevice       A pointer to the PCI_IO_DEVICE.
   @param Offset            The offset.
   @param BarLengthValue    The bar length value returned.
@@ -886,31 +944,41 @@ BarExisted (
   UINT32              OriginalValue;
   UINT32              Value;
   EFI_TPL             OldTpl;
+  UINTN               Index;
 
   PciIo = &PciIoDevice->PciIo;
 
-  //
-  // Preserve the original value
-  //
-  PciIo->Pci.Read (PciIo, EfiPciIoWidthUint32, (UINT8) Offset, 1, &OriginalValue);
+  if ((Offset >= PCI_BASE_ADDRESSREG_OFFSET) &&
+      (Offset < PCI_BASE_ADDRESSREG_OFFSET + PciIoDevice->BarShadowCount * sizeof (UINT32)) &&
+      ((Offset & 0x03) == 0)) {
+    Index         = (Offset - PCI_BASE_ADDRESSREG_OFFSET) / sizeof (UINT32);
+    OriginalValue = PciIoDevice->BarShadowOriginal[Index];
+    Value         = PciIoDevice->BarShadowLength[Index];
+    gPciConfigShadowStats.BarShadowHits++;
+  } else {
+    //
+    // Preserve the original value
+    //
+    PciIo->Pci.Read (PciIo, EfiPciIoWidthUint32, (UINT8) Offset, 1, &OriginalValue);
 
-  //
-  // Raise TPL to high level to disable timer interrupt while the BAR is probed
-  //
-  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+    //
+    // Raise TPL to high level to disable timer interrupt while the BAR is probed
+    //
+    OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
 
-  PciIo->Pci.Write (PciIo, EfiPciIoWidthUint32, (UINT8) Offset, 1, &gAllOne);
-  PciIo->Pci.Read (PciIo, EfiPciIoWidthUint32, (UINT8) Offset, 1, &Value);
+    PciIo->Pci.Write (PciIo, EfiPciIoWidthUint32, (UINT8) Offset, 1, &gAllOne);
+    PciIo->Pci.Read (PciIo, EfiPciIoWidthUint32, (UINT8) Offset, 1, &Value);
 
-  //
-  // Write back the original value
-  //
-  PciIo->Pci.Write (PciIo, EfiPciIoWidthUint32, (UINT8) Offset, 1, &OriginalValue);
+    //
+    // Write back the original value
+    //
+    PciIo->Pci.Write (PciIo, EfiPciIoWidthUint32, (UINT8) Offset, 1, &OriginalValue);
 
-  //
-  // Restore TPL to its original level
-  //
-  gBS->RestoreTPL (OldTpl);
+    //
+    // Restore TPL to its original level
+    //
+    gBS->RestoreTPL (OldTpl);
+  }
 
   if (BarLengthValue != NULL) {
     *BarLengthValue = Value;
@@ -2175,6 +2243,8 @@ CreatePciIoDevice (
     return NULL;
   }
 
+  gPciConfigShadowStats.DeviceCount++;
+
   PciIoDevice->Signature        = PCI_IO_DEVICE_SIGNATURE;
   PciIoDevice->Handle           = NULL;
   PciIoDevice->PciRootBridgeIo  = Bridge->PciRootBridgeIo;
@@ -172,6 +172,20 @@ VfBarExisted (
   OUT UINT32       *OriginalBarValue
   );
 
+/**
+  Size the first BarCount BARs of the device in one batch and keep the
+  results in the BAR shadow of the device.
+
+  @param PciIoDevice       A pointer to the PCI_IO_DEVICE.
+  @param BarCount          The number of BARs starting at offset 0x10.
+
+**/
+VOID
+PciShadowBars (
+  IN PCI_IO_DEVICE  *PciIoDevice,
+  IN UINTN          BarCount
+  );
+
 /**
   Check whether the bar is existed or not.
 
@@ -8,6 +8,7 @@
 
 #include <Library/DebugLib.h>
 #include <Library/FlashLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeLib.h>
@@ -23,6 +24,20 @@ STATIC UINT32 mFlashBlockSize;
 STATIC UINT64 mNvStorageBase;
 STATIC UINT64 mNvStorageSize;
 
+//
+// Scratch buffer of one block used to compare a request against the current
+// Flash content, so that blank blocks are not erased again and unchanged
+// bytes are not programmed again.
+//
+STATIC UINT8  *mFlashBlockBuffer;
+
+//
+// Statistics of the erase and write requests which were avoided
+//
+STATIC UINTN  mSkippedEraseCount;
+STATIC UINTN  mSkippedWriteCount;
+STATIC UINTN  mTrimmedWriteBytes;
+
 /**
   Fixup internal data so that EFI can be call in virtual mode.
   Call the passed in Child Notify event and convert any pointers in
@@ -39,6 +54,72 @@ FlashFvbAddressChangeEvent (
   )
 {
   EfiConvertPointer (0x0, (VOID **)&mNvStorageBase);
+  EfiConvertPointer (0x0, (VOID **)&mFlashBlockBuffer);
+}
+
+/**
+  Report the statistics of the avoided Flash operations before handing over
+  to the OS.
+
+  @param[in]    Event   The Event that is being processed
+  @param[in]    Context Event Context
+**/
+VOID
+EFIAPI
+FlashFvbExitBootServicesEvent (
+  IN EFI_EVENT Event,
+  IN VOID      *Context
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: Skipped %Lu block erases, %Lu writes, %Lu written bytes\n",
+    __FUNCTION__,
+    (UINT64)mSkippedEraseCount,
+    (UINT64)mSkippedWriteCount,
+    (UINT64)mTrimmedWriteBytes
+    ));
+}
+
+/**
+  Check whether a Flash block is in the erased state.
+
+  @param[in]  Lba       The logical block index to check.
+  @param[out] IsErased  TRUE if all the bytes of the block are 0xFF.
+
+  @retval EFI_SUCCESS   The block content was checked.
+  @retval Others        The block could not be read.
+**/
+STATIC
+EFI_STATUS
+FlashFvbIsBlockErased (
+  IN  EFI_LBA Lba,
+  OUT BOOLEAN *IsErased
+  )
+{
+  EFI_STATUS Status;
+  UINT64     *Data;
+  UINTN      Index;
+
+  Status = FlashReadCommand (
+             mNvFlashBase + Lba * mFlashBlockSize,
+             mFlashBlockBuffer,
+             mFlashBlockSize
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Data = (UINT64 *)mFlashBlockBuffer;
+  for (Index = 0; Index < mFlashBlockSize / sizeof (UINT64); Index++) {
+    if (Data[Index] != MAX_UINT64) {
+      *IsErased = FALSE;
+      return EFI_SUCCESS;
+    }
+  }
+
+  *IsErased = TRUE;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -342,6 +423,9 @@ FlashFvbDxeWrite (
   )
 {
   EFI_STATUS Status;
+  UINTN      Address;
+  UINTN      Start;
+  UINTN      End;
 
   ASSERT (NumBytes != NULL);
   ASSERT (Buffer != NULL);
@@ -350,10 +434,41 @@ FlashFvbDxeWrite (
     return EFI_BAD_BUFFER_SIZE;
   }
 
+  if (*NumBytes == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Address = mNvFlashBase + Lba * mFlashBlockSize + Offset;
+  Start = 0;
+  End = *NumBytes;
+
+  //
+  // The Flash is sticky write, so only the bytes which differ from the
+  // current content need to be programmed. Variable and FTW header updates
+  // typically change a single state byte of a much larger request.
+  //
+  Status = FlashReadCommand (Address, mFlashBlockBuffer, *NumBytes);
+  if (!EFI_ERROR (Status)) {
+    while (Start < End && Buffer[Start] == mFlashBlockBuffer[Start]) {
+      Start++;
+    }
+
+    if (Start == End) {
+      mSkippedWriteCount++;
+      return EFI_SUCCESS;
+    }
+
+    while (Buffer[End - 1] == mFlashBlockBuffer[End - 1]) {
+      End--;
+    }
+
+    mTrimmedWriteBytes += *NumBytes - (End - Start);
+  }
+
   Status = FlashWriteCommand (
-             mNvFlashBase + Lba * mFlashBlockSize + Offset,
-             Buffer,
-             *NumBytes
+             Address + Start,
+             Buffer + Start,
+             End - Start
              );
 
   if (EFI_ERROR (Status)) {
@@ -421,7 +536,10 @@ FlashFvbDxeErase (
 {
   VA_LIST    Args;
   EFI_LBA    Start;
+  EFI_LBA    Lba;
+  EFI_LBA    EraseStart;
   UINTN      Length;
+  BOOLEAN    IsErased;
   EFI_STATUS Status;
 
   Status = EFI_SUCCESS;
@@ -429,14 +547,43 @@ FlashFvbDxeErase (
   VA_START (Args, This);
 
   for (Start = VA_ARG (Args, EFI_LBA);
-       Start != EFI_LBA_LIST_TERMINATOR;
+       Start != EFI_LBA_LIST_TERMINATOR && !EFI_ERROR (Status);
        Start = VA_ARG (Args, EFI_LBA))
   {
     Length = VA_ARG (Args, UINTN);
-    Status = FlashEraseCommand (
-               mNvFlashBase + Start * mFlashBlockSize,
-               Length * mFlashBlockSize
-               );
+
+    //
+    // Blocks which are already blank are left alone, the remaining ones are
+    // erased in runs of consecutive blocks.
+    //
+    EraseStart = Start;
+    for (Lba = Start; Lba <= Start + Length; Lba++) {
+      IsErased = FALSE;
+      if (Lba < Start + Length) {
+        Status = FlashFvbIsBlockErased (Lba, &IsErased);
+        if (EFI_ERROR (Status)) {
+          IsErased = FALSE;
+        }
+      }
+
+      if (Lba == Start + Length || IsErased) {
+        if (Lba > EraseStart) {
+          Status = FlashEraseCommand (
+                     mNvFlashBase + EraseStart * mFlashBlockSize,
+                     (Lba - EraseStart) * mFlashBlockSize
+                     );
+          if (EFI_ERROR (Status)) {
+            break;
+          }
+        }
+
+        if (IsErased) {
+          mSkippedEraseCount++;
+        }
+
+        EraseStart = Lba + 1;
+      }
+    }
   }
 
   VA_END (Args);
@@ -469,6 +616,7 @@ FlashFvbDxeInitialize (
   EFI_STATUS Status;
   EFI_HANDLE FvbHandle = NULL;
   EFI_EVENT  VirtualAddressChangeEvent;
+  EFI_EVENT  ExitBootServicesEvent;
 
   // Get NV store FV info
   mFlashBlockSize = FixedPcdGet32 (PcdFvBlockSize);
@@ -499,6 +647,11 @@ FlashFvbDxeInitialize (
     return EFI_DEVICE_ERROR;
   }
 
+  mFlashBlockBuffer = AllocateRuntimePool (mFlashBlockSize);
+  if (mFlashBlockBuffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
   Status = gBS->CreateEventEx (
                   EVT_NOTIFY_SIGNAL,
                   TPL_NOTIFY,
@@ -509,6 +662,16 @@ FlashFvbDxeInitialize (
                   );
   ASSERT_EFI_ERROR (Status);
 
+  Status = gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  FlashFvbExitBootServicesEvent,
+                  NULL,
+                  &gEfiEventExitBootServicesGuid,
+                  &ExitBootServicesEvent
+                  );
+  ASSERT_EFI_ERROR (Status);
+
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &FvbHandle,
                   &gEfiFirmwareVolumeBlockProtocolGuid,
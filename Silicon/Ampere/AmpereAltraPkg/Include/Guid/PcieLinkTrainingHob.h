@@ -0,0 +1,35 @@
+/** @file
+
+  Copyright (c) 2021, Ampere Computing LLC. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef PCIE_LINK_TRAINING_HOB_H_
+#define PCIE_LINK_TRAINING_HOB_H_
+
+#define PCIE_LINK_TRAINING_HOB_GUID \
+  { 0x72eb4e47, 0x95ea, 0x4b48, { 0xb5, 0x68, 0x32, 0x57, 0xe1, 0x1b, 0xc6, 0x5f } }
+
+extern GUID gPcieLinkTrainingHobGuid;
+
+#pragma pack(1)
+
+//
+// Link training result of one active PCIe controller. The HOB data is an
+// array of these, one per active controller.
+//
+typedef struct {
+  UINT8             Socket;
+  UINT8             RootComplex;           // ID of the Root Complex
+  UINT8             PcieIndex;             // Controller index within the Root Complex
+  BOOLEAN           LinkUp;
+  UINT8             ReInitCount;           // Soft resets issued before the link came up
+  UINT8             LtssmState;            // LTSSM state when polling stopped
+  UINT32            TrainingTime;          // Microseconds from the first poll to link up or give up
+} PCIE_LINK_TRAINING_ENTRY;
+
+#pragma pack()
+
+#endif /* PCIE_LINK_TRAINING_HOB_H_ */
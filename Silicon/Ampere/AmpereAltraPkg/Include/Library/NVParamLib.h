@@ -50,6 +50,14 @@
 
 #define NVPARAM_SIZE    0x8
 
+typedef struct {
+  UINT32     Param;   // Parameter ID
+  UINT16     ACLRd;   // Permission for read operation
+  UINT16     ACLWr;   // Permission for write operation, NVParamSetMany only
+  UINT32     Val;     // Value retrieved, or value to set
+  EFI_STATUS Status;  // Result of the operation on this parameter
+} NVPARAM_REQUEST;
+
 /**
   Retrieve a non-volatile parameter.
 
@@ -99,6 +107,44 @@ NVParamSet (
   IN UINT32 Val
   );
 
+/**
+  Retrieve a list of non-volatile parameters.
+
+  Every entry is processed, the result of each one is returned in its Status
+  field with the same meaning as for NVParamGet.
+
+  @param[in, out] Requests        Array of parameters to retrieve.
+  @param[in]      Count           Number of entries in Requests.
+
+  @retval EFI_SUCCESS             All parameters were retrieved.
+  @retval EFI_INVALID_PARAMETER   Requests is NULL or Count is zero.
+  @retval Others                  Status of the first entry which failed.
+**/
+EFI_STATUS
+NVParamGetMany (
+  IN OUT NVPARAM_REQUEST *Requests,
+  IN     UINTN           Count
+  );
+
+/**
+  Set a list of non-volatile parameters.
+
+  Every entry is processed, the result of each one is returned in its Status
+  field with the same meaning as for NVParamSet.
+
+  @param[in, out] Requests        Array of parameters to set.
+  @param[in]      Count           Number of entries in Requests.
+
+  @retval EFI_SUCCESS             All parameters were set.
+  @retval EFI_INVALID_PARAMETER   Requests is NULL or Count is zero.
+  @retval Others                  Status of the first entry which failed.
+**/
+EFI_STATUS
+NVParamSetMany (
+  IN OUT NVPARAM_REQUEST *Requests,
+  IN     UINTN           Count
+  );
+
 /**
   Clear a non-volatile parameter.
 
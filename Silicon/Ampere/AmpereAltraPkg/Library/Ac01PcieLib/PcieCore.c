@@ -8,10 +8,12 @@
 
 #include <PiDxe.h>
 
+#include <Guid/PcieLinkTrainingHob.h>
 #include <Guid/PlatformInfoHob.h>
 #include <Guid/RootComplexInfoHob.h>
 #include <Library/ArmGenericTimerCounterLib.h>
 #include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/BoardPcieLib.h>
 #include <Library/DebugLib.h>
 #include <Library/HobLib.h>
@@ -1280,72 +1282,83 @@ Ac01PcieCoreQoSLinkCheckRecovery (
   return LINK_CHECK_SUCCESS;
 }
 
+/**
+  Finish the setup of a controller whose link has just come up.
+
+  @param RootComplex[in]  Pointer to AC01_ROOT_COMPLEX structure
+  @param PcieIndex[in]    PCIe controller index
+**/
+STATIC
 VOID
-Ac01PcieCoreUpdateLink (
-  IN  AC01_ROOT_COMPLEX *RootComplex,
-  OUT BOOLEAN           *IsNextRoundNeeded,
-  OUT INT8              *FailedPciePtr,
-  OUT INT8              *FailedPcieCount
+Ac01PcieCoreLinkReady (
+  IN AC01_ROOT_COMPLEX   *RootComplex,
+  IN UINT8               PcieIndex
   )
 {
-  AC01_PCIE_CONTROLLER      *Pcie;
   PHYSICAL_ADDRESS          CfgBase;
-  UINT8                     PcieIndex;
-  UINT32                    Index;
   UINT32                    Val;
 
-  *IsNextRoundNeeded = FALSE;
-  *FailedPcieCount   = 0;
-  for (Index = 0; Index < MaxPcieControllerOfRootComplexB; Index++) {
-    FailedPciePtr[Index] = -1;
-  }
+  CfgBase = RootComplex->MmcfgBase + (RootComplex->Pcie[PcieIndex].DevNum << DEV_SHIFT);
 
-  if (!RootComplex->Active) {
-    return;
-  }
+  RootComplex->Pcie[PcieIndex].LinkUp = TRUE;
+  Val = MmioRead32 (CfgBase + PCIE_CAPABILITY_BASE + LINK_CONTROL_LINK_STATUS_REG);
 
-  // Loop for all controllers
-  for (PcieIndex = 0; PcieIndex < RootComplex->MaxPcieController; PcieIndex++) {
-    Pcie = &RootComplex->Pcie[PcieIndex];
-    CfgBase = RootComplex->MmcfgBase + (RootComplex->Pcie[PcieIndex].DevNum << DEV_SHIFT);
+  DEBUG ((
+    DEBUG_INFO,
+    "%a Socket%d RootComplex%d RP%d NEGO_LINK_WIDTH: 0x%x LINK_SPEED: 0x%x\n",
+    __FUNCTION__,
+    RootComplex->Socket,
+    RootComplex->ID,
+    PcieIndex,
+    CAP_NEGO_LINK_WIDTH_GET (Val),
+    CAP_LINK_SPEED_GET (Val)
+    ));
 
-    if (Pcie->Active && !Pcie->LinkUp) {
-      if (PcieLinkUpCheck (Pcie)) {
-        Pcie->LinkUp = TRUE;
-        Val = MmioRead32 (CfgBase + PCIE_CAPABILITY_BASE + LINK_CONTROL_LINK_STATUS_REG);
+  // Doing link checking and recovery if needed
+  Ac01PcieCoreQoSLinkCheckRecovery (RootComplex, PcieIndex);
 
-        DEBUG ((
-          DEBUG_INFO,
-          "%a Socket%d RootComplex%d RP%d NEGO_LINK_WIDTH: 0x%x LINK_SPEED: 0x%x\n",
-          __FUNCTION__,
-          RootComplex->Socket,
-          RootComplex->ID,
-          PcieIndex,
-          CAP_NEGO_LINK_WIDTH_GET (Val),
-          CAP_LINK_SPEED_GET (Val)
-          ));
+  // Link timeout after 32ms
+  SetLinkTimeout (RootComplex, PcieIndex, 32);
 
-        // Doing link checking and recovery if needed
-        Ac01PcieCoreQoSLinkCheckRecovery (RootComplex, PcieIndex);
+  // Un-mask Completion Timeout
+  DisableCompletionTimeOut (RootComplex, PcieIndex, FALSE);
+}
 
-        // Link timeout after 32ms
-        SetLinkTimeout (RootComplex, PcieIndex, 32);
+/**
+  Return the number of microseconds elapsed since StartTick.
 
-        // Un-mask Completion Timeout
-        DisableCompletionTimeOut (RootComplex, PcieIndex, FALSE);
+  It is not guaranteed the timer service is ready prior to PCI Dxe,
+  so the generic timer counter is read directly.
 
-      } else {
-        *IsNextRoundNeeded = FALSE;
-        FailedPciePtr[*FailedPcieCount] = PcieIndex;
-        *FailedPcieCount += 1;
-      }
-    }
-  }
+  @param StartTick[in]  System counter value at the start of the interval
+**/
+STATIC
+UINT32
+GetElapsedTimeUs (
+  IN UINT64 StartTick
+  )
+{
+  UINT64 Ticks;
+
+  Ticks = ArmGenericTimerGetSystemCount () - StartTick;
+  return (UINT32)DivU64x64Remainder (
+                   MultU64x32 (Ticks, 1000000),
+                   ArmGenericTimerGetTimerFreq (),
+                   NULL
+                   );
 }
 
 /**
   Verify the link status and retry to initialize the Root Complex if there's any issue.
 
+  Every active controller is polled until its link comes up, and is finished
+  as soon as it does, independently of the others. A controller is given
+  LINK_TRAINING_TIMEOUT per attempt. Only a controller whose LTSSM left the
+  Detect state without reaching L0 is soft reset, up to MAX_REINIT times.
+  A controller that never detects a receiver is treated as an empty slot
+  after LINK_DETECT_TIMEOUT. The result for every controller is published
+  in the PCIe link training HOB.
+
   @param RootComplexList      Pointer to the Root Complex list
 **/
 VOID
@@ -1353,64 +1366,142 @@ Ac01PcieCorePostSetupRC (
   IN AC01_ROOT_COMPLEX *RootComplexList
   )
 {
-  UINT8   RCIndex, Idx;
-  BOOLEAN IsNextRoundNeeded, NextRoundNeeded;
-  UINT64  PrevTick, CurrTick, ElapsedCycle;
-  UINT64  TimerTicks64;
-  UINT8   ReInit;
-  INT8    FailedPciePtr[MaxPcieControllerOfRootComplexB];
-  INT8    FailedPcieCount;
-
-  ReInit = 0;
-
-_link_polling:
-  NextRoundNeeded = FALSE;
-  //
-  // It is not guaranteed the timer service is ready prior to PCI Dxe.
-  // Calculate system ticks for link training.
-  //
-  TimerTicks64 = ArmGenericTimerGetTimerFreq (); /* 1 Second */
-  PrevTick = ArmGenericTimerGetSystemCount ();
-  ElapsedCycle = 0;
+  AC01_ROOT_COMPLEX         *RootComplex;
+  AC01_PCIE_CONTROLLER      *Pcie;
+  PCIE_LINK_TRAINING_ENTRY  Entry[AC01_PCIE_MAX_ROOT_COMPLEX][MaxPcieControllerOfRootComplexB];
+  PCIE_LINK_TRAINING_ENTRY  *Record;
+  BOOLEAN                   Pending[AC01_PCIE_MAX_ROOT_COMPLEX][MaxPcieControllerOfRootComplexB];
+  UINT64                    AttemptTick[AC01_PCIE_MAX_ROOT_COMPLEX][MaxPcieControllerOfRootComplexB];
+  UINT64                    StartTick;
+  UINT32                    Elapsed;
+  UINT32                    PendingCount;
+  UINT32                    Count;
+  UINT8                     RCIndex;
+  UINT8                     PcieIndex;
+  UINT8                     LtssmState;
 
-  do {
-    CurrTick = ArmGenericTimerGetSystemCount ();
-    if (CurrTick < PrevTick) {
-      ElapsedCycle += MAX_UINT64 - PrevTick;
-      PrevTick = 0;
-    }
-    ElapsedCycle += (CurrTick - PrevTick);
-    PrevTick = CurrTick;
-  } while (ElapsedCycle < TimerTicks64);
+  StartTick = ArmGenericTimerGetSystemCount ();
+  Count = 0;
 
   for (RCIndex = 0; RCIndex < AC01_PCIE_MAX_ROOT_COMPLEX; RCIndex++) {
-    Ac01PcieCoreUpdateLink (&RootComplexList[RCIndex], &IsNextRoundNeeded, FailedPciePtr, &FailedPcieCount);
-    if (IsNextRoundNeeded) {
-      NextRoundNeeded = TRUE;
+    RootComplex = &RootComplexList[RCIndex];
+    for (PcieIndex = 0; PcieIndex < MaxPcieControllerOfRootComplexB; PcieIndex++) {
+      Pcie = &RootComplex->Pcie[PcieIndex];
+      Pending[RCIndex][PcieIndex] = RootComplex->Active
+                                    && PcieIndex < RootComplex->MaxPcieController
+                                    && Pcie->Active
+                                    && !Pcie->LinkUp;
+      AttemptTick[RCIndex][PcieIndex] = StartTick;
+
+      Record = &Entry[RCIndex][PcieIndex];
+      ZeroMem (Record, sizeof (*Record));
+      Record->Socket = RootComplex->Socket;
+      Record->RootComplex = RootComplex->ID;
+      Record->PcieIndex = PcieIndex;
     }
   }
 
-  if (NextRoundNeeded && ReInit < MAX_REINIT) {
-    //
-    // Timer is up. Give another chance to re-program controller
-    //
-    ReInit++;
+  do {
+    PendingCount = 0;
+
     for (RCIndex = 0; RCIndex < AC01_PCIE_MAX_ROOT_COMPLEX; RCIndex++) {
-      Ac01PcieCoreUpdateLink (&RootComplexList[RCIndex], &IsNextRoundNeeded, FailedPciePtr, &FailedPcieCount);
-      if (IsNextRoundNeeded) {
-        for (Idx = 0; Idx < FailedPcieCount; Idx++) {
-          if (FailedPciePtr[Idx] == -1) {
+      RootComplex = &RootComplexList[RCIndex];
+      for (PcieIndex = 0; PcieIndex < MaxPcieControllerOfRootComplexB; PcieIndex++) {
+        if (!Pending[RCIndex][PcieIndex]) {
+          continue;
+        }
+
+        Pcie = &RootComplex->Pcie[PcieIndex];
+        Record = &Entry[RCIndex][PcieIndex];
+        LtssmState = SMLH_LTSSM_STATE_GET (MmioRead32 (Pcie->CsrBase + AC01_PCIE_CORE_LINK_STAT_REG));
+        Record->LtssmState = LtssmState;
+
+        if (PcieLinkUpCheck (Pcie)) {
+          Pending[RCIndex][PcieIndex] = FALSE;
+          Record->TrainingTime = GetElapsedTimeUs (StartTick);
+          Ac01PcieCoreLinkReady (RootComplex, PcieIndex);
+          Record->LinkUp = Pcie->LinkUp;
+          continue;
+        }
+
+        Elapsed = GetElapsedTimeUs (AttemptTick[RCIndex][PcieIndex]);
+        if (Elapsed >= LINK_DETECT_TIMEOUT && LtssmState <= LTSSM_STATE_DETECT_ACT) {
+          //
+          // No receiver detected, nothing is plugged in there
+          //
+          Pending[RCIndex][PcieIndex] = FALSE;
+          Record->TrainingTime = GetElapsedTimeUs (StartTick);
+          continue;
+        }
+
+        if (Elapsed >= LINK_TRAINING_TIMEOUT) {
+          if (Record->ReInitCount >= MAX_REINIT) {
+            DEBUG ((
+              DEBUG_ERROR,
+              "PCIE%d.%d Link training failed, LTSSM 0x%x\n",
+              RootComplex->ID,
+              PcieIndex,
+              LtssmState
+              ));
+            Pending[RCIndex][PcieIndex] = FALSE;
+            Record->TrainingTime = GetElapsedTimeUs (StartTick);
             continue;
           }
 
           //
-          // Some controller still observes link-down. Re-init controller
+          // A device is there but the link did not come up. Give another
+          // chance to re-program this controller only.
           //
-          Ac01PcieCoreSetupRC (&RootComplexList[RCIndex], TRUE, FailedPciePtr[Idx]);
+          DEBUG ((DEBUG_INFO, "PCIE%d.%d Start link re-initialization..\n", RootComplex->ID, PcieIndex));
+          Ac01PcieCoreSetupRC (RootComplex, TRUE, PcieIndex);
+          Record->ReInitCount++;
+          AttemptTick[RCIndex][PcieIndex] = ArmGenericTimerGetSystemCount ();
         }
+
+        PendingCount++;
       }
     }
 
-    goto _link_polling;
+    if (PendingCount > 0) {
+      MicroSecondDelay (LINK_POLL_INTERVAL_US);
+    }
+  } while (PendingCount > 0);
+
+  //
+  // Pack the records of the active controllers and publish them
+  //
+  for (RCIndex = 0; RCIndex < AC01_PCIE_MAX_ROOT_COMPLEX; RCIndex++) {
+    RootComplex = &RootComplexList[RCIndex];
+    if (!RootComplex->Active) {
+      continue;
+    }
+
+    for (PcieIndex = 0; PcieIndex < RootComplex->MaxPcieController; PcieIndex++) {
+      if (!RootComplex->Pcie[PcieIndex].Active) {
+        continue;
+      }
+
+      Record = &Entry[RCIndex][PcieIndex];
+      Record->LinkUp = RootComplex->Pcie[PcieIndex].LinkUp;
+      DEBUG ((
+        DEBUG_INFO,
+        "PCIE%d.%d LinkUp %d after %d us, %d re-init\n",
+        RootComplex->ID,
+        PcieIndex,
+        Record->LinkUp,
+        Record->TrainingTime,
+        Record->ReInitCount
+        ));
+      CopyMem (&Entry[0][0] + Count, Record, sizeof (*Record));
+      Count++;
+    }
+  }
+
+  if (Count > 0) {
+    BuildGuidDataHob (
+      &gPcieLinkTrainingHobGuid,
+      (VOID *)Entry,
+      Count * sizeof (PCIE_LINK_TRAINING_ENTRY)
+      );
   }
 }
@@ -40,6 +40,9 @@
 #define LTSSM_TRANSITION_TIMEOUT         100000      // 100 ms in total
 #define EP_LINKUP_TIMEOUT                (10 * 1000) // 10ms
 #define LINK_WAIT_INTERVAL_US            50
+#define LINK_TRAINING_TIMEOUT            1000000     // 1 s per training attempt
+#define LINK_DETECT_TIMEOUT              200000      // 200 ms without a receiver means an empty slot
+#define LINK_POLL_INTERVAL_US            1000
 
 #define PFA_MODE_ENABLE                  0
 #define PFA_MODE_CLEAR                   1
@@ -96,6 +99,7 @@
 #define PHY_STATUS_MASK                     (1 << 2)
 #define SMLH_LTSSM_STATE_MASK               0x3F00
 #define SMLH_LTSSM_STATE_GET(val)           ((val & SMLH_LTSSM_STATE_MASK) >> 8)
+#define   LTSSM_STATE_DETECT_ACT            0x01
 #define   LTSSM_STATE_L0                    0x11
 #define RDLH_SMLH_LINKUP_STATUS_GET(val)    (val & 0x3)
 #define PHY_STATUS_MASK_BIT                 0x04
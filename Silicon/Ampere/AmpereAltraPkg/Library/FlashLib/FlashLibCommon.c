@@ -343,7 +343,11 @@ FlashReadCommand (
     MmData[0] = MM_SPINOR_FUNC_READ;
     MmData[1] = ByteAddress + Count;
     MmData[2] = NumRead;
-    MmData[3] = (UINT64)gFlashLibPhysicalBuffer;  // Read data into the temp buffer with specified virtual address
+    if (gFlashLibRuntime) {
+      MmData[3] = (UINT64)gFlashLibPhysicalBuffer;  // Read data into the temp buffer with specified virtual address
+    } else {
+      MmData[3] = (UINT64)(Buffer + Count);         // Physical addressing, read straight into the caller buffer
+    }
 
     Status = FlashMmCommunicate (
               MmData,
@@ -363,7 +367,9 @@ FlashReadCommand (
     //
     // Get data from the virtual address of the temp buffer.
     //
-    CopyMem ((VOID *)(Buffer + Count), (VOID *)gFlashLibVirtualBuffer, NumRead);
+    if (gFlashLibRuntime) {
+      CopyMem ((VOID *)(Buffer + Count), (VOID *)gFlashLibVirtualBuffer, NumRead);
+    }
     Remain -= NumRead;
     Count += NumRead;
   }
@@ -9,6 +9,12 @@
 #ifndef FLASH_LIB_COMMON_H_
 #define FLASH_LIB_COMMON_H_
 
+//
+// Largest number of bytes moved by one read or write request. The SPI-NOR
+// service reports no transfer limit (SectorSize in the GET_INFO response is
+// the erase granularity), so requests are kept at the 4KB size the secure
+// side has always been given.
+//
 #define EFI_MM_MAX_TMP_BUF_SIZE           0x1000
 #define EFI_MM_MAX_PAYLOAD_SIZE           0x50
 
@@ -12,9 +12,51 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/NVParamLib.h>
+#include <Library/PcdLib.h>
 
 #include "NVParamLibCommon.h"
 
+//
+// Read cache, enabled by PcdNVParamReadCacheEnable. Parameters are
+// NVPARAM_SIZE apart, so neighbouring parameters use neighbouring slots.
+//
+#define NVPARAM_CACHE_ENTRIES  64
+
+typedef struct {
+  BOOLEAN    Valid;
+  UINT16     ACLRd;
+  UINT32     Param;
+  UINT32     Value;
+  EFI_STATUS Status;
+} NVPARAM_CACHE_ENTRY;
+
+STATIC NVPARAM_CACHE_ENTRY mNVParamCache[NVPARAM_CACHE_ENTRIES];
+
+STATIC
+NVPARAM_CACHE_ENTRY *
+NVParamCacheSlot (
+  IN UINT32 Param
+  )
+{
+  return &mNVParamCache[(Param / NVPARAM_SIZE) % NVPARAM_CACHE_ENTRIES];
+}
+
+STATIC
+VOID
+NVParamCacheInvalidate (
+  IN UINT32 Param
+  )
+{
+  NVPARAM_CACHE_ENTRY *Entry;
+
+  if (FixedPcdGetBool (PcdNVParamReadCacheEnable)) {
+    Entry = NVParamCacheSlot (Param);
+    if (Entry->Param == Param) {
+      Entry->Valid = FALSE;
+    }
+  }
+}
+
 /**
   Retrieve a non-volatile parameter.
 
@@ -41,11 +83,23 @@ NVParamGet (
   EFI_MM_COMMUNICATE_NVPARAM_RESPONSE MmNVParamRes;
   EFI_STATUS                          Status;
   UINT64                              MmData[5];
+  NVPARAM_CACHE_ENTRY                 *Entry;
 
   if (Val == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
+  Entry = NULL;
+  if (FixedPcdGetBool (PcdNVParamReadCacheEnable)) {
+    Entry = NVParamCacheSlot (Param);
+    if (Entry->Valid && Entry->Param == Param && Entry->ACLRd == ACLRd) {
+      if (!EFI_ERROR (Entry->Status)) {
+        *Val = Entry->Value;
+      }
+      return Entry->Status;
+    }
+  }
+
   MmData[0] = MM_NVPARAM_FUNC_READ;
   MmData[1] = Param;
   MmData[2] = (UINT64)ACLRd;
@@ -63,10 +117,12 @@ NVParamGet (
   switch (MmNVParamRes.Status) {
   case MM_NVPARAM_RES_SUCCESS:
     *Val = (UINT32)MmNVParamRes.Value;
-    return EFI_SUCCESS;
+    Status = EFI_SUCCESS;
+    break;
 
   case MM_NVPARAM_RES_NOT_SET:
-    return EFI_NOT_FOUND;
+    Status = EFI_NOT_FOUND;
+    break;
 
   case MM_NVPARAM_RES_NO_PERM:
     return EFI_ACCESS_DENIED;
@@ -77,6 +133,19 @@ NVParamGet (
   default:
     return EFI_INVALID_PARAMETER;
   }
+
+  //
+  // Only remember answers which can change through NVParamSet/NVParamClr
+  //
+  if (Entry != NULL) {
+    Entry->Valid  = TRUE;
+    Entry->Param  = Param;
+    Entry->ACLRd  = ACLRd;
+    Entry->Value  = (UINT32)MmNVParamRes.Value;
+    Entry->Status = Status;
+  }
+
+  return Status;
 }
 
 /**
@@ -109,6 +178,8 @@ NVParamSet (
   EFI_STATUS                          Status;
   UINT64                              MmData[5];
 
+  NVParamCacheInvalidate (Param);
+
   MmData[0] = MM_NVPARAM_FUNC_WRITE;
   MmData[1] = Param;
   MmData[2] = (UINT64)ACLRd;
@@ -140,6 +211,89 @@ NVParamSet (
   }
 }
 
+/**
+  Retrieve a list of non-volatile parameters.
+
+  Every entry is processed, the result of each one is returned in its Status
+  field with the same meaning as for NVParamGet.
+
+  @param[in, out] Requests        Array of parameters to retrieve.
+  @param[in]      Count           Number of entries in Requests.
+
+  @retval EFI_SUCCESS             All parameters were retrieved.
+  @retval EFI_INVALID_PARAMETER   Requests is NULL or Count is zero.
+  @retval Others                  Status of the first entry which failed.
+**/
+EFI_STATUS
+NVParamGetMany (
+  IN OUT NVPARAM_REQUEST *Requests,
+  IN     UINTN           Count
+  )
+{
+  EFI_STATUS Status;
+  UINTN      Index;
+
+  if (Requests == NULL || Count == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < Count; Index++) {
+    Requests[Index].Status = NVParamGet (
+                               Requests[Index].Param,
+                               Requests[Index].ACLRd,
+                               &Requests[Index].Val
+                               );
+    if (EFI_ERROR (Requests[Index].Status) && !EFI_ERROR (Status)) {
+      Status = Requests[Index].Status;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Set a list of non-volatile parameters.
+
+  Every entry is processed, the result of each one is returned in its Status
+  field with the same meaning as for NVParamSet.
+
+  @param[in, out] Requests        Array of parameters to set.
+  @param[in]      Count           Number of entries in Requests.
+
+  @retval EFI_SUCCESS             All parameters were set.
+  @retval EFI_INVALID_PARAMETER   Requests is NULL or Count is zero.
+  @retval Others                  Status of the first entry which failed.
+**/
+EFI_STATUS
+NVParamSetMany (
+  IN OUT NVPARAM_REQUEST *Requests,
+  IN     UINTN           Count
+  )
+{
+  EFI_STATUS Status;
+  UINTN      Index;
+
+  if (Requests == NULL || Count == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < Count; Index++) {
+    Requests[Index].Status = NVParamSet (
+                               Requests[Index].Param,
+                               Requests[Index].ACLRd,
+                               Requests[Index].ACLWr,
+                               Requests[Index].Val
+                               );
+    if (EFI_ERROR (Requests[Index].Status) && !EFI_ERROR (Status)) {
+      Status = Requests[Index].Status;
+    }
+  }
+
+  return Status;
+}
+
 /**
   Clear a non-volatile parameter.
 
@@ -164,6 +318,8 @@ NVParamClr (
   EFI_STATUS                          Status;
   UINT64                              MmData[5];
 
+  NVParamCacheInvalidate (Param);
+
   MmData[0] = MM_NVPARAM_FUNC_CLEAR;
   MmData[1] = Param;
   MmData[2] = 0;
@@ -210,6 +366,10 @@ NVParamClrAll (
   EFI_STATUS                          Status;
   UINT64                              MmData[5];
 
+  if (FixedPcdGetBool (PcdNVParamReadCacheEnable)) {
+    ZeroMem (mNVParamCache, sizeof (mNVParamCache));
+  }
+
   MmData[0] = MM_NVPARAM_FUNC_CLEAR_ALL;
 
   Status = NVParamMmCommunicate (
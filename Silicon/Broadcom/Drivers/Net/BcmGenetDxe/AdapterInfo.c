@@ -7,9 +7,11 @@
 **/
 
 #include <Uefi.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
 
 #include "BcmGenetDxe.h"
 
@@ -23,14 +25,36 @@ GenetAipGetInformation (
   OUT UINTN                             *InformationBlockSize
   )
 {
-  EFI_ADAPTER_INFO_MEDIA_STATE  *AdapterInfo;
-  GENET_PRIVATE_DATA            *Genet;
+  EFI_ADAPTER_INFO_MEDIA_STATE            *AdapterInfo;
+  BCM_GENET_ADAPTER_INFO_RX_PERFORMANCE   *RxPerformance;
+  GENET_PRIVATE_DATA                      *Genet;
 
   if (This == NULL || InformationBlock == NULL ||
       InformationBlockSize == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
+  if (CompareGuid (InformationType, &gBcmGenetAdapterInfoRxPerformanceGuid)) {
+    RxPerformance = AllocateZeroPool (sizeof (BCM_GENET_ADAPTER_INFO_RX_PERFORMANCE));
+    if (RxPerformance == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Genet = GENET_PRIVATE_DATA_FROM_AIP_THIS (This);
+    RxPerformance->RxFrames = Genet->Stats.RxTotalFrames;
+    RxPerformance->RxTimeNs = GetTimeInNanoSecond (Genet->RxTicks);
+    if (RxPerformance->RxFrames > 0) {
+      RxPerformance->RxTimePerFrameNs = DivU64x64Remainder (
+                                          RxPerformance->RxTimeNs,
+                                          RxPerformance->RxFrames,
+                                          NULL);
+    }
+
+    *InformationBlock = RxPerformance;
+    *InformationBlockSize = sizeof (BCM_GENET_ADAPTER_INFO_RX_PERFORMANCE);
+    return EFI_SUCCESS;
+  }
+
   if (!CompareGuid (InformationType, &gEfiAdapterInfoMediaStateGuid)) {
     return EFI_UNSUPPORTED;
   }
@@ -63,7 +87,8 @@ GenetAipSetInformation (
     return EFI_INVALID_PARAMETER;
   }
 
-  if (CompareGuid (InformationType, &gEfiAdapterInfoMediaStateGuid)) {
+  if (CompareGuid (InformationType, &gEfiAdapterInfoMediaStateGuid) ||
+      CompareGuid (InformationType, &gBcmGenetAdapterInfoRxPerformanceGuid)) {
     return EFI_WRITE_PROTECTED;
   }
 
@@ -86,15 +111,16 @@ GenetAipGetSupportedTypes (
     return EFI_INVALID_PARAMETER;
   }
 
-  Guid = AllocatePool (sizeof *Guid);
+  Guid = AllocatePool (2 * sizeof *Guid);
   if (Guid == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
-  CopyGuid (Guid, &gEfiAdapterInfoMediaStateGuid);
+  CopyGuid (&Guid[0], &gEfiAdapterInfoMediaStateGuid);
+  CopyGuid (&Guid[1], &gBcmGenetAdapterInfoRxPerformanceGuid);
 
   *InfoTypesBuffer      = Guid;
-  *InfoTypesBufferCount = 1;
+  *InfoTypesBufferCount = 2;
 
   return EFI_SUCCESS;
 }
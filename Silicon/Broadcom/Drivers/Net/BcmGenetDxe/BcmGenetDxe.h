@@ -13,6 +13,7 @@
 
 #include <Uefi.h>
 #include <Library/UefiLib.h>
+#include <Guid/BcmGenetAdapterInfo.h>
 #include <Protocol/BcmGenetPlatformDevice.h>
 #include <Protocol/AdapterInformation.h>
 #include <Protocol/ComponentName.h>
@@ -115,6 +116,12 @@
 #define GENET_DMA_DESC_SIZE                     12
 #define GENET_DMA_DEFAULT_QUEUE                 16
 
+//
+// Frames up to GENET_TX_BOUNCE_SIZE bytes are copied into a pre-mapped bounce
+// slot instead of being mapped.
+//
+#define GENET_TX_BOUNCE_SIZE                    512
+
 #define GENET_DMA_RING_SIZE                     0x40
 #define GENET_DMA_RINGS_SIZE                    (GENET_DMA_RING_SIZE * (GENET_DMA_DEFAULT_QUEUE + 1))
 
@@ -223,10 +230,21 @@ typedef struct {
   UINT16                              TxConsIndex;
   UINT16                              TxProdIndex;
 
+  EFI_PHYSICAL_ADDRESS                TxBounce;
+  GENET_MAP_INFO                      TxBounceMap;
+
+  VOID                                *TxRecycled[GENET_DMA_DESC_COUNT];
+  UINT16                              TxRecycledNext;
+  UINT16                              TxRecycledCount;
+
   EFI_PHYSICAL_ADDRESS                RxBuffer;
-  GENET_MAP_INFO                      RxBufferMap[GENET_DMA_DESC_COUNT];
+  GENET_MAP_INFO                      RxBufferMap;
   UINT16                              RxConsIndex;
   UINT16                              RxProdIndex;
+  UINT16                              RxBatchRemaining;
+
+  EFI_NETWORK_STATISTICS              Stats;
+  UINT64                              RxTicks;
 
   GENET_PHY_MODE                      PhyMode;
 
@@ -244,7 +262,9 @@ extern CONST EFI_ADAPTER_INFORMATION_PROTOCOL gGenetAdapterInfoTemplate;
 #define GENET_PRIVATE_DATA_FROM_SNP_THIS(a)   CR(a, GENET_PRIVATE_DATA, Snp, GENET_DRIVER_SIGNATURE)
 #define GENET_PRIVATE_DATA_FROM_AIP_THIS(a)   CR(a, GENET_PRIVATE_DATA, Aip, GENET_DRIVER_SIGNATURE)
 
+#define GENET_RX_BUFFER_SIZE                  (GENET_MAX_PACKET_SIZE * GENET_DMA_DESC_COUNT)
 #define GENET_RX_BUFFER(g, idx)               ((UINT8 *)(UINTN)(g)->RxBuffer + GENET_MAX_PACKET_SIZE * (idx))
+#define GENET_TX_BOUNCE_BUFFER(g, idx)        ((UINT8 *)(UINTN)(g)->TxBounce + GENET_TX_BOUNCE_SIZE * (idx))
 
 EFI_STATUS
 EFIAPI
@@ -334,23 +354,27 @@ GenetDmaFree (
   );
 
 VOID
-GenetDmaTriggerTx (
+GenetDmaQueueTx (
   IN GENET_PRIVATE_DATA   *Genet,
   IN UINT8                DescIndex,
   IN EFI_PHYSICAL_ADDRESS PhysAddr,
   IN UINTN                NumberOfBytes
   );
 
-EFI_STATUS
-GenetDmaMapRxDescriptor (
-  IN GENET_PRIVATE_DATA *Genet,
-  IN UINT8              DescIndex
+VOID
+GenetDmaKickTx (
+  IN GENET_PRIVATE_DATA   *Genet
+  );
+
+VOID
+GenetTxReclaim (
+  IN GENET_PRIVATE_DATA *Genet
   );
 
 VOID
-GenetDmaUnmapRxDescriptor (
+GenetDmaInitRxDescriptor (
   IN GENET_PRIVATE_DATA *Genet,
-  IN UINT8               DescIndex
+  IN UINT8              DescIndex
   );
 
 VOID
@@ -10,16 +10,13 @@
 #include <Library/DebugLib.h>
 #include <Library/DmaLib.h>
 #include <Library/IoLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
 #include "BcmGenetDxe.h"
 
 #define GENET_PHY_RETRY     1000
 
-STATIC CONST
-EFI_PHYSICAL_ADDRESS   mDmaAddressLimit = FixedPcdGet64 (PcdDmaDeviceLimit) -
-                                          FixedPcdGet64 (PcdDmaDeviceOffset);
-
 /**
   Read a memory-mapped device CSR.
 
@@ -540,16 +537,28 @@ GenetDmaInitRings (
   )
 {
   UINT8 Qid;
+  UINTN Idx;
 
   Qid = GENET_DMA_DEFAULT_QUEUE;
 
+  // Release the mappings of frames left queued by a previous session
+  for (Idx = 0; Idx < GENET_DMA_DESC_COUNT; Idx++) {
+    if (Genet->TxBufferMap[Idx] != NULL) {
+      DmaUnmap (Genet->TxBufferMap[Idx]);
+      Genet->TxBufferMap[Idx] = NULL;
+    }
+  }
+
   Genet->TxQueued = 0;
   Genet->TxNext = 0;
   Genet->TxConsIndex = 0;
   Genet->TxProdIndex = 0;
+  Genet->TxRecycledNext = 0;
+  Genet->TxRecycledCount = 0;
 
   Genet->RxConsIndex = 0;
   Genet->RxProdIndex = 0;
+  Genet->RxBatchRemaining = 0;
 
   // Configure TX queue
   GenetMmioWrite (Genet, GENET_TX_SCB_BURST_SIZE, 0x08);
@@ -598,98 +607,212 @@ GenetDmaInitRings (
 }
 
 /**
-  Allocate DMA buffers for RX.
+  Allocate a buffer and map it as a bus master common buffer.
+
+  @param  NumberOfBytes[in]  Size of the buffer.
+  @param  Buffer[out]        Host address of the buffer.
+  @param  MapInfo[out]       Device address and mapping of the buffer.
+
+  @retval EFI_SUCCESS           Buffer allocated and mapped.
+  @retval EFI_OUT_OF_RESOURCES  Buffer could not be allocated.
+  @retval Others                Buffer could not be mapped.
+**/
+STATIC
+EFI_STATUS
+GenetDmaAllocCommonBuffer (
+  IN  UINTN                 NumberOfBytes,
+  OUT EFI_PHYSICAL_ADDRESS  *Buffer,
+  OUT GENET_MAP_INFO        *MapInfo
+  )
+{
+  EFI_STATUS              Status;
+  VOID                    *HostAddress;
+  UINTN                   DmaNumberOfBytes;
+
+  Status = DmaAllocateBuffer (EfiBootServicesData,
+             EFI_SIZE_TO_PAGES (NumberOfBytes), &HostAddress);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  DmaNumberOfBytes = NumberOfBytes;
+  Status = DmaMap (MapOperationBusMasterCommonBuffer, HostAddress,
+             &DmaNumberOfBytes, &MapInfo->PhysAddress, &MapInfo->Mapping);
+  if (!EFI_ERROR (Status) && DmaNumberOfBytes != NumberOfBytes) {
+    DmaUnmap (MapInfo->Mapping);
+    Status = EFI_OUT_OF_RESOURCES;
+  }
+  if (EFI_ERROR (Status)) {
+    DmaFreeBuffer (EFI_SIZE_TO_PAGES (NumberOfBytes), HostAddress);
+    MapInfo->Mapping = NULL;
+    return Status;
+  }
+
+  *Buffer = (EFI_PHYSICAL_ADDRESS)(UINTN)HostAddress;
+  return EFI_SUCCESS;
+}
+
+/**
+  Unmap and free a buffer allocated by GenetDmaAllocCommonBuffer.
+
+  @param  NumberOfBytes[in]  Size of the buffer.
+  @param  Buffer[in]         Host address of the buffer.
+  @param  MapInfo[in]        Device address and mapping of the buffer.
+
+**/
+STATIC
+VOID
+GenetDmaFreeCommonBuffer (
+  IN     UINTN                 NumberOfBytes,
+  IN     EFI_PHYSICAL_ADDRESS  Buffer,
+  IN OUT GENET_MAP_INFO        *MapInfo
+  )
+{
+  if (MapInfo->Mapping != NULL) {
+    DmaUnmap (MapInfo->Mapping);
+    MapInfo->Mapping = NULL;
+  }
+  DmaFreeBuffer (EFI_SIZE_TO_PAGES (NumberOfBytes), (VOID *)(UINTN)Buffer);
+}
+
+/**
+  Allocate the RX buffers from cached memory and map them once for the device
+  to write into, for the lifetime of the driver.
+
+  The buffers are page aligned and a whole number of cache lines, so DmaLib
+  maps them in place. Receive reads a frame in place after invalidating the
+  cache lines it covers.
 
   @param  Genet[in]  Pointer to GENET_PRIVATE_DATA.
 
-  @retval EFI_SUCCESS           DMA buffers allocated.
-  @retval EFI_OUT_OF_RESOURCES  DMA buffers could not be allocated.
+  @retval EFI_SUCCESS           Buffers allocated and mapped.
+  @retval EFI_OUT_OF_RESOURCES  Buffers could not be allocated.
+  @retval Others                Buffers could not be mapped.
 **/
+STATIC
 EFI_STATUS
-GenetDmaAlloc (
+GenetDmaAllocRxBuffer (
   IN GENET_PRIVATE_DATA   *Genet
   )
 {
   EFI_STATUS              Status;
+  VOID                    *HostAddress;
+  UINTN                   DmaNumberOfBytes;
+
+  HostAddress = AllocatePages (EFI_SIZE_TO_PAGES (GENET_RX_BUFFER_SIZE));
+  if (HostAddress == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
 
-  Genet->RxBuffer = mDmaAddressLimit;
-  Status = gBS->AllocatePages (AllocateMaxAddress, EfiBootServicesData,
-                  EFI_SIZE_TO_PAGES (GENET_MAX_PACKET_SIZE * GENET_DMA_DESC_COUNT),
-                  &Genet->RxBuffer);
+  DmaNumberOfBytes = GENET_RX_BUFFER_SIZE;
+  Status = DmaMap (MapOperationBusMasterWrite, HostAddress,
+             &DmaNumberOfBytes, &Genet->RxBufferMap.PhysAddress,
+             &Genet->RxBufferMap.Mapping);
+  if (!EFI_ERROR (Status) && DmaNumberOfBytes != GENET_RX_BUFFER_SIZE) {
+    DmaUnmap (Genet->RxBufferMap.Mapping);
+    Status = EFI_OUT_OF_RESOURCES;
+  }
   if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR,
-      "%a: Failed to allocate RX buffer: %r\n", __FUNCTION__, Status));
+    FreePages (HostAddress, EFI_SIZE_TO_PAGES (GENET_RX_BUFFER_SIZE));
+    Genet->RxBufferMap.Mapping = NULL;
+    return Status;
   }
-  return Status;
+
+  Genet->RxBuffer = (EFI_PHYSICAL_ADDRESS)(UINTN)HostAddress;
+  return EFI_SUCCESS;
 }
 
 /**
-  Given an RX buffer descriptor index, program the IO address of the buffer into the hardware.
+  Unmap and free the RX buffers allocated by GenetDmaAllocRxBuffer.
 
-  @param  Genet[in]      Pointer to GENET_PRIVATE_DATA.
-  @param  DescIndex[in]  Index of RX buffer descriptor.
+  @param  Genet[in]  Pointer to GENET_PRIVATE_DATA.
 
-  @retval EFI_SUCCESS  DMA buffers allocated.
-  @retval Others       Programmatic errors, as buffers come from DmaAllocateBuffer, and thus
-                       cannot fail DmaMap (for the expected NonCoherentDmaLib).
 **/
-EFI_STATUS
-GenetDmaMapRxDescriptor (
-  IN GENET_PRIVATE_DATA * Genet,
-  IN UINT8                DescIndex
+STATIC
+VOID
+GenetDmaFreeRxBuffer (
+  IN GENET_PRIVATE_DATA   *Genet
   )
 {
-  EFI_STATUS    Status;
-  UINTN         DmaNumberOfBytes;
+  if (Genet->RxBufferMap.Mapping != NULL) {
+    DmaUnmap (Genet->RxBufferMap.Mapping);
+    Genet->RxBufferMap.Mapping = NULL;
+  }
+  FreePages ((VOID *)(UINTN)Genet->RxBuffer,
+    EFI_SIZE_TO_PAGES (GENET_RX_BUFFER_SIZE));
+}
+
+/**
+  Allocate DMA buffers for RX and the TX bounce ring.
 
-  ASSERT (Genet->RxBufferMap[DescIndex].Mapping == NULL);
-  ASSERT (Genet->RxBuffer != 0);
+  Both are mapped once for the lifetime of the driver, so frames can be
+  exchanged with the hardware without any per-frame DmaMap/DmaUnmap.
 
-  DmaNumberOfBytes = GENET_MAX_PACKET_SIZE;
-  Status = DmaMap (MapOperationBusMasterWrite,
-             GENET_RX_BUFFER (Genet, DescIndex),
-             &DmaNumberOfBytes,
-             &Genet->RxBufferMap[DescIndex].PhysAddress,
-             &Genet->RxBufferMap[DescIndex].Mapping);
+  @param  Genet[in]  Pointer to GENET_PRIVATE_DATA.
+
+  @retval EFI_SUCCESS           DMA buffers allocated.
+  @retval EFI_OUT_OF_RESOURCES  DMA buffers could not be allocated.
+  @retval Others                DMA buffers could not be mapped.
+**/
+EFI_STATUS
+GenetDmaAlloc (
+  IN GENET_PRIVATE_DATA   *Genet
+  )
+{
+  EFI_STATUS              Status;
+
+  Status = GenetDmaAllocRxBuffer (Genet);
   if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a: Failed to map RX buffer: %r\n",
-      __FUNCTION__, Status));
+    DEBUG ((DEBUG_ERROR,
+      "%a: Failed to allocate RX buffer: %r\n", __FUNCTION__, Status));
     return Status;
   }
 
-  GenetMmioWrite (Genet, GENET_RX_DESC_ADDRESS_LO (DescIndex),
-    Genet->RxBufferMap[DescIndex].PhysAddress & 0xFFFFFFFF);
-  GenetMmioWrite (Genet, GENET_RX_DESC_ADDRESS_HI (DescIndex),
-    (Genet->RxBufferMap[DescIndex].PhysAddress >> 32) & 0xFFFFFFFF);
-  GenetMmioWrite (Genet, GENET_RX_DESC_STATUS (DescIndex), 0);
+  Status = GenetDmaAllocCommonBuffer (
+             GENET_TX_BOUNCE_SIZE * GENET_DMA_DESC_COUNT,
+             &Genet->TxBounce, &Genet->TxBounceMap);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR,
+      "%a: Failed to allocate TX bounce buffer: %r\n", __FUNCTION__, Status));
+    GenetDmaFreeRxBuffer (Genet);
+    return Status;
+  }
 
   return EFI_SUCCESS;
 }
 
 /**
-  Given an RX buffer descriptor index, undo the DmaMap operation on the buffer.
+  Given an RX buffer descriptor index, program the IO address of the buffer
+  into the hardware and hand the descriptor to the device.
 
   @param  Genet[in]      Pointer to GENET_PRIVATE_DATA.
   @param  DescIndex[in]  Index of RX buffer descriptor.
 
 **/
 VOID
-GenetDmaUnmapRxDescriptor (
+GenetDmaInitRxDescriptor (
   IN GENET_PRIVATE_DATA * Genet,
   IN UINT8                DescIndex
   )
 {
-  if (Genet->RxBufferMap[DescIndex].Mapping != NULL) {
-    DmaUnmap (Genet->RxBufferMap[DescIndex].Mapping);
-    Genet->RxBufferMap[DescIndex].Mapping = NULL;
-  }
+  EFI_PHYSICAL_ADDRESS  PhysAddress;
+
+  ASSERT (Genet->RxBufferMap.Mapping != NULL);
+
+  PhysAddress = Genet->RxBufferMap.PhysAddress +
+                GENET_MAX_PACKET_SIZE * DescIndex;
+
+  GenetMmioWrite (Genet, GENET_RX_DESC_ADDRESS_LO (DescIndex),
+    PhysAddress & 0xFFFFFFFF);
+  GenetMmioWrite (Genet, GENET_RX_DESC_ADDRESS_HI (DescIndex),
+    (PhysAddress >> 32) & 0xFFFFFFFF);
+  GenetMmioWrite (Genet, GENET_RX_DESC_STATUS (DescIndex), 0);
 }
 
 /**
-  Free DMA buffers for RX, undoing GenetDmaAlloc.
+  Free DMA buffers for RX and the TX bounce ring, undoing GenetDmaAlloc.
 
   @param  Genet[in]      Pointer to GENET_PRIVATE_DATA.
-  @param  DescIndex[in]  Index of RX buffer descriptor.
 
 **/
 VOID
@@ -697,18 +820,16 @@ GenetDmaFree (
   IN GENET_PRIVATE_DATA *Genet
   )
 {
-  UINTN Idx;
-
-  for (Idx = 0; Idx < GENET_DMA_DESC_COUNT; Idx++) {
-    GenetDmaUnmapRxDescriptor (Genet, Idx);
-  }
-  gBS->FreePages (Genet->RxBuffer,
-         EFI_SIZE_TO_PAGES (GENET_MAX_PACKET_SIZE * GENET_DMA_DESC_COUNT));
+  GenetDmaFreeCommonBuffer (GENET_TX_BOUNCE_SIZE * GENET_DMA_DESC_COUNT,
+    Genet->TxBounce, &Genet->TxBounceMap);
+  GenetDmaFreeRxBuffer (Genet);
 }
 
 /**
   Queue TX transmission, given a buffer to transmit and a TX descriptor index.
 
+  The frame is handed to the hardware by the following GenetDmaKickTx.
+
   @param  Genet[in]          Pointer to GENET_PRIVATE_DATA.
   @param  DescIndex[in]      TX descriptor index.
   @param  PhysAddr[in]       Buffer to transmit.
@@ -716,7 +837,7 @@ GenetDmaFree (
 
 **/
 VOID
-GenetDmaTriggerTx (
+GenetDmaQueueTx (
   IN GENET_PRIVATE_DATA * Genet,
   IN UINT8                DescIndex,
   IN EFI_PHYSICAL_ADDRESS PhysAddr,
@@ -736,11 +857,57 @@ GenetDmaTriggerTx (
   GenetMmioWrite (Genet, GENET_TX_DESC_ADDRESS_HI (DescIndex),
     (PhysAddr >> 32) & 0xFFFFFFFF);
   GenetMmioWrite (Genet, GENET_TX_DESC_STATUS (DescIndex), DescStatus);
+}
 
+/**
+  Hand the TX descriptors queued by GenetDmaQueueTx to the hardware by
+  writing the TX producer index.
+
+  @param  Genet[in]  Pointer to GENET_PRIVATE_DATA.
+
+**/
+VOID
+GenetDmaKickTx (
+  IN GENET_PRIVATE_DATA *Genet
+  )
+{
   GenetMmioWrite (Genet, GENET_TX_DMA_PROD_INDEX (GENET_DMA_DEFAULT_QUEUE),
     Genet->TxProdIndex);
 }
 
+/**
+  Reclaim all the TX descriptors completed by the hardware, releasing their
+  DMA mappings and queueing their buffers for recycling by GenetTxIntr.
+
+  @param  Genet[in]  Pointer to GENET_PRIVATE_DATA.
+
+**/
+VOID
+GenetTxReclaim (
+  IN GENET_PRIVATE_DATA *Genet
+  )
+{
+  UINT32 Total;
+
+  Total = GenetTxPending (Genet);
+  while (Genet->TxQueued > 0 && Total > 0) {
+    if (Genet->TxBufferMap[Genet->TxNext] != NULL) {
+      DmaUnmap (Genet->TxBufferMap[Genet->TxNext]);
+      Genet->TxBufferMap[Genet->TxNext] = NULL;
+    }
+
+    ASSERT (Genet->TxRecycledCount < GENET_DMA_DESC_COUNT);
+    Genet->TxRecycled[(Genet->TxRecycledNext + Genet->TxRecycledCount) %
+                      GENET_DMA_DESC_COUNT] = Genet->TxBuffer[Genet->TxNext];
+    Genet->TxRecycledCount++;
+
+    Genet->TxQueued--;
+    Genet->TxNext = (Genet->TxNext + 1) % GENET_DMA_DESC_COUNT;
+    Genet->TxConsIndex = (Genet->TxConsIndex + 1) & 0xFFFF;
+    Total--;
+  }
+}
+
 /**
   Simulate a "TX interrupt", return the next (completed) TX buffer to recycle.
 
@@ -754,15 +921,12 @@ GenetTxIntr (
   OUT VOID               **TxBuf
   )
 {
-  UINT32 Total;
+  GenetTxReclaim (Genet);
 
-  Total = GenetTxPending (Genet);
-  if (Genet->TxQueued > 0 && Total > 0) {
-    DmaUnmap (Genet->TxBufferMap[Genet->TxNext]);
-    *TxBuf = Genet->TxBuffer[Genet->TxNext];
-    Genet->TxQueued--;
-    Genet->TxNext = (Genet->TxNext + 1) % GENET_DMA_DESC_COUNT;
-    Genet->TxConsIndex = (Genet->TxConsIndex + 1) & 0xFFFF;
+  if (Genet->TxRecycledCount > 0) {
+    *TxBuf = Genet->TxRecycled[Genet->TxRecycledNext];
+    Genet->TxRecycledNext = (Genet->TxRecycledNext + 1) % GENET_DMA_DESC_COUNT;
+    Genet->TxRecycledCount--;
   } else {
     *TxBuf = NULL;
   }
@@ -776,9 +940,17 @@ GenetRxPending (
   UINT32 ProdIndex;
   UINT32 ConsIndex;
 
-  ConsIndex = GenetMmioRead (Genet,
-                GENET_RX_DMA_CONS_INDEX (GENET_DMA_DEFAULT_QUEUE)) & 0xFFFF;
-  ASSERT (ConsIndex == Genet->RxConsIndex);
+  //
+  // The consumer index is only written back once a batch has been drained,
+  // see GenetRxComplete ().
+  //
+  DEBUG_CODE_BEGIN ();
+  if (Genet->RxBatchRemaining == 0) {
+    ConsIndex = GenetMmioRead (Genet,
+                  GENET_RX_DMA_CONS_INDEX (GENET_DMA_DEFAULT_QUEUE)) & 0xFFFF;
+    ASSERT (ConsIndex == Genet->RxConsIndex);
+  }
+  DEBUG_CODE_END ();
 
   ProdIndex = GenetMmioRead (Genet,
                 GENET_RX_DMA_PROD_INDEX (GENET_DMA_DEFAULT_QUEUE)) & 0xFFFF;
@@ -798,20 +970,38 @@ GenetTxPending (
   return (ConsIndex - Genet->TxConsIndex) & 0xFFFF;
 }
 
+/**
+  Return the RX buffer returned by GenetRxIntr to the hardware.
+
+  The hardware consumer index is only updated once all the frames of the
+  current batch have been consumed, so the descriptors are returned to the
+  device in bulk.
+
+  @param  Genet[in]  Pointer to GENET_PRIVATE_DATA.
+
+**/
 VOID
 GenetRxComplete (
   IN GENET_PRIVATE_DATA *Genet
   )
 {
+  ASSERT (Genet->RxBatchRemaining > 0);
+
   Genet->RxConsIndex = (Genet->RxConsIndex + 1) & 0xFFFF;
-  GenetMmioWrite (Genet, GENET_RX_DMA_CONS_INDEX (GENET_DMA_DEFAULT_QUEUE),
-                  Genet->RxConsIndex);
+  Genet->RxBatchRemaining--;
+  if (Genet->RxBatchRemaining == 0) {
+    GenetMmioWrite (Genet, GENET_RX_DMA_CONS_INDEX (GENET_DMA_DEFAULT_QUEUE),
+                    Genet->RxConsIndex);
+  }
 }
 
 /**
   Simulate an "RX interrupt", returning the index of a completed RX buffer and
   corresponding frame length.
 
+  The producer index is only sampled when the previous batch of received
+  frames has been drained.
+
   @param  Genet[in]         Pointer to GENET_PRIVATE_DATA.
   @param  DescIndex[out]    Location to store completed RX buffer index.
   @param  FrameLength[out]  Location to store frame length.
@@ -831,7 +1021,13 @@ GenetRxIntr (
   UINT32        Total;
   UINT32        DescStatus;
 
-  Total = GenetRxPending (Genet);
+  if (Genet->RxBatchRemaining == 0) {
+    Total = GenetRxPending (Genet);
+    Genet->RxBatchRemaining = (UINT16)Total;
+  } else {
+    Total = Genet->RxBatchRemaining;
+  }
+
   if (Total > 0) {
     *DescIndex = Genet->RxConsIndex % GENET_DMA_DESC_COUNT;
     DescStatus = GenetMmioRead (Genet, GENET_RX_DESC_STATUS (*DescIndex));
@@ -9,10 +9,13 @@
 **/
 
 #include <Uefi.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
 #include <Library/DebugLib.h>
 #include <Library/DmaLib.h>
 #include <Library/NetLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Protocol/SimpleNetwork.h>
 
@@ -156,12 +159,9 @@ GenetSimpleNetworkInitialize (
 
   GenetDmaInitRings (Genet);
 
-  // Map RX buffers
+  // Hand the RX buffers to the hardware
   for (Idx = 0; Idx < GENET_DMA_DESC_COUNT; Idx++) {
-    Status = GenetDmaMapRxDescriptor (Genet, Idx);
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
+    GenetDmaInitRxDescriptor (Genet, Idx);
   }
 
   GenetEnableTxRx (Genet);
@@ -239,7 +239,6 @@ GenetSimpleNetworkShutdown (
   )
 {
   GENET_PRIVATE_DATA  *Genet;
-  UINTN               Idx;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -255,10 +254,6 @@ GenetSimpleNetworkShutdown (
 
   GenetDisableTxRx (Genet);
 
-  for (Idx = 0; Idx < GENET_DMA_DESC_COUNT; Idx++) {
-    GenetDmaUnmapRxDescriptor (Genet, Idx);
-  }
-
   Genet->SnpMode.State = EfiSimpleNetworkStarted;
 
   return EFI_SUCCESS;
@@ -395,9 +390,9 @@ GenetSimpleNetworkStationAddress (
 
   @retval EFI_SUCCESS           The statistics were collected from the network interface.
   @retval EFI_NOT_STARTED       The network interface has not been started.
-  @retval EFI_BUFFER_TOO_SMALL  The Statistics buffer was too small. The current buffer
-                                size needed to hold the statistics is returned in
-                                StatisticsSize.
+  @retval EFI_BUFFER_TOO_SMALL  The Statistics buffer was too small. The part that fits
+                                is returned, and the size needed to hold the statistics
+                                is returned in StatisticsSize.
   @retval EFI_INVALID_PARAMETER One or more of the parameters has an unsupported value.
   @retval EFI_DEVICE_ERROR      The network inteface is not in the right (initialized) state.
   @retval EFI_UNSUPPORTED       This function is not supported by the network interface.
@@ -413,7 +408,43 @@ GenetSimpleNetworkStatistics (
   OUT EFI_NETWORK_STATISTICS     *StatisticsTable OPTIONAL
   )
 {
-  return EFI_UNSUPPORTED;
+  GENET_PRIVATE_DATA  *Genet;
+  EFI_STATUS          Status;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Genet = GENET_PRIVATE_DATA_FROM_SNP_THIS (This);
+  if (Genet->SnpMode.State == EfiSimpleNetworkStopped) {
+    return EFI_NOT_STARTED;
+  }
+  if (Genet->SnpMode.State != EfiSimpleNetworkInitialized) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (StatisticsSize == NULL && StatisticsTable != NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = EFI_SUCCESS;
+  if (StatisticsSize != NULL) {
+    if (StatisticsTable != NULL) {
+      CopyMem (StatisticsTable, &Genet->Stats,
+        MIN (*StatisticsSize, sizeof (EFI_NETWORK_STATISTICS)));
+    }
+    if (*StatisticsSize < sizeof (EFI_NETWORK_STATISTICS)) {
+      Status = EFI_BUFFER_TOO_SMALL;
+    }
+    *StatisticsSize = sizeof (EFI_NETWORK_STATISTICS);
+  }
+
+  if (Reset) {
+    ZeroMem (&Genet->Stats, sizeof (EFI_NETWORK_STATISTICS));
+    Genet->RxTicks = 0;
+  }
+
+  return Status;
 }
 
 /**
@@ -514,7 +545,7 @@ GenetSimpleNetworkGetStatus (
     if (GenetRxPending (Genet) > 0) {
       *InterruptStatus |= EFI_SIMPLE_NETWORK_RECEIVE_INTERRUPT;
     }
-    if (GenetTxPending (Genet) > 0) {
+    if (GenetTxPending (Genet) > 0 || Genet->TxRecycledCount > 0) {
       *InterruptStatus |= EFI_SIMPLE_NETWORK_TRANSMIT_INTERRUPT;
     }
   }
@@ -642,7 +673,14 @@ GenetSimpleNetworkTransmit (
     return EFI_ACCESS_DENIED;
   }
 
-  if (Genet->TxQueued == GENET_DMA_DESC_COUNT - 1) {
+  //
+  // Reclaim completed descriptors inline rather than waiting for the caller
+  // to collect them through GetStatus (). The buffers of reclaimed frames
+  // are kept until they have been returned to the caller.
+  //
+  GenetTxReclaim (Genet);
+
+  if (Genet->TxQueued + Genet->TxRecycledCount >= GENET_DMA_DESC_COUNT - 1) {
     EfiReleaseLock (&Genet->Lock);
 
     DEBUG ((DEBUG_ERROR, "%a: Queue full\n", __FUNCTION__));
@@ -660,22 +698,41 @@ GenetSimpleNetworkTransmit (
 
   Genet->TxBuffer[Desc] = Frame;
 
-  DmaNumberOfBytes = BufferSize;
-  Status = DmaMap (MapOperationBusMasterRead,
-                   (VOID *)(UINTN)Frame,
-                   &DmaNumberOfBytes,
-                   &DmaDeviceAddress,
-                   &Genet->TxBufferMap[Desc]);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a: DmaMap failed: %r\n", __FUNCTION__, Status));
-    EfiReleaseLock (&Genet->Lock);
-    return Status;
+  if (BufferSize <= GENET_TX_BOUNCE_SIZE) {
+    //
+    // Small frames are copied into the pre-mapped bounce slot of the
+    // descriptor, which is cheaper than mapping them.
+    //
+    CopyMem (GENET_TX_BOUNCE_BUFFER (Genet, Desc), Frame, BufferSize);
+    DmaDeviceAddress = Genet->TxBounceMap.PhysAddress +
+                       GENET_TX_BOUNCE_SIZE * Desc;
+    DmaNumberOfBytes = BufferSize;
+    Genet->TxBufferMap[Desc] = NULL;
+  } else {
+    DmaNumberOfBytes = BufferSize;
+    Status = DmaMap (MapOperationBusMasterRead,
+                     (VOID *)(UINTN)Frame,
+                     &DmaNumberOfBytes,
+                     &DmaDeviceAddress,
+                     &Genet->TxBufferMap[Desc]);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: DmaMap failed: %r\n", __FUNCTION__, Status));
+      Genet->TxBufferMap[Desc] = NULL;
+      EfiReleaseLock (&Genet->Lock);
+      return Status;
+    }
   }
 
   Genet->TxProdIndex = (Genet->TxProdIndex + 1) & 0xFFFF;
-  GenetDmaTriggerTx (Genet, Desc, DmaDeviceAddress, DmaNumberOfBytes);
+  GenetDmaQueueTx (Genet, Desc, DmaDeviceAddress, DmaNumberOfBytes);
   Genet->TxQueued++;
 
+  Genet->Stats.TxTotalFrames++;
+  Genet->Stats.TxGoodFrames++;
+  Genet->Stats.TxTotalBytes += BufferSize;
+
+  GenetDmaKickTx (Genet);
+
   EfiReleaseLock (&Genet->Lock);
 
   return EFI_SUCCESS;
@@ -730,6 +787,7 @@ GenetSimpleNetworkReceive (
   UINT8               DescIndex;
   UINT8               *Frame;
   UINTN               FrameLength;
+  UINT64              StartTicks;
 
   if (This == NULL || Buffer == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: Invalid parameter (missing handle or buffer)\n",
@@ -757,11 +815,17 @@ GenetSimpleNetworkReceive (
     return Status;
   }
 
-  ASSERT (Genet->RxBufferMap[DescIndex].Mapping != NULL);
-
-  GenetDmaUnmapRxDescriptor (Genet, DescIndex);
+  StartTicks = GetPerformanceCounter ();
 
+  //
+  // The RX buffers stay mapped for the lifetime of the driver. Drop any stale
+  // cache lines of this frame and read it in place.
+  //
   Frame = GENET_RX_BUFFER (Genet, DescIndex);
+  InvalidateDataCacheRange (Frame, FrameLength);
+
+  Genet->Stats.RxTotalFrames++;
+  Genet->Stats.RxTotalBytes += FrameLength;
 
   if (FrameLength > 2 + Genet->SnpMode.MediaHeaderSize) {
     // Received frame has 2 bytes of padding at the start
@@ -772,6 +836,7 @@ GenetSimpleNetworkReceive (
       DEBUG ((DEBUG_ERROR,
         "%a: Buffer size (0x%X) is too small for frame (0x%X)\n",
         __FUNCTION__, *BufferSize, FrameLength));
+      Genet->Stats.RxDroppedFrames++;
       Status = EFI_BUFFER_TOO_SMALL;
       goto out;
     }
@@ -792,21 +857,21 @@ GenetSimpleNetworkReceive (
     CopyMem (Buffer, Frame, FrameLength);
     *BufferSize = FrameLength;
 
+    Genet->Stats.RxGoodFrames++;
     Status = EFI_SUCCESS;
   } else {
     DEBUG ((DEBUG_ERROR, "%a: Short packet (FrameLength 0x%X)",
       __FUNCTION__, FrameLength));
+    Genet->Stats.RxUndersizeFrames++;
     Status = EFI_NOT_READY;
   }
 
 out:
-  Status = GenetDmaMapRxDescriptor (Genet, DescIndex);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a: Failed to remap RX descriptor!\n", __FUNCTION__));
-  }
-
+  GenetDmaInitRxDescriptor (Genet, DescIndex);
   GenetRxComplete (Genet);
 
+  Genet->RxTicks += GetPerformanceCounter () - StartTicks;
+
   EfiReleaseLock (&Genet->Lock);
   return Status;
 }
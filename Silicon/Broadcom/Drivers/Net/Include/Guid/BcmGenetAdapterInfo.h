@@ -0,0 +1,29 @@
+/** @file
+
+  Adapter information type reporting the receive path cost of the Broadcom
+  GENET driver.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef BCM_GENET_ADAPTER_INFO_H
+#define BCM_GENET_ADAPTER_INFO_H
+
+#include <Uefi/UefiBaseType.h>
+
+#define BCM_GENET_ADAPTER_INFO_RX_PERFORMANCE_GUID \
+  {0x8224f085, 0x22f6, 0x4bd6, {0x8d, 0xc9, 0x23, 0xcd, 0xb7, 0xdd, 0xef, 0x0b}}
+
+//
+// Counters since the SNP statistics were last reset.
+//
+typedef struct {
+  UINT64                    RxFrames;         ///< Frames returned by Receive ()
+  UINT64                    RxTimeNs;         ///< CPU time spent on those frames
+  UINT64                    RxTimePerFrameNs; ///< RxTimeNs / RxFrames, 0 if no frame
+} BCM_GENET_ADAPTER_INFO_RX_PERFORMANCE;
+
+extern EFI_GUID gBcmGenetAdapterInfoRxPerformanceGuid;
+
+#endif
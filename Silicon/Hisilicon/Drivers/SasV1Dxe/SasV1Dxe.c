@@ -181,6 +181,16 @@
 #define SENSE_DATA_PRES             26
 
 #define SGE_LIMIT 0x10000
+
+// Period of the completion queue poll while async requests are in flight,
+// in 100ns units
+#define SAS_POLL_PERIOD             10000
+// Interval and total time spent re-polling a disk which is not ready yet,
+// some disks need a long time to spin up, refer drivers/scsi/sd.c
+#define SAS_READY_POLL_US           10000
+#define SAS_READY_TIMEOUT_US        1000000
+#define SAS_READY_RETRIES           (SAS_READY_TIMEOUT_US / SAS_READY_POLL_US)
+#define SAS_READY_POLL_TICKS        (SAS_READY_POLL_US * 10 / SAS_POLL_PERIOD)
 #define upper_32_bits(n) ((UINT32)(((n) >> 16) >> 16))
 #define lower_32_bits(n) ((UINT32)(n))
 #define MAX_TARGET_ID 4
@@ -255,8 +265,26 @@ struct hisi_sas_sts {
 UINT32 status[260];
 };
 
+struct hisi_sas_async_req;
+
 struct hisi_sas_slot {
     BOOLEAN used;
+    BOOLEAN retry;
+    int queue;
+    EFI_STATUS Status;
+    EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET *Packet;
+    VOID *BufferMap;
+    struct hisi_sas_async_req *req;
+};
+
+// Request issued with an event, completed from the poll timer
+struct hisi_sas_async_req {
+    LIST_ENTRY Link;
+    EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET *Packet;
+    EFI_EVENT Event;
+    struct hisi_sas_slot *slot;
+    UINT32 retries;
+    UINT32 delay;
 };
 
 struct hisi_hba {
@@ -269,6 +297,7 @@ struct hisi_hba {
     struct hisi_sas_itct         *itct;
     struct hisi_sas_breakpoint   *breakpoint;
     struct hisi_sas_slot         *slots;
+    LIST_ENTRY                   async_reqs;
     UINT32 base;
     int queue;
     int port_id;
@@ -298,7 +327,9 @@ typedef struct {
 
 STATIC EFI_STATUS prepare_cmd (
   struct hisi_hba *hba,
-  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet,
+  struct hisi_sas_async_req                     *req,
+  struct hisi_sas_slot                          **slot_out
   )
 {
   struct hisi_sas_slot *slot;
@@ -312,7 +343,6 @@ STATIC EFI_STATUS prepare_cmd (
   int queue = hba->queue;
   UINT32 r, w = 0, slot_idx = 0;
   UINT32 base = hba->base;
-  UINT8 *p;
   EFI_PHYSICAL_ADDRESS  BufferAddress;
   EFI_STATUS            Status = EFI_SUCCESS;
   VOID                  *BufferMap = NULL;
@@ -344,9 +374,6 @@ STATIC EFI_STATUS prepare_cmd (
   if (SensePtr)
     ZeroMem (SensePtr, sizeof (EFI_SCSI_SENSE_DATA));
 
-  slot->used = TRUE;
-  hba->queue = (queue + 1) % QUEUE_CNT;
-
   // Only consider ssp
   hdr->dw0 = (1 << CMD_HDR_RESP_REPORT_OFF) |
        (0x2 << CMD_HDR_TLR_CTRL_OFF) |
@@ -410,58 +437,209 @@ STATIC EFI_STATUS prepare_cmd (
     hdr->sg_len = i << CMD_HDR_DATA_SGL_LEN_OFF;
   }
 
+  slot->used = TRUE;
+  slot->queue = queue;
+  slot->Packet = Packet;
+  slot->BufferMap = BufferMap;
+  slot->req = req;
+  hba->queue = (queue + 1) % QUEUE_CNT;
+
   // Ensure descriptor effective before start dma
   MemoryFence();
 
   // Start dma
   WRITE_REG32(base, DLVRY_Q_0_WR_PTR + queue * 0x14, ++w % QUEUE_SLOTS);
 
-  // Wait for dma complete
-  while (slot->used) {
-    if (READ_REG32(base, OQ_INT_SRC) & BIT(queue)) {
-      struct hisi_sas_complete_hdr *complete_hdr;
-      UINT32 data, rd;
-      rd = READ_REG32(base, COMPL_Q_0_RD_PTR + (0x14 * queue));
-
-      complete_hdr = &hba->complete_hdr[queue][rd];
-      data = complete_hdr->data;
-
-      // Check whether dma transfer error
-      if ((data & CMPLT_HDR_ERR_RCRD_XFRD_MSK) &&
-        !(data & CMPLT_HDR_RSPNS_XFRD_MSK)) {
-        DEBUG ((EFI_D_VERBOSE, "sas retry data=0x%x\n", data));
-        DEBUG ((EFI_D_VERBOSE, "sts[0]=0x%x\n", sts->status[0]));
-        DEBUG ((EFI_D_VERBOSE, "sts[1]=0x%x\n", sts->status[1]));
-        DEBUG ((EFI_D_VERBOSE, "sts[2]=0x%x\n", sts->status[2]));
-        Status = EFI_NOT_READY;
-        // wait 1 second and retry, some disk need long time to be ready
-        // and ScsiDisk treat retry over 3 times as error
-        MicroSecondDelay(1000000);
-      }
-       // Update read point
-       WRITE_REG32(base, COMPL_Q_0_RD_PTR + (0x14 * queue), w);
-       // Clear int
-       WRITE_REG32(base, OQ_INT_SRC, BIT(queue));
-       slot->used = FALSE;
-       break;
-    }
-    // Wait for status change in polling
-    NanoSecondDelay (100);
+  if (slot_out)
+    *slot_out = slot;
+
+  return EFI_SUCCESS;
+}
+
+// Complete an async request, or schedule it for another attempt when the
+// disk is not ready yet
+STATIC VOID hisi_sas_async_done (
+  struct hisi_hba           *hba,
+  struct hisi_sas_async_req *req,
+  EFI_STATUS                Status,
+  BOOLEAN                   retry
+  )
+{
+  req->slot = NULL;
+
+  if (retry && req->retries > 0) {
+    req->retries--;
+    req->delay = SAS_READY_POLL_TICKS;
+    return;
   }
 
-  if (BufferMap)
-       DmaUnmap (BufferMap);
+  RemoveEntryList (&req->Link);
+  req->Packet->HostAdapterStatus = EFI_ERROR (Status) ?
+    EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER :
+    EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OK;
+  gBS->SignalEvent (req->Event);
+  FreePool (req);
+}
+
+STATIC VOID hisi_sas_slot_complete (
+  struct hisi_hba       *hba,
+  struct hisi_sas_slot  *slot,
+  UINT32                data
+  )
+{
+  EFI_SCSI_SENSE_DATA *SensePtr = slot->Packet->SenseData;
+  struct hisi_sas_sts *sts;
+  UINT32 slot_idx = slot - hba->slots;
+  BOOLEAN retry = FALSE;
+  UINT8 *p;
+
+  sts = &hba->status_buf[slot->queue][slot_idx % QUEUE_SLOTS];
+  slot->Status = EFI_SUCCESS;
+
+  // Check whether dma transfer error
+  if ((data & CMPLT_HDR_ERR_RCRD_XFRD_MSK) &&
+    !(data & CMPLT_HDR_RSPNS_XFRD_MSK)) {
+    DEBUG ((EFI_D_VERBOSE, "sas retry data=0x%x\n", data));
+    DEBUG ((EFI_D_VERBOSE, "sts[0]=0x%x\n", sts->status[0]));
+    DEBUG ((EFI_D_VERBOSE, "sts[1]=0x%x\n", sts->status[1]));
+    DEBUG ((EFI_D_VERBOSE, "sts[2]=0x%x\n", sts->status[2]));
+    slot->Status = EFI_NOT_READY;
+    retry = TRUE;
+  }
+
+  if (slot->BufferMap)
+    DmaUnmap (slot->BufferMap);
 
   p = (UINT8 *)&sts->status[0];
   if (p[SENSE_DATA_PRES]) {
     // Disk not ready normal return for ScsiDiskTestUnitReady do next try
-    SensePtr->Sense_Key = EFI_SCSI_SK_NOT_READY;
-    SensePtr->Addnl_Sense_Code = EFI_SCSI_ASC_NOT_READY;
-    SensePtr->Addnl_Sense_Code_Qualifier = EFI_SCSI_ASCQ_IN_PROGRESS;
-    // wait 1 second for disk spin up, refer drivers/scsi/sd.c
-    MicroSecondDelay(1000000);
+    if (SensePtr) {
+      SensePtr->Sense_Key = EFI_SCSI_SK_NOT_READY;
+      SensePtr->Addnl_Sense_Code = EFI_SCSI_ASC_NOT_READY;
+      SensePtr->Addnl_Sense_Code_Qualifier = EFI_SCSI_ASCQ_IN_PROGRESS;
+    }
+    retry = TRUE;
+  }
+
+  slot->retry = retry;
+  slot->used = FALSE;
+
+  if (slot->req)
+    hisi_sas_async_done (hba, slot->req, slot->Status, retry);
+}
+
+// Reap all the completion queue entries posted by the controller on a queue
+STATIC VOID hisi_sas_drain_cq (struct hisi_hba *hba, int queue)
+{
+  struct hisi_sas_slot *slot;
+  UINT32 data, iptt, rd, wr;
+  UINT32 base = hba->base;
+
+  // Clear int before reaping, so entries posted meanwhile raise it again
+  WRITE_REG32(base, OQ_INT_SRC, BIT(queue));
+
+  rd = READ_REG32(base, COMPL_Q_0_RD_PTR + (0x14 * queue));
+  wr = READ_REG32(base, COMPL_Q_0_WR_PTR + (0x14 * queue));
+
+  while (rd != wr) {
+    data = hba->complete_hdr[queue][rd].data;
+    iptt = (data & CMPLT_HDR_IPTT_MSK) >> CMPLT_HDR_IPTT_OFF;
+    if (iptt < SLOT_ENTRIES) {
+      slot = &hba->slots[iptt];
+      if (slot->used)
+        hisi_sas_slot_complete (hba, slot, data);
+    }
+    rd = (rd + 1) % QUEUE_SLOTS;
+  }
+
+  // Update read point
+  WRITE_REG32(base, COMPL_Q_0_RD_PTR + (0x14 * queue), rd);
+}
+
+STATIC VOID hisi_sas_drain_all (struct hisi_hba *hba)
+{
+  UINT32 pending;
+  int queue;
+
+  pending = READ_REG32(hba->base, OQ_INT_SRC);
+  for (queue = 0; queue < QUEUE_CNT && pending; queue++) {
+    if (pending & BIT(queue)) {
+      hisi_sas_drain_cq (hba, queue);
+      pending &= ~BIT(queue);
+    }
+  }
+}
+
+// Periodic poll of the completion queues while async requests are in flight
+STATIC VOID EFIAPI hisi_sas_async_poll (
+  IN EFI_EVENT Event,
+  IN VOID      *Context
+  )
+{
+  SAS_V1_INFO *SasV1Info = Context;
+  struct hisi_hba *hba = SasV1Info->hba;
+  struct hisi_sas_async_req *req;
+  LIST_ENTRY *Link;
+  LIST_ENTRY *Next;
+
+  hisi_sas_drain_all (hba);
+
+  // Repost the requests whose disk was not ready on the last attempt
+  for (Link = GetFirstNode (&hba->async_reqs);
+       !IsNull (&hba->async_reqs, Link);
+       Link = Next) {
+    Next = GetNextNode (&hba->async_reqs, Link);
+    req = BASE_CR (Link, struct hisi_sas_async_req, Link);
+    if (req->slot != NULL) {
+      continue;
+    }
+    if (req->delay > 0) {
+      req->delay--;
+      continue;
+    }
+    if (EFI_ERROR (prepare_cmd (hba, req->Packet, req, &req->slot))) {
+      req->slot = NULL;
+    }
+  }
+
+  if (IsListEmpty (&hba->async_reqs)) {
+    gBS->SetTimer (SasV1Info->TimerEvent, TimerCancel, 0);
+  }
+}
+
+// Fail every request still owned by the controller, the poll timer must be
+// closed already
+STATIC VOID hisi_sas_abort_all (struct hisi_hba *hba)
+{
+  struct hisi_sas_slot *slot;
+  struct hisi_sas_async_req *req;
+  int i;
+
+  // Stop fetching commands, give the ones in flight a moment to finish and
+  // reap them
+  WRITE_REG32(hba->base, DLVRY_QUEUE_ENABLE, 0);
+  MicroSecondDelay (SAS_READY_POLL_US);
+  hisi_sas_drain_all (hba);
+
+  for (i = 0; i < SLOT_ENTRIES; i++) {
+    slot = &hba->slots[i];
+    if (!slot->used) {
+      continue;
+    }
+    if (slot->BufferMap) {
+      DmaUnmap (slot->BufferMap);
+    }
+    slot->used = FALSE;
+    if (slot->req) {
+      slot->req->slot = NULL;
+    }
+  }
+
+  // Complete the async requests, including those waiting for a retry
+  while (!IsListEmpty (&hba->async_reqs)) {
+    req = BASE_CR (GetFirstNode (&hba->async_reqs), struct hisi_sas_async_req, Link);
+    hisi_sas_async_done (hba, req, EFI_ABORTED, FALSE);
   }
-  return Status;
 }
 
 STATIC VOID hisi_sas_v1_init(struct hisi_hba *hba, PLATFORM_SAS_PROTOCOL *plat)
@@ -671,8 +849,74 @@ SasV1ExtScsiPassThruFunction (
 {
   SAS_V1_INFO *SasV1Info = SAS_FROM_PASS_THRU(This);
   struct hisi_hba *hba = SasV1Info->hba;
+  struct hisi_sas_async_req *req;
+  struct hisi_sas_slot *slot;
+  EFI_STATUS Status;
+  EFI_TPL OldTpl;
+  UINT32 retries;
+  BOOLEAN done, retry;
+
+  if (Event != NULL) {
+    req = AllocateZeroPool (sizeof (struct hisi_sas_async_req));
+    if (req == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    req->Packet = Packet;
+    req->Event = Event;
+    req->retries = SAS_READY_RETRIES;
 
-  return prepare_cmd(hba, Packet);
+    // The poll timer reaps completions too, keep it out while queues change
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Status = prepare_cmd(hba, Packet, req, &req->slot);
+    if (EFI_ERROR (Status)) {
+      FreePool (req);
+    } else {
+      if (IsListEmpty (&hba->async_reqs)) {
+        gBS->SetTimer (SasV1Info->TimerEvent, TimerPeriodic, SAS_POLL_PERIOD);
+      }
+      InsertTailList (&hba->async_reqs, &req->Link);
+    }
+    gBS->RestoreTPL (OldTpl);
+    return Status;
+  }
+
+  // Only the queue and slot accesses run at TPL_NOTIFY, the waits below stay
+  // at the caller's TPL
+  for (retries = SAS_READY_RETRIES; ; retries--) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Status = prepare_cmd(hba, Packet, NULL, &slot);
+    gBS->RestoreTPL (OldTpl);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    // Wait for dma complete, the poll timer may reap it as well
+    for (;;) {
+      OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+      if (slot->used && (READ_REG32(hba->base, OQ_INT_SRC) & BIT(slot->queue))) {
+        hisi_sas_drain_cq (hba, slot->queue);
+      }
+      done = !slot->used;
+      Status = slot->Status;
+      retry = slot->retry;
+      gBS->RestoreTPL (OldTpl);
+      if (done) {
+        break;
+      }
+      // Wait for status change in polling
+      NanoSecondDelay (100);
+    }
+
+    if (!retry || retries == 0) {
+      break;
+    }
+
+    // Re-poll until the disk becomes ready instead of sleeping a full
+    // second, ScsiDisk treat retry over 3 times as error
+    MicroSecondDelay (SAS_READY_POLL_US);
+  }
+
+  return Status;
 }
 
 STATIC
@@ -874,6 +1118,16 @@ SasDriverBindingStart (
   ASSERT (SasV1Info->hba);
   hba = SasV1Info->hba;
   base = hba->base = plat->BaseAddr;
+  InitializeListHead (&hba->async_reqs);
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  hisi_sas_async_poll,
+                  SasV1Info,
+                  &SasV1Info->TimerEvent
+                  );
+  ASSERT_EFI_ERROR (Status);
 
   sas_init(SasV1Info, plat);
 
@@ -916,7 +1170,8 @@ SasDriverBindingStart (
 
   CopyMem (&SasV1Info->ExtScsiPassThru, &SasV1ExtScsiPassThruProtocolTemplate, sizeof (EFI_EXT_SCSI_PASS_THRU_PROTOCOL));
   SasV1Info->ExtScsiPassThruMode.AdapterId = 2;
-  SasV1Info->ExtScsiPassThruMode.Attributes = EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_PHYSICAL | EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL;
+  SasV1Info->ExtScsiPassThruMode.Attributes = EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_PHYSICAL | EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL |
+                                              EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_NONBLOCKIO;
   SasV1Info->ExtScsiPassThruMode.IoAlign  = 64; //cache line align
   SasV1Info->ExtScsiPassThru.Mode = &SasV1Info->ExtScsiPassThruMode;
 
@@ -988,6 +1243,9 @@ SasDriverBindingStop (
 
     gBS->CloseEvent (SasV1Info->TimerEvent);
 
+    // Nothing may still point into the buffers freed below
+    hisi_sas_abort_all (SasV1Info->hba);
+
     for (i = 0; i < QUEUE_CNT; i++) {
       s = sizeof(struct hisi_sas_cmd_hdr) * QUEUE_SLOTS;
       DmaFreeBuffer(EFI_SIZE_TO_PAGES (s), (VOID *)SasV1Info->hba->cmd_hdr[i]);
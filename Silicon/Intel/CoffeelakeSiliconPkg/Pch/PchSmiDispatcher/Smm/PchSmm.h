@@ -413,6 +413,11 @@ VOID
 struct _DATABASE_RECORD {
   UINT32                        Signature;
   LIST_ENTRY                    Link;
+  ///
+  /// Link into the dispatch index bucket selected by IndexBucket
+  ///
+  LIST_ENTRY                    IndexLink;
+  UINTN                         IndexBucket;
   BOOLEAN                       Processed;
   ///
   /// Status and Enable bit description
@@ -458,6 +463,7 @@ struct _DATABASE_RECORD {
 
 #define DATABASE_RECORD_FROM_LINK(_record)  CR (_record, DATABASE_RECORD, Link, DATABASE_RECORD_SIGNATURE)
 #define DATABASE_RECORD_FROM_CHILDCONTEXT(_record)  CR (_record, DATABASE_RECORD, ChildContext, DATABASE_RECORD_SIGNATURE)
+#define DATABASE_RECORD_FROM_INDEX_LINK(_record)  CR (_record, DATABASE_RECORD, IndexLink, DATABASE_RECORD_SIGNATURE)
 
 ///
 /// HOOKING INTO THE ARCHITECTURE
@@ -581,6 +587,30 @@ typedef struct {
   PROTOCOL_SIGNATURE \
   )
 
+///
+/// DISPATCH INDEX
+/// Every record in CallbackDataBase is also linked into one bucket of the dispatch index.
+/// Buckets 0..31 hold the records gated by the corresponding PMC SMI_STS bit, so on an SMI
+/// only the buckets whose status bit is set are visited. Records which are not gated by an
+/// SMI_STS bit live in the ungated bucket, which is scanned on every SMI.
+///
+#define PCH_SMM_INDEX_SMI_STS_BUCKETS   32
+#define PCH_SMM_INDEX_UNGATED_BUCKET    PCH_SMM_INDEX_SMI_STS_BUCKETS
+#define PCH_SMM_INDEX_BUCKET_NUM        (PCH_SMM_INDEX_SMI_STS_BUCKETS + 1)
+
+///
+/// SMI handler latency counters, in TSC ticks.
+/// Updated by PchSmmCoreDispatcher on every SMI it handles.
+///
+typedef struct {
+  UINT64                      SmiCount;         ///< Number of SMIs seen by the dispatcher
+  UINT64                      DispatchCount;    ///< Number of active sources dispatched
+  UINT64                      RecordsChecked;   ///< Number of SourceIsActive checks performed
+  UINT64                      TotalTicks;       ///< Accumulated dispatcher time
+  UINT64                      MaxTicks;         ///< Longest single dispatcher invocation
+  UINT64                      LastTicks;        ///< Most recent dispatcher invocation
+} PCH_SMM_DISPATCH_STATS;
+
 ///
 /// Create private data for the protocols that we'll publish
 ///
@@ -589,12 +619,41 @@ typedef struct {
   EFI_HANDLE                  SmiHandle;
   EFI_HANDLE                  InstallMultProtHandle;
   PCH_SMM_QUALIFIED_PROTOCOL  Protocols[PCH_SMM_PROTOCOL_TYPE_MAX];
+  ///
+  /// Dispatch index, see PCH_SMM_INDEX_BUCKET_NUM
+  ///
+  LIST_ENTRY                  DispatchIndex[PCH_SMM_INDEX_BUCKET_NUM];
+  ///
+  /// Bitmap of SMI_STS buckets which have at least one record
+  ///
+  UINT32                      IndexedSmiStsMask;
+  PCH_SMM_DISPATCH_STATS      DispatchStats;
 } PRIVATE_DATA;
 
 extern PRIVATE_DATA           mPrivateData;
 extern UINT16                 mAcpiBaseAddr;
 extern UINT16                 mTcoBaseAddr;
 
+/**
+  Link a database record into CallbackDataBase and into the dispatch index.
+
+  @param[in] Record               Record to be linked, allocated from SMRAM.
+**/
+VOID
+SmmCoreLinkRecord (
+  IN DATABASE_RECORD                    *Record
+  );
+
+/**
+  Unlink a database record from CallbackDataBase and from the dispatch index.
+
+  @param[in] Record               Record to be unlinked.
+**/
+VOID
+SmmCoreUnlinkRecord (
+  IN DATABASE_RECORD                    *Record
+  );
+
 /**
   The internal function used to create and insert a database record
 
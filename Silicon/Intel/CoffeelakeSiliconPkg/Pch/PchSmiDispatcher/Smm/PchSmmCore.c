@@ -219,6 +219,7 @@ InitializePchSmmDispatcher (
 {
   EFI_STATUS           Status;
   VOID                 *SmmReadyToLockRegistration;
+  UINTN                Index;
 
   //
   // Access ACPI Base Addresses Register
@@ -244,6 +245,9 @@ InitializePchSmmDispatcher (
   // Initialize Callback DataBase
   //
   InitializeListHead (&mPrivateData.CallbackDataBase);
+  for (Index = 0; Index < PCH_SMM_INDEX_BUCKET_NUM; Index++) {
+    InitializeListHead (&mPrivateData.DispatchIndex[Index]);
+  }
 
   //
   // Enable SMIs on the PCH now that we have a callback
@@ -309,7 +313,7 @@ SmmCoreInsertRecord (
   //
   // After ensuring the source of event is not null, we will insert the record into the database
   //
-  InsertTailList (&mPrivateData.CallbackDataBase, &Record->Link);
+  SmmCoreLinkRecord (Record);
 
   //
   // Child's handle will be the address linked list link in the record
@@ -570,7 +574,7 @@ PchSmmCoreUnRegister (
     return EFI_INVALID_PARAMETER;
   }
 
-  RemoveEntryList (&RecordToDelete->Link);
+  SmmCoreUnlinkRecord (RecordToDelete);
 
   //
   // Loop through all the souces in record linked list to see if any source enable is equal.
@@ -603,6 +607,120 @@ PchSmmCoreUnRegister (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the dispatch index bucket for a source description.
+  Sources gated by a PMC SMI_STS bit use that bit as the bucket, others use the ungated bucket.
+
+  @param[in] SrcDesc              Pointer to the PCH SMI source description
+
+  @retval                         Bucket number in mPrivateData.DispatchIndex
+**/
+STATIC
+UINTN
+SmmCoreGetIndexBucket (
+  IN CONST PCH_SMM_SOURCE_DESC          *SrcDesc
+  )
+{
+  if (!IS_BIT_DESC_NULL (SrcDesc->PmcSmiSts) &&
+      (SrcDesc->PmcSmiSts.Reg.Type == ACPI_ADDR_TYPE) &&
+      (SrcDesc->PmcSmiSts.Reg.Data.acpi == R_ACPI_IO_SMI_STS)) {
+    ASSERT (SrcDesc->PmcSmiSts.Bit < PCH_SMM_INDEX_SMI_STS_BUCKETS);
+    return SrcDesc->PmcSmiSts.Bit;
+  }
+
+  if (!IS_BIT_DESC_NULL (SrcDesc->Sts[0]) &&
+      (SrcDesc->Sts[0].Reg.Type == ACPI_ADDR_TYPE) &&
+      (SrcDesc->Sts[0].Reg.Data.acpi == R_ACPI_IO_SMI_STS)) {
+    ASSERT (SrcDesc->Sts[0].Bit < PCH_SMM_INDEX_SMI_STS_BUCKETS);
+    return SrcDesc->Sts[0].Bit;
+  }
+
+  return PCH_SMM_INDEX_UNGATED_BUCKET;
+}
+
+/**
+  Link a database record into CallbackDataBase and into the dispatch index.
+
+  @param[in] Record               Record to be linked, allocated from SMRAM.
+**/
+VOID
+SmmCoreLinkRecord (
+  IN DATABASE_RECORD                    *Record
+  )
+{
+  InsertTailList (&mPrivateData.CallbackDataBase, &Record->Link);
+
+  Record->IndexBucket = SmmCoreGetIndexBucket (&Record->SrcDesc);
+  InsertTailList (&mPrivateData.DispatchIndex[Record->IndexBucket], &Record->IndexLink);
+  if (Record->IndexBucket < PCH_SMM_INDEX_SMI_STS_BUCKETS) {
+    mPrivateData.IndexedSmiStsMask |= (1u << Record->IndexBucket);
+  }
+}
+
+/**
+  Unlink a database record from CallbackDataBase and from the dispatch index.
+
+  @param[in] Record               Record to be unlinked.
+**/
+VOID
+SmmCoreUnlinkRecord (
+  IN DATABASE_RECORD                    *Record
+  )
+{
+  RemoveEntryList (&Record->Link);
+  RemoveEntryList (&Record->IndexLink);
+
+  if ((Record->IndexBucket < PCH_SMM_INDEX_SMI_STS_BUCKETS) &&
+      IsListEmpty (&mPrivateData.DispatchIndex[Record->IndexBucket])) {
+    mPrivateData.IndexedSmiStsMask &= ~(1u << Record->IndexBucket);
+  }
+}
+
+/**
+  Find the first active source in the dispatch index.
+  Only the buckets whose SMI_STS bit is set are visited, followed by the ungated bucket.
+
+  @param[in] SciEn                Current SCI_EN value
+  @param[in] SmiEnValue           Cached SMI_EN value
+  @param[in] SmiStsValue          Cached SMI_STS value
+
+  @retval NULL                    No registered source is active
+  @retval Others                  The first record whose source is active
+**/
+STATIC
+DATABASE_RECORD *
+SmmCoreFindActiveRecord (
+  IN BOOLEAN                            SciEn,
+  IN UINT32                             SmiEnValue,
+  IN UINT32                             SmiStsValue
+  )
+{
+  UINT32                                ActiveBuckets;
+  UINTN                                 Bucket;
+  LIST_ENTRY                            *LinkInDb;
+  DATABASE_RECORD                       *RecordInDb;
+
+  ActiveBuckets = SmiStsValue & mPrivateData.IndexedSmiStsMask;
+
+  for (Bucket = 0; Bucket < PCH_SMM_INDEX_BUCKET_NUM; Bucket++) {
+    if ((Bucket < PCH_SMM_INDEX_SMI_STS_BUCKETS) && ((ActiveBuckets & (1u << Bucket)) == 0)) {
+      continue;
+    }
+
+    LinkInDb = GetFirstNode (&mPrivateData.DispatchIndex[Bucket]);
+    while (!IsNull (&mPrivateData.DispatchIndex[Bucket], LinkInDb)) {
+      RecordInDb = DATABASE_RECORD_FROM_INDEX_LINK (LinkInDb);
+      mPrivateData.DispatchStats.RecordsChecked++;
+      if (SourceIsActive (&RecordInDb->SrcDesc, SciEn, SmiEnValue, SmiStsValue)) {
+        return RecordInDb;
+      }
+      LinkInDb = GetNextNode (&mPrivateData.DispatchIndex[Bucket], &RecordInDb->IndexLink);
+    }
+  }
+
+  return NULL;
+}
+
 /**
   This function clears the pending SMI status before set EOS.
   NOTE: This only clears the pending SMI with known reason.
@@ -677,9 +795,10 @@ PchSmmCoreDispatcher (
   BOOLEAN             SxChildWasDispatched;
 
   DATABASE_RECORD     *RecordInDb;
-  LIST_ENTRY          *LinkInDb;
   DATABASE_RECORD     *RecordToExhaust;
   LIST_ENTRY          *LinkToExhaust;
+  LIST_ENTRY          *IndexBucket;
+  PCH_SMM_CLEAR_SOURCE ClearSource;
 
   PCH_SMM_CONTEXT     Context;
   VOID                *CommBuffer;
@@ -691,6 +810,8 @@ PchSmmCoreDispatcher (
   UINT32              SmiStsValue;
   UINT8               Port74Save;
   UINT8               Port76Save;
+  UINT64              StartTicks;
+  UINT64              ElapsedTicks;
 
   PCH_SMM_SOURCE_DESC ActiveSource;
 
@@ -699,6 +820,7 @@ PchSmmCoreDispatcher (
   //
   NullInitSourceDesc (&ActiveSource);
 
+  StartTicks            = AsmReadTsc ();
   EscapeCount           = 3;
   ContextsMatch         = FALSE;
   EosSet                = FALSE;
@@ -721,8 +843,6 @@ PchSmmCoreDispatcher (
     while ((!EosSet) && (EscapeCount > 0)) {
       EscapeCount--;
 
-      LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
-
       //
       // Cache SciEn, SmiEnValue and SmiStsValue to determine if source is active
       //
@@ -730,147 +850,136 @@ PchSmmCoreDispatcher (
       SmiEnValue  = IoRead32 ((UINTN) (mAcpiBaseAddr + R_ACPI_IO_SMI_EN));
       SmiStsValue = IoRead32 ((UINTN) (mAcpiBaseAddr + R_ACPI_IO_SMI_STS));
 
-      while (!IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
-        RecordInDb = DATABASE_RECORD_FROM_LINK (LinkInDb);
+      //
+      // look for the first active source, only visiting the index buckets of the asserted SMI_STS bits
+      //
+      RecordInDb = SmmCoreFindActiveRecord (SciEn, SmiEnValue, SmiStsValue);
+      if (RecordInDb == NULL) {
+        //
+        // Clear pending SMI status before EOS
+        //
+        ClearPendingSmiStatus (SmiStsValue, SciEn);
+        EosSet = PchSmmSetAndCheckEos ();
+        continue;
+      }
+
+      //
+      // We found a source. If this is a sleep type, we have to go to
+      // appropriate sleep state anyway.No matter there is sleep child or not
+      //
+      if (RecordInDb->ProtocolType == SxType) {
+        SxChildWasDispatched = TRUE;
+      }
+      mPrivateData.DispatchStats.DispatchCount++;
+      //
+      // "cache" the source description and don't query I/O anymore.
+      // RecordInDb might be unregistered by its own callback, so cache ClearSource too.
+      //
+      CopyMem ((VOID *) &ActiveSource, (VOID *) &(RecordInDb->SrcDesc), sizeof (PCH_SMM_SOURCE_DESC));
+      ClearSource   = RecordInDb->ClearSource;
+      IndexBucket   = &mPrivateData.DispatchIndex[RecordInDb->IndexBucket];
+      LinkToExhaust = &RecordInDb->IndexLink;
 
+      //
+      // exhaust the rest of the bucket looking for the same source.
+      // Records with an equal source description always share the same bucket.
+      //
+      while (!IsNull (IndexBucket, LinkToExhaust)) {
+        RecordToExhaust = DATABASE_RECORD_FROM_INDEX_LINK (LinkToExhaust);
         //
-        // look for the first active source
+        // RecordToExhaust->IndexLink might be removed (unregistered) by Callback function, and then the
+        // system will hang in ASSERT() while calling GetNextNode().
+        // To prevent the issue, we need to get next record in the bucket here (before Callback function).
         //
-        if (!SourceIsActive (&RecordInDb->SrcDesc, SciEn, SmiEnValue, SmiStsValue)) {
-          //
-          // Didn't find the source yet, keep looking
-          //
-          LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, &RecordInDb->Link);
+        LinkToExhaust = GetNextNode (IndexBucket, &RecordToExhaust->IndexLink);
 
+        if (CompareSources (&RecordToExhaust->SrcDesc, &ActiveSource)) {
           //
-          // if it's the last one, try to clear EOS
+          // These source descriptions are equal, so this callback should be
+          // dispatched.
           //
-          if (IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
+          if (RecordToExhaust->ContextFunctions.GetContext != NULL) {
             //
-            // Clear pending SMI status before EOS
+            // This child requires that we get a calling context from
+            // hardware and compare that context to the one supplied
+            // by the child.
             //
-            ClearPendingSmiStatus (SmiStsValue, SciEn);
-            EosSet = PchSmmSetAndCheckEos ();
-          }
-        } else {
-          //
-          // We found a source. If this is a sleep type, we have to go to
-          // appropriate sleep state anyway.No matter there is sleep child or not
-          //
-          if (RecordInDb->ProtocolType == SxType) {
-            SxChildWasDispatched = TRUE;
-          }
-          //
-          // "cache" the source description and don't query I/O anymore
-          //
-          CopyMem ((VOID *) &ActiveSource, (VOID *) &(RecordInDb->SrcDesc), sizeof (PCH_SMM_SOURCE_DESC));
-          LinkToExhaust = LinkInDb;
+            ASSERT (RecordToExhaust->ContextFunctions.CmpContext != NULL);
 
-          //
-          // exhaust the rest of the queue looking for the same source
-          //
-          while (!IsNull (&mPrivateData.CallbackDataBase, LinkToExhaust)) {
-            RecordToExhaust = DATABASE_RECORD_FROM_LINK (LinkToExhaust);
             //
-            // RecordToExhaust->Link might be removed (unregistered) by Callback function, and then the
-            // system will hang in ASSERT() while calling GetNextNode().
-            // To prevent the issue, we need to get next record in DB here (before Callback function).
+            // Make sure contexts match before dispatching event to child
             //
-            LinkToExhaust = GetNextNode (&mPrivateData.CallbackDataBase, &RecordToExhaust->Link);
+            RecordToExhaust->ContextFunctions.GetContext (RecordToExhaust, &Context);
+            ContextsMatch = RecordToExhaust->ContextFunctions.CmpContext (&Context, &RecordToExhaust->ChildContext);
 
-            if (CompareSources (&RecordToExhaust->SrcDesc, &ActiveSource)) {
+          } else {
+            //
+            // This child doesn't require any more calling context beyond what
+            // it supplied in registration.  Simply pass back what it gave us.
+            //
+            Context       = RecordToExhaust->ChildContext;
+            ContextsMatch = TRUE;
+          }
+
+          if (ContextsMatch) {
+            if (RecordToExhaust->ProtocolType == PchSmiDispatchType) {
               //
-              // These source descriptions are equal, so this callback should be
-              // dispatched.
+              // For PCH SMI dispatch protocols
               //
-              if (RecordToExhaust->ContextFunctions.GetContext != NULL) {
-                //
-                // This child requires that we get a calling context from
-                // hardware and compare that context to the one supplied
-                // by the child.
-                //
-                ASSERT (RecordToExhaust->ContextFunctions.CmpContext != NULL);
-
-                //
-                // Make sure contexts match before dispatching event to child
-                //
-                RecordToExhaust->ContextFunctions.GetContext (RecordToExhaust, &Context);
-                ContextsMatch = RecordToExhaust->ContextFunctions.CmpContext (&Context, &RecordToExhaust->ChildContext);
-
-              } else {
-                //
-                // This child doesn't require any more calling context beyond what
-                // it supplied in registration.  Simply pass back what it gave us.
-                //
-                Context       = RecordToExhaust->ChildContext;
-                ContextsMatch = TRUE;
-              }
-
-              if (ContextsMatch) {
-                if (RecordToExhaust->ProtocolType == PchSmiDispatchType) {
+              PchSmiTypeCallbackDispatcher (RecordToExhaust);
+            } else {
+              //
+              // For EFI standard SMI dispatch protocols
+              //
+              if (RecordToExhaust->Callback != NULL) {
+                if (RecordToExhaust->ContextFunctions.GetCommBuffer != NULL) {
                   //
-                  // For PCH SMI dispatch protocols
+                  // This callback function needs CommBuffer and CommBufferSize.
+                  // Get those from child and then pass to callback function.
                   //
-                  PchSmiTypeCallbackDispatcher (RecordToExhaust);
+                  RecordToExhaust->ContextFunctions.GetCommBuffer (RecordToExhaust, &CommBuffer, &CommBufferSize);
                 } else {
                   //
-                  // For EFI standard SMI dispatch protocols
+                  // Child doesn't support the CommBuffer and CommBufferSize.
+                  // Just pass NULL value to callback function.
                   //
-                  if (RecordToExhaust->Callback != NULL) {
-                    if (RecordToExhaust->ContextFunctions.GetCommBuffer != NULL) {
-                      //
-                      // This callback function needs CommBuffer and CommBufferSize.
-                      // Get those from child and then pass to callback function.
-                      //
-                      RecordToExhaust->ContextFunctions.GetCommBuffer (RecordToExhaust, &CommBuffer, &CommBufferSize);
-                    } else {
-                      //
-                      // Child doesn't support the CommBuffer and CommBufferSize.
-                      // Just pass NULL value to callback function.
-                      //
-                      CommBuffer     = NULL;
-                      CommBufferSize = 0;
-                    }
-
-                    PERF_START_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
-                    RecordToExhaust->Callback ((EFI_HANDLE) & RecordToExhaust->Link, &Context, CommBuffer, &CommBufferSize);
-                    PERF_END_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
-                    if (RecordToExhaust->ProtocolType == SxType) {
-                      SxChildWasDispatched = TRUE;
-                    }
-                  } else {
-                    ASSERT (FALSE);
-                  }
+                  CommBuffer     = NULL;
+                  CommBufferSize = 0;
                 }
+
+                PERF_START_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
+                RecordToExhaust->Callback ((EFI_HANDLE) & RecordToExhaust->Link, &Context, CommBuffer, &CommBufferSize);
+                PERF_END_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
+                if (RecordToExhaust->ProtocolType == SxType) {
+                  SxChildWasDispatched = TRUE;
+                }
+              } else {
+                ASSERT (FALSE);
               }
             }
           }
-
-          if (RecordInDb->ClearSource == NULL) {
-            //
-            // Clear the SMI associated w/ the source using the default function
-            //
-            PchSmmClearSource (&ActiveSource);
-          } else {
-            //
-            // This source requires special handling to clear
-            //
-            RecordInDb->ClearSource (&ActiveSource);
-          }
-          //
-          // Clear pending SMI status before EOS
-          //
-          ClearPendingSmiStatus (SmiStsValue, SciEn);
-          //
-          // Also, try to clear EOS
-          //
-          EosSet = PchSmmSetAndCheckEos ();
-          //
-          // Queue is empty, reset the search
-          //
-          break;
         }
       }
+
+      if (ClearSource == NULL) {
+        //
+        // Clear the SMI associated w/ the source using the default function
+        //
+        PchSmmClearSource (&ActiveSource);
+      } else {
+        //
+        // This source requires special handling to clear
+        //
+        ClearSource (&ActiveSource);
+      }
+      //
+      // Clear pending SMI status before EOS
+      //
+      ClearPendingSmiStatus (SmiStsValue, SciEn);
+      //
+      // Also, try to clear EOS
+      //
+      EosSet = PchSmmSetAndCheckEos ();
     }
   }
   //
@@ -892,6 +1001,17 @@ PchSmmCoreDispatcher (
   //
   //  ASSERT (EscapeCount > 0);
   //
+  // Update the SMI handler latency counters
+  //
+  ElapsedTicks = AsmReadTsc () - StartTicks;
+  mPrivateData.DispatchStats.SmiCount++;
+  mPrivateData.DispatchStats.LastTicks   = ElapsedTicks;
+  mPrivateData.DispatchStats.TotalTicks += ElapsedTicks;
+  if (ElapsedTicks > mPrivateData.DispatchStats.MaxTicks) {
+    mPrivateData.DispatchStats.MaxTicks = ElapsedTicks;
+    DEBUG ((DEBUG_VERBOSE, "PchSmmCoreDispatcher: new max SMI latency %ld ticks\n", ElapsedTicks));
+  }
+
   if (SxChildWasDispatched) {
     //
     // A child of the SmmSxDispatch protocol was dispatched during this call;
@@ -241,7 +241,7 @@ PchGpiSmiUnRegister (
   }
 
 
-  RemoveEntryList (&RecordToDelete->Link);
+  SmmCoreUnlinkRecord (RecordToDelete);
   ZeroMem (RecordToDelete, sizeof (DATABASE_RECORD));
   Status = gSmst->SmmFreePool (RecordToDelete);
 
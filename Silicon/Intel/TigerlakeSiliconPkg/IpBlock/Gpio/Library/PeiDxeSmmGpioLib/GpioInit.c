@@ -108,13 +108,65 @@ GpioDwRegValueFromGpioConfig (
   }
 }
 
+//
+// GPIO_CONFIGURE_STATS structure is used by GpioConfigurePch function
+// to count PCR accesses issued and avoided while programming the table.
+//
+typedef struct {
+  UINT32             PadCount;
+  UINT32             PcrReads;
+  UINT32             PcrWrites;
+  UINT32             PcrWritesSkipped;
+  UINT32             SbiUnlocks;
+  UINT32             SbiUnlocksSkipped;
+} GPIO_CONFIGURE_STATS;
+
+/**
+  This internal procedure will update a GPIO PCR register only if its value changes.
+
+  @param[in]     Address        PCR register address
+  @param[in]     AndMask        Mask which will be AND'ed with register value
+  @param[in]     OrMask         Mask which will be OR'ed with register value
+  @param[in out] Stats          PCR access counters
+
+  @retval None
+**/
+STATIC
+VOID
+GpioPcrAndThenOr32IfChanged (
+  IN UINTN                     Address,
+  IN UINT32                    AndMask,
+  IN UINT32                    OrMask,
+  IN OUT GPIO_CONFIGURE_STATS  *Stats
+  )
+{
+  UINT32  OldValue;
+  UINT32  NewValue;
+
+  OldValue = MmioRead32 (Address);
+  Stats->PcrReads++;
+
+  NewValue = (OldValue & AndMask) | OrMask;
+  if (NewValue == OldValue) {
+    Stats->PcrWritesSkipped++;
+    return;
+  }
+
+  MmioWrite32 (Address, NewValue);
+  Stats->PcrWrites++;
+}
+
 /**
   This internal procedure will scan GPIO initialization table and unlock
-  all pads present in it
+  all pads of one group present in it which are currently locked.
+  PADCFGLOCK/PADCFGLOCKTX registers are read once per group DW and the
+  unlock SBI message is skipped if none of the pads is locked.
 
-  @param[in] NumberOfItem               Number of GPIO pad records in table
-  @param[in] GpioInitTableAddress       GPIO initialization table
-  @param[in] Index                      Index of GPIO Initialization table record
+  @param[in]     NumberOfItems          Number of GPIO pad records in table
+  @param[in]     GpioInitTableAddress   GPIO initialization table
+  @param[in]     Group                  GPIO group
+  @param[in]     GroupIndex             GPIO group index
+  @param[in out] Stats                  PCR access counters
 
   @retval EFI_SUCCESS                   The function completed successfully
   @retval EFI_INVALID_PARAMETER         Invalid group or pad number
@@ -124,39 +176,33 @@ EFI_STATUS
 GpioUnlockPadsForAGroup (
   IN UINT32                    NumberOfItems,
   IN GPIO_INIT_CONFIG          *GpioInitTableAddress,
-  IN UINT32                    Index
+  IN GPIO_GROUP                Group,
+  IN UINT32                    GroupIndex,
+  IN OUT GPIO_CONFIGURE_STATS  *Stats
   )
 {
   UINT32                 PadsToUnlock[GPIO_GROUP_DW_NUMBER];
+  UINT32                 LockRegVal;
   UINT32                 DwNum;
-  UINT32                 PadBitPosition;
   CONST GPIO_GROUP_INFO  *GpioGroupInfo;
   UINT32                 GpioGroupInfoLength;
   CONST GPIO_INIT_CONFIG *GpioData;
-  GPIO_GROUP             Group;
-  UINT32                 GroupIndex;
+  UINT32                 Index;
   UINT32                 PadNumber;
 
   GpioGroupInfo = GpioGetGroupInfoTable (&GpioGroupInfoLength);
 
-  GpioData   = &GpioInitTableAddress[Index];
-  Group      = GpioGetGroupFromGpioPad (GpioData->GpioPad);
-  GroupIndex = GpioGetGroupIndexFromGpioPad (GpioData->GpioPad);
-
   ZeroMem (PadsToUnlock, sizeof (PadsToUnlock));
   //
-  // Loop through pads for one group. If pad belongs to a different group then
-  // break and move to register programming.
+  // Collect all pads of this group from the whole table
   //
-  while (Index < NumberOfItems) {
-
-    GpioData   = &GpioInitTableAddress[Index];
+  for (Index = 0; Index < NumberOfItems; Index++) {
+    GpioData = &GpioInitTableAddress[Index];
     if (GroupIndex != GpioGetGroupIndexFromGpioPad (GpioData->GpioPad)) {
-      //if next pad is from different group then break loop
-      break;
+      continue;
     }
 
-    PadNumber  = GpioGetPadNumberFromGpioPad (GpioData->GpioPad);
+    PadNumber = GpioGetPadNumberFromGpioPad (GpioData->GpioPad);
     //
     // Check if legal pin number
     //
@@ -165,9 +211,7 @@ GpioUnlockPadsForAGroup (
       return EFI_INVALID_PARAMETER;
     }
 
-    PadBitPosition = GPIO_GET_PAD_POSITION (PadNumber);
     DwNum = GPIO_GET_DW_NUM (PadNumber);
-
     if (DwNum >= GPIO_GROUP_DW_NUMBER) {
       ASSERT (FALSE);
       return EFI_UNSUPPORTED;
@@ -175,19 +219,34 @@ GpioUnlockPadsForAGroup (
     //
     // Update pads which need to be unlocked
     //
-    PadsToUnlock[DwNum] |= 0x1 << PadBitPosition;
-
-    //Move to next item
-    Index++;
+    PadsToUnlock[DwNum] |= 0x1 << GPIO_GET_PAD_POSITION (PadNumber);
   }
 
-  for (DwNum = 0; DwNum <= GPIO_GET_DW_NUM (GpioGroupInfo[GroupIndex].PadPerGroup); DwNum++) {
+  for (DwNum = 0; DwNum < GPIO_GROUP_DW_NUMBER; DwNum++) {
+    if (PadsToUnlock[DwNum] == 0) {
+      continue;
+    }
     //
-    // Unlock pads
+    // Unlock only pads which are locked
     //
-    if (PadsToUnlock[DwNum] != 0) {
-      GpioUnlockPadCfgForGroupDw (Group, DwNum, PadsToUnlock[DwNum]);
-      GpioUnlockPadCfgTxForGroupDw (Group, DwNum, PadsToUnlock[DwNum]);
+    LockRegVal = 0;
+    GpioGetPadCfgLockForGroupDw (Group, DwNum, &LockRegVal);
+    Stats->PcrReads++;
+    if ((LockRegVal & PadsToUnlock[DwNum]) != 0) {
+      GpioUnlockPadCfgForGroupDw (Group, DwNum, LockRegVal & PadsToUnlock[DwNum]);
+      Stats->SbiUnlocks++;
+    } else {
+      Stats->SbiUnlocksSkipped++;
+    }
+
+    LockRegVal = 0;
+    GpioGetPadCfgLockTxForGroupDw (Group, DwNum, &LockRegVal);
+    Stats->PcrReads++;
+    if ((LockRegVal & PadsToUnlock[DwNum]) != 0) {
+      GpioUnlockPadCfgTxForGroupDw (Group, DwNum, LockRegVal & PadsToUnlock[DwNum]);
+      Stats->SbiUnlocks++;
+    } else {
+      Stats->SbiUnlocksSkipped++;
     }
   }
 
@@ -197,6 +256,10 @@ GpioUnlockPadsForAGroup (
 /**
   This procedure will initialize multiple PCH GPIO pins
 
+  Pads are bucketed by group in a pre-pass, so every group is unlocked and
+  its DW registers are programmed once no matter how the table is ordered.
+  Registers are only written when their value actually changes.
+
   @param[in] NumberofItem               Number of GPIO pads to be updated
   @param[in] GpioInitTableAddress       GPIO initialization table
 
@@ -210,30 +273,37 @@ GpioConfigurePch (
   IN GPIO_INIT_CONFIG          *GpioInitTableAddress
   )
 {
+  EFI_STATUS             Status;
   UINT32                 Index;
   UINT32                 PadCfgDwReg[GPIO_PADCFG_DW_REG_NUMBER];
   UINT32                 PadCfgDwRegMask[GPIO_PADCFG_DW_REG_NUMBER];
   UINT32                 PadCfgReg;
+  UINT32                 PadCfgDwIndex;
   GPIO_GROUP_DW_DATA     GroupDwData[GPIO_GROUP_DW_NUMBER];
   UINT32                 DwNum;
   CONST GPIO_GROUP_INFO  *GpioGroupInfo;
   UINT32                 GpioGroupInfoLength;
-  GPIO_PAD_OWN           PadOwnVal;
   CONST GPIO_INIT_CONFIG *GpioData;
+  GPIO_GROUP             Group;
   UINT32                 GroupIndex;
+  UINT32                 GroupsPresent;
   UINT32                 PadNumber;
   PCH_SBI_PID            GpioCom;
-
-  PadOwnVal = GpioPadOwnHost;
+  GPIO_CONFIGURE_STATS   Stats;
+  UINT32                 PadOwnRegVal;
+  UINT32                 PadOwnRegNum;
+  GPIO_PAD_OWN           PadOwnVal;
 
   GpioGroupInfo = GpioGetGroupInfoTable (&GpioGroupInfoLength);
+  ZeroMem (&Stats, sizeof (Stats));
+  Stats.PadCount = NumberOfItems;
 
-  Index = 0;
-  while (Index < NumberOfItems) {
-
-    GpioData   = &GpioInitTableAddress[Index];
-    GroupIndex = GpioGetGroupIndexFromGpioPad (GpioData->GpioPad);
-    GpioCom    = GpioGroupInfo[GroupIndex].Community;
+  //
+  // Bucket pads by group: find out which groups are present in the table
+  //
+  GroupsPresent = 0;
+  for (Index = 0; Index < NumberOfItems; Index++) {
+    GpioData = &GpioInitTableAddress[Index];
 
     DEBUG_CODE_BEGIN();
     if (!GpioIsCorrectPadForThisChipset (GpioData->GpioPad)) {
@@ -243,6 +313,28 @@ GpioConfigurePch (
     }
     DEBUG_CODE_END ();
 
+    GroupIndex = GpioGetGroupIndexFromGpioPad (GpioData->GpioPad);
+    if (GroupIndex >= GpioGroupInfoLength) {
+      DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group index (%d) exceeds possible range\n", GroupIndex));
+      return EFI_INVALID_PARAMETER;
+    }
+    GroupsPresent |= 0x1 << GroupIndex;
+  }
+
+  for (GroupIndex = 0; GroupIndex < GpioGroupInfoLength; GroupIndex++) {
+    if ((GroupsPresent & (0x1 << GroupIndex)) == 0) {
+      continue;
+    }
+
+    GpioCom = GpioGroupInfo[GroupIndex].Community;
+    Group   = 0;
+    for (Index = 0; Index < NumberOfItems; Index++) {
+      if (GroupIndex == GpioGetGroupIndexFromGpioPad (GpioInitTableAddress[Index].GpioPad)) {
+        Group = GpioGetGroupFromGpioPad (GpioInitTableAddress[Index].GpioPad);
+        break;
+      }
+    }
+
     //
     // Unlock pads for a given group which are going to be reconfigured
     //
@@ -253,43 +345,42 @@ GpioConfigurePch (
     // PadRstCfg != Powergood GpioPad will have its configuration locked despite it being not the
     // one desired by BIOS. Before reconfiguring all pads they will get unlocked.
     //
-    GpioUnlockPadsForAGroup (NumberOfItems, GpioInitTableAddress, Index);
+    Status = GpioUnlockPadsForAGroup (NumberOfItems, GpioInitTableAddress, Group, GroupIndex, &Stats);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
 
     ZeroMem (GroupDwData, sizeof (GroupDwData));
+    PadOwnRegNum = MAX_UINT32;
+    PadOwnRegVal = 0;
     //
-    // Loop through pads for one group. If pad belongs to a different group then
-    // break and move to register programming.
+    // Loop through all pads of one group, in table order.
     //
-    while (Index < NumberOfItems) {
+    for (Index = 0; Index < NumberOfItems; Index++) {
 
       GpioData   = &GpioInitTableAddress[Index];
       if (GroupIndex != GpioGetGroupIndexFromGpioPad (GpioData->GpioPad)) {
-        //if next pad is from different group then break loop
-        break;
+        continue;
       }
 
       PadNumber  = GpioGetPadNumberFromGpioPad (GpioData->GpioPad);
 
       DEBUG_CODE_BEGIN ();
       //
-      // Check if legal pin number
+      // Check if selected GPIO Pad is not owned by CSME/ISH.
+      // One PAD_OWN register contains information for 8 pads, read it once for all of them.
       //
-      if (PadNumber >= GpioGroupInfo[GroupIndex].PadPerGroup) {
-        DEBUG ((DEBUG_ERROR, "GPIO ERROR: Pin number (%d) exceeds possible range for group %d\n", PadNumber, GroupIndex));
-        return EFI_INVALID_PARAMETER;
+      if (PadOwnRegNum != (PadNumber >> 3)) {
+        PadOwnRegNum = PadNumber >> 3;
+        PadOwnRegVal = MmioRead32 (PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].PadOwnOffset + PadOwnRegNum * 0x4));
+        Stats.PcrReads++;
       }
-
-      //
-      // Check if selected GPIO Pad is not owned by CSME/ISH
-      //
-      GpioGetPadOwnership (GpioData->GpioPad, &PadOwnVal);
+      PadOwnVal = (GPIO_PAD_OWN) ((PadOwnRegVal >> ((PadNumber % 8) * 4)) & (BIT1 | BIT0));
 
       if (PadOwnVal != GpioPadOwnHost) {
         DEBUG ((DEBUG_ERROR, "GPIO ERROR: Accessing pad not owned by host (Group=%d, Pad=%d)!\n", GroupIndex, PadNumber));
         DEBUG ((DEBUG_ERROR, "** Please make sure the GPIO usage in sync between CSME and BIOS configuration. \n"));
         DEBUG ((DEBUG_ERROR, "** All the GPIO occupied by CSME should not do any configuration by BIOS.\n"));
-        //Move to next item
-        Index++;
         continue;
       }
 
@@ -322,30 +413,19 @@ GpioConfigurePch (
       PadCfgReg = S_GPIO_PCR_PADCFG * PadNumber + GpioGroupInfo[GroupIndex].PadCfgOffset;
 
       //
-      // Write PADCFG DW0 register
-      //
-      MmioAndThenOr32 (
-        PCH_PCR_ADDRESS (GpioCom, PadCfgReg),
-        ~PadCfgDwRegMask[0],
-        PadCfgDwReg[0]
-        );
-      //
-      // Write PADCFG DW1 register
-      //
-      MmioAndThenOr32 (
-        PCH_PCR_ADDRESS (GpioCom, PadCfgReg + 0x4),
-        ~PadCfgDwRegMask[1],
-        PadCfgDwReg[1]
-        );
-
-      //
-      // Write PADCFG DW2 register
+      // Write PADCFG DW0, DW1 and DW2 registers, skipping the ones which are not modified
       //
-      MmioAndThenOr32 (
-        PCH_PCR_ADDRESS (GpioCom, PadCfgReg + 0x8),
-        ~PadCfgDwRegMask[2],
-        PadCfgDwReg[2]
-        );
+      for (PadCfgDwIndex = 0; PadCfgDwIndex < 3; PadCfgDwIndex++) {
+        if (PadCfgDwRegMask[PadCfgDwIndex] == 0) {
+          continue;
+        }
+        GpioPcrAndThenOr32IfChanged (
+          PCH_PCR_ADDRESS (GpioCom, PadCfgReg + PadCfgDwIndex * 0x4),
+          ~PadCfgDwRegMask[PadCfgDwIndex],
+          PadCfgDwReg[PadCfgDwIndex],
+          &Stats
+          );
+      }
 
       //
       // Get GPIO DW register values from GPIO config data
@@ -355,31 +435,32 @@ GpioConfigurePch (
         &GpioData->GpioConfig,
         GroupDwData
         );
-
-      //Move to next item
-      Index++;
     }
 
-    for (DwNum = 0; DwNum <= GPIO_GET_DW_NUM (GpioGroupInfo[GroupIndex].PadPerGroup); DwNum++) {
+    for (DwNum = 0; (DwNum < GPIO_GROUP_DW_NUMBER) && (DwNum <= GPIO_GET_DW_NUM (GpioGroupInfo[GroupIndex].PadPerGroup)); DwNum++) {
       //
       // Write HOSTSW_OWN registers
       //
-      if (GpioGroupInfo[GroupIndex].HostOwnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
+      if ((GpioGroupInfo[GroupIndex].HostOwnOffset != NO_REGISTER_FOR_PROPERTY) &&
+          (GroupDwData[DwNum].HostSoftOwnRegMask != 0)) {
+        GpioPcrAndThenOr32IfChanged (
           PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].HostOwnOffset + DwNum * 0x4),
           ~GroupDwData[DwNum].HostSoftOwnRegMask,
-          GroupDwData[DwNum].HostSoftOwnReg
+          GroupDwData[DwNum].HostSoftOwnReg,
+          &Stats
           );
       }
 
       //
       // Write GPI_GPE_EN registers
       //
-      if (GpioGroupInfo[GroupIndex].GpiGpeEnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
+      if ((GpioGroupInfo[GroupIndex].GpiGpeEnOffset != NO_REGISTER_FOR_PROPERTY) &&
+          (GroupDwData[DwNum].GpiGpeEnRegMask != 0)) {
+        GpioPcrAndThenOr32IfChanged (
           PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].GpiGpeEnOffset + DwNum * 0x4),
           ~GroupDwData[DwNum].GpiGpeEnRegMask,
-          GroupDwData[DwNum].GpiGpeEnReg
+          GroupDwData[DwNum].GpiGpeEnReg,
+          &Stats
           );
       }
 
@@ -387,11 +468,14 @@ GpioConfigurePch (
       // Write GPI_NMI_EN registers
       //
       if (GpioGroupInfo[GroupIndex].NmiEnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
-          PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].NmiEnOffset + DwNum * 0x4),
-          ~GroupDwData[DwNum].GpiNmiEnRegMask,
-          GroupDwData[DwNum].GpiNmiEnReg
-          );
+        if (GroupDwData[DwNum].GpiNmiEnRegMask != 0) {
+          GpioPcrAndThenOr32IfChanged (
+            PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].NmiEnOffset + DwNum * 0x4),
+            ~GroupDwData[DwNum].GpiNmiEnRegMask,
+            GroupDwData[DwNum].GpiNmiEnReg,
+            &Stats
+            );
+        }
       } else if (GroupDwData[DwNum].GpiNmiEnReg != 0x0) {
         DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group %d has no pads supporting NMI\n", GroupIndex));
         ASSERT_EFI_ERROR (EFI_UNSUPPORTED);
@@ -401,11 +485,14 @@ GpioConfigurePch (
       // Write GPI_SMI_EN registers
       //
       if (GpioGroupInfo[GroupIndex].SmiEnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
-          PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].SmiEnOffset + DwNum * 0x4),
-          ~GroupDwData[DwNum].GpiSmiEnRegMask,
-          GroupDwData[DwNum].GpiSmiEnReg
-          );
+        if (GroupDwData[DwNum].GpiSmiEnRegMask != 0) {
+          GpioPcrAndThenOr32IfChanged (
+            PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].SmiEnOffset + DwNum * 0x4),
+            ~GroupDwData[DwNum].GpiSmiEnRegMask,
+            GroupDwData[DwNum].GpiSmiEnReg,
+            &Stats
+            );
+        }
       } else if (GroupDwData[DwNum].GpiSmiEnReg != 0x0) {
         DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group %d has no pads supporting SMI\n", GroupIndex));
         ASSERT_EFI_ERROR (EFI_UNSUPPORTED);
@@ -427,6 +514,17 @@ GpioConfigurePch (
     }
   }
 
+  DEBUG ((
+    DEBUG_INFO,
+    "GPIO: %d pads, PCR reads %d, writes %d, skipped writes %d, unlock SBI %d, skipped unlock SBI %d\n",
+    Stats.PadCount,
+    Stats.PcrReads,
+    Stats.PcrWrites,
+    Stats.PcrWritesSkipped,
+    Stats.SbiUnlocks,
+    Stats.SbiUnlocksSkipped
+    ));
+
   return EFI_SUCCESS;
 }
 
@@ -529,8 +627,7 @@ GpioClearAllGpioInterrupts (
   Pad not configured using GPIO_INIT_CONFIG will be left with hardware default values.
   Separate fields could be set to hardware default if it does not matter, except
   GpioPad and PadMode.
-  Function will work in most efficient way if pads which belong to the same group are
-  placed in adjacent records of the table.
+  Pads are grouped internally, so the table does not need to be sorted by group.
   Although function can enable pads for Native mode, such programming is done
   by reference code when enabling related silicon feature.
 
@@ -245,7 +245,7 @@ PchGpiSmiUnRegister (
   }
 
 
-  RemoveEntryList (&RecordToDelete->Link);
+  SmmCoreUnlinkRecord (RecordToDelete);
   ZeroMem (RecordToDelete, sizeof (DATABASE_RECORD));
   Status = gSmst->SmmFreePool (RecordToDelete);
 
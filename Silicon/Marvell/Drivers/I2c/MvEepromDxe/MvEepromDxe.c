@@ -88,62 +88,170 @@ out:
   return Status;
 }
 
+/*
+ * Issue a single addressed request: the first operation sets the EEPROM
+ * address, the second one (if any) moves the data.
+ */
+STATIC
 EFI_STATUS
-EFIAPI
-MvEepromTransfer (
-  IN CONST MARVELL_EEPROM_PROTOCOL *This,
-  IN UINT16 Address,
-  IN UINT32 Length,
+MvEepromRequest (
+  IN EEPROM_CONTEXT *EepromContext,
+  IN UINT32 Address,
   IN UINT8 *Buffer,
+  IN UINT32 Length,
   IN UINT8 Operation
   )
 {
-  EFI_I2C_REQUEST_PACKET *RequestPacket;
-  UINTN RequestPacketSize;
-  EFI_STATUS Status = EFI_SUCCESS;
-  EEPROM_CONTEXT *EepromContext = EEPROM_SC_FROM_EEPROM(This);
-  UINT32 BufferLength;
-  UINT32 Transmitted = 0;
-  UINT32 CurrentAddress = Address;
+  EEPROM_REQUEST_PACKET RequestPacket;
+  UINT8 AddressBuffer[2];
 
-  ASSERT(EepromContext != NULL);
-  ASSERT(EepromContext->I2cIo != NULL);
+  AddressBuffer[0] = (Address >> 8) & 0xff;
+  AddressBuffer[1] = Address & 0xff;
 
-  RequestPacketSize = sizeof(UINTN) + sizeof (EFI_I2C_OPERATION) * 2;
-  RequestPacket = AllocateZeroPool (RequestPacketSize);
-  if (RequestPacket == NULL)
-    return EFI_OUT_OF_RESOURCES;
-  /* First operation contains address, the second is buffer */
-  RequestPacket->OperationCount = 2;
-  RequestPacket->Operation[0].LengthInBytes = 2;
-  RequestPacket->Operation[0].Buffer = AllocateZeroPool ( RequestPacket->Operation[0].LengthInBytes );
-  if (RequestPacket->Operation[0].Buffer == NULL) {
-    FreePool(RequestPacket);
-    return EFI_OUT_OF_RESOURCES;
+  RequestPacket.OperationCount = (Length > 0) ? 2 : 1;
+  RequestPacket.Operation[0].Flags = 0;
+  RequestPacket.Operation[0].LengthInBytes = sizeof (AddressBuffer);
+  RequestPacket.Operation[0].Buffer = AddressBuffer;
+  RequestPacket.Operation[1].Flags = (Operation == EEPROM_READ ? I2C_FLAG_READ : I2C_FLAG_NORESTART);
+  RequestPacket.Operation[1].LengthInBytes = Length;
+  RequestPacket.Operation[1].Buffer = Buffer;
+
+  return EepromContext->I2cIo->QueueRequest(EepromContext->I2cIo, 0, NULL,
+           (EFI_I2C_REQUEST_PACKET *)&RequestPacket, NULL);
+}
+
+/*
+ * The device does not acknowledge its address until the internal write
+ * cycle is over, so poll for the ACK instead of waiting the worst case.
+ */
+STATIC
+EFI_STATUS
+MvEepromWaitWriteDone (
+  IN EEPROM_CONTEXT *EepromContext,
+  IN UINT32 Address
+  )
+{
+  EFI_STATUS Status;
+  UINTN Timeout;
+
+  for (Timeout = 0; Timeout < EEPROM_WRITE_TIMEOUT; Timeout += EEPROM_ACK_POLL_INTERVAL) {
+    Status = MvEepromRequest (EepromContext, Address, NULL, 0, EEPROM_WRITE);
+    if (Status != EFI_NO_RESPONSE) {
+      return Status;
+    }
+    gBS->Stall (EEPROM_ACK_POLL_INTERVAL);
   }
-  RequestPacket->Operation[1].Flags = (Operation == EEPROM_READ ? I2C_FLAG_READ : I2C_FLAG_NORESTART);
+
+  DEBUG((DEBUG_ERROR, "MvEepromTransfer: write cycle timeout at 0x%x\n", Address));
+  return EFI_TIMEOUT;
+}
+
+STATIC
+EFI_STATUS
+MvEepromWrite (
+  IN EEPROM_CONTEXT *EepromContext,
+  IN UINT32 Address,
+  IN UINT32 Length,
+  IN UINT8 *Buffer
+  )
+{
+  EFI_STATUS Status = EFI_SUCCESS;
+  UINT32 BufferLength;
+  UINT32 Line;
 
   while (Length > 0) {
-    CurrentAddress = Address + Transmitted;
-    BufferLength = (Length <= MAX_BUFFER_LENGTH ? Length : MAX_BUFFER_LENGTH);
-    RequestPacket->Operation[0].Buffer[0] = (CurrentAddress >> 8) & 0xff;
-    RequestPacket->Operation[0].Buffer[1] = CurrentAddress & 0xff;
-    RequestPacket->Operation[1].LengthInBytes = BufferLength;
-    RequestPacket->Operation[1].Buffer = Buffer + Transmitted;
-    Status = EepromContext->I2cIo->QueueRequest(EepromContext->I2cIo, 0, NULL, RequestPacket, NULL);
+    BufferLength = EEPROM_PAGE_SIZE - (Address % EEPROM_PAGE_SIZE);
+    if (BufferLength > Length) {
+      BufferLength = Length;
+    }
+
+    /* Drop the cached copy of the line being written */
+    Line = Address / MAX_BUFFER_LENGTH;
+    EepromContext->CacheTag[Line % EEPROM_CACHE_LINES] = EEPROM_CACHE_TAG_INVALID;
+
+    Status = MvEepromRequest (EepromContext, Address, Buffer, BufferLength, EEPROM_WRITE);
+    if (!EFI_ERROR(Status)) {
+      Status = MvEepromWaitWriteDone (EepromContext, Address);
+    }
     if (EFI_ERROR(Status)) {
-      DEBUG((DEBUG_ERROR, "MvEepromTransfer: error %d during transmission\n", Status));
+      DEBUG((DEBUG_ERROR, "MvEepromTransfer: error %r during transmission\n", Status));
       break;
     }
+
+    Address += BufferLength;
+    Buffer += BufferLength;
     Length -= BufferLength;
-    Transmitted += BufferLength;
   }
 
-  FreePool(RequestPacket->Operation[0].Buffer);
-  FreePool(RequestPacket);
   return Status;
 }
 
+STATIC
+EFI_STATUS
+MvEepromRead (
+  IN EEPROM_CONTEXT *EepromContext,
+  IN UINT32 Address,
+  IN UINT32 Length,
+  IN UINT8 *Buffer
+  )
+{
+  EFI_STATUS Status;
+  UINT32 BufferLength;
+  UINT32 Line, Offset, Slot;
+
+  while (Length > 0) {
+    Line = Address / MAX_BUFFER_LENGTH;
+    Offset = Address % MAX_BUFFER_LENGTH;
+    Slot = Line % EEPROM_CACHE_LINES;
+
+    /* Fetch whole lines, so neighbouring fields come from the cache */
+    if (EepromContext->CacheTag[Slot] != Line) {
+      Status = MvEepromRequest (EepromContext, Line * MAX_BUFFER_LENGTH,
+                 EepromContext->Cache[Slot], MAX_BUFFER_LENGTH, EEPROM_READ);
+      if (EFI_ERROR(Status)) {
+        EepromContext->CacheTag[Slot] = EEPROM_CACHE_TAG_INVALID;
+        DEBUG((DEBUG_ERROR, "MvEepromTransfer: error %r during transmission\n", Status));
+        return Status;
+      }
+      EepromContext->CacheTag[Slot] = Line;
+    }
+
+    BufferLength = MAX_BUFFER_LENGTH - Offset;
+    if (BufferLength > Length) {
+      BufferLength = Length;
+    }
+    CopyMem (Buffer, &EepromContext->Cache[Slot][Offset], BufferLength);
+
+    Address += BufferLength;
+    Buffer += BufferLength;
+    Length -= BufferLength;
+  }
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+MvEepromTransfer (
+  IN CONST MARVELL_EEPROM_PROTOCOL *This,
+  IN UINT16 Address,
+  IN UINT32 Length,
+  IN UINT8 *Buffer,
+  IN UINT8 Operation
+  )
+{
+  EEPROM_CONTEXT *EepromContext = EEPROM_SC_FROM_EEPROM(This);
+
+  ASSERT(EepromContext != NULL);
+  ASSERT(EepromContext->I2cIo != NULL);
+
+  if (Operation == EEPROM_READ) {
+    return MvEepromRead (EepromContext, Address, Length, Buffer);
+  }
+
+  return MvEepromWrite (EepromContext, Address, Length, Buffer);
+}
+
 EFI_STATUS
 EFIAPI
 MvEepromStart (
@@ -164,6 +272,8 @@ MvEepromStart (
   EepromContext->ControllerHandle = ControllerHandle;
   EepromContext->Signature = EEPROM_SIGNATURE;
   EepromContext->EepromProtocol.Transfer = MvEepromTransfer;
+  SetMem32 (EepromContext->CacheTag, sizeof (EepromContext->CacheTag),
+    EEPROM_CACHE_TAG_INVALID);
 
   Status = gBS->OpenProtocol (
       ControllerHandle,
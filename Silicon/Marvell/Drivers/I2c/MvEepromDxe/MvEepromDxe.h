@@ -14,16 +14,38 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define MAX_BUFFER_LENGTH 64
 
+/*
+ * Writes must not cross a page of the device, or the internal address
+ * wraps within the page. 2-byte addressed parts (24C32 and up) have at least
+ * 32-byte pages.
+ */
+#define EEPROM_PAGE_SIZE          32
+
+/* Internal write cycle is polled by address ACK, both given in us */
+#define EEPROM_WRITE_TIMEOUT      10000
+#define EEPROM_ACK_POLL_INTERVAL  50
+
+/* Read cache of MAX_BUFFER_LENGTH byte lines, direct mapped */
+#define EEPROM_CACHE_LINES        16
+#define EEPROM_CACHE_TAG_INVALID  MAX_UINT32
+
 #define I2C_GUID \
   { \
   0xadc1901b, 0xb83c, 0x4831, { 0x8f, 0x59, 0x70, 0x89, 0x8f, 0x26, 0x57, 0x1e } \
   }
 
+typedef struct {
+  UINTN OperationCount;
+  EFI_I2C_OPERATION Operation[2];
+} EEPROM_REQUEST_PACKET;
+
 typedef struct {
   UINT32  Signature;
   EFI_HANDLE ControllerHandle;
   EFI_I2C_IO_PROTOCOL *I2cIo;
   MARVELL_EEPROM_PROTOCOL EepromProtocol;
+  UINT32 CacheTag[EEPROM_CACHE_LINES];
+  UINT8 Cache[EEPROM_CACHE_LINES][MAX_BUFFER_LENGTH];
 } EEPROM_CONTEXT;
 
 #define EEPROM_SC_FROM_IO(a) CR (a, EEPROM_CONTEXT, I2cIo, EEPROM_SIGNATURE)
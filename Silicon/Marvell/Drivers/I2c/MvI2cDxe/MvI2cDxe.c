@@ -272,7 +272,11 @@ MvI2cClearIflg (
   MvI2cControlClear(I2cMasterContext, I2C_CONTROL_IFLG);
 }
 
-/* Timeout is given in us */
+/*
+ * Timeout is given in us. The control register is polled in 1us steps, so
+ * the bus engine advances as soon as IFLG is raised rather than on the next
+ * coarse polling interval.
+ */
 STATIC
 UINTN
 MvI2cPollCtrl (
@@ -280,11 +284,10 @@ MvI2cPollCtrl (
   IN UINTN Timeout,
   IN UINT32 Mask)
 {
-  Timeout /= 10;
   while (!(I2C_READ(I2cMasterContext, I2C_CONTROL) & Mask)) {
-    gBS->Stall(10);
-    if (--Timeout == 0)
-      return (Timeout);
+    if (Timeout-- == 0)
+      return (1);
+    gBS->Stall(1);
   }
   return (0);
 }
@@ -333,7 +336,6 @@ MvI2cLockedStart (
   }
 
   I2C_WRITE(I2cMasterContext, I2C_DATA, Slave);
-  gBS->Stall(I2C_OPERATION_TIMEOUT);
   MvI2cClearIflg(I2cMasterContext);
 
   if (MvI2cPollCtrl(I2cMasterContext, Timeout, I2C_CONTROL_IFLG)) {
@@ -467,7 +469,6 @@ MvI2cStop (
 {
   EfiAcquireLock (&I2cMasterContext->Lock);
   MvI2cControlSet(I2cMasterContext, I2C_CONTROL_STOP);
-  gBS->Stall(I2C_OPERATION_TIMEOUT);
   MvI2cClearIflg(I2cMasterContext);
   EfiReleaseLock (&I2cMasterContext->Lock);
 
@@ -502,7 +503,6 @@ MvI2cRead (
     else
       MvI2cControlSet(I2cMasterContext, I2C_CONTROL_ACK);
 
-    gBS->Stall (I2C_OPERATION_TIMEOUT);
     MvI2cClearIflg(I2cMasterContext);
 
     if (MvI2cPollCtrl(I2cMasterContext, delay, I2C_CONTROL_IFLG)) {
@@ -647,11 +647,17 @@ MvI2cStartRequest (
     }
   }
 
+  /*
+   * Report the transaction status, so that clients can tell an absent or
+   * busy device (no ACK of the slave address) from a completed transfer.
+   */
   if (I2cStatus != NULL)
-    *I2cStatus = EFI_SUCCESS;
-  if (Event != NULL)
+    *I2cStatus = Status;
+  if (Event != NULL) {
     gBS->SignalEvent(Event);
-  return EFI_SUCCESS;
+    return EFI_SUCCESS;
+  }
+  return Status;
 }
 
 STATIC CONST EFI_GUID DevGuid = I2C_GUID;
@@ -159,6 +159,53 @@ SpiSetupTransfer (
   EfiReleaseLock (&SpiMaster->Lock);
 }
 
+STATIC
+VOID
+SpiSetWordLength (
+  IN UINTN   SpiRegBase,
+  IN BOOLEAN Is16Bit
+  )
+{
+  UINT32 Reg;
+
+  Reg = MmioRead32 (SpiRegBase + SPI_CONF_REG);
+  if (Is16Bit) {
+    Reg |= SPI_BYTE_LENGTH;
+  } else {
+    Reg &= ~SPI_BYTE_LENGTH;
+  }
+  MmioWrite32 (SpiRegBase + SPI_CONF_REG, Reg);
+}
+
+/*
+ * Shift one 8 or 16-bit word out and back in. In 16-bit mode the most
+ * significant byte is shifted first.
+ */
+STATIC
+EFI_STATUS
+SpiTransferWord (
+  IN  UINTN  SpiRegBase,
+  IN  UINT32 DataToSend,
+  OUT UINT32 *DataReceived
+  )
+{
+  UINT32 Iterator;
+
+  // Transmit Data
+  MmioWrite32 (SpiRegBase + SPI_INT_CAUSE_REG, 0x0);
+  MmioWrite32 (SpiRegBase + SPI_DATA_OUT_REG, DataToSend);
+  // Wait for memory ready
+  for (Iterator = 0; Iterator < SPI_TIMEOUT; Iterator++) {
+    if (MmioRead32 (SpiRegBase + SPI_INT_CAUSE_REG)) {
+      *DataReceived = MmioRead32 (SpiRegBase + SPI_DATA_IN_REG);
+      return EFI_SUCCESS;
+    }
+  }
+
+  DEBUG ((DEBUG_ERROR, "%a: Timeout\n", __FUNCTION__));
+  return EFI_TIMEOUT;
+}
+
 EFI_STATUS
 EFIAPI
 MvSpiTransfer (
@@ -171,18 +218,20 @@ MvSpiTransfer (
   )
 {
   SPI_MASTER *SpiMaster;
-  UINT64  Length;
-  UINT32  Iterator, Reg;
+  UINTN   Length;
   UINT8   *DataOutPtr = (UINT8 *)DataOut;
   UINT8   *DataInPtr  = (UINT8 *)DataIn;
-  UINT8   DataToSend  = 0;
+  UINT32  DataToSend  = 0;
+  UINT32  DataReceived;
   UINTN   SpiRegBase;
+  EFI_STATUS Status;
 
   SpiMaster = SPI_MASTER_FROM_SPI_MASTER_PROTOCOL (This);
 
   SpiRegBase = Slave->HostRegisterBaseAddress;
 
-  Length = 8 * DataByteCount;
+  Length = DataByteCount;
+  Status = EFI_SUCCESS;
 
   if (!EfiAtRuntime ()) {
     EfiAcquireLock (&SpiMaster->Lock);
@@ -192,39 +241,57 @@ MvSpiTransfer (
     SpiActivateCs (Slave);
   }
 
-  // Set 8-bit mode
-  Reg = MmioRead32 (SpiRegBase + SPI_CONF_REG);
-  Reg &= ~SPI_BYTE_LENGTH;
-  MmioWrite32 (SpiRegBase + SPI_CONF_REG, Reg);
+  //
+  // Move bulk data phases two bytes per transfer in 16-bit mode, which
+  // halves the register accesses per byte. The controller has no wider
+  // word length, a trailing odd byte goes out in 8-bit mode.
+  //
+  if (Length >= 2) {
+    SpiSetWordLength (SpiRegBase, TRUE);
+
+    while (Length >= 2) {
+      if (DataOutPtr != NULL) {
+        DataToSend = (DataOutPtr[0] << 8) | DataOutPtr[1];
+        DataOutPtr += 2;
+      }
 
-  while (Length > 0) {
-    if (DataOut != NULL) {
+      Status = SpiTransferWord (SpiRegBase, DataToSend, &DataReceived);
+      if (EFI_ERROR (Status)) {
+        goto Exit;
+      }
+
+      if (DataInPtr != NULL) {
+        DataInPtr[0] = (DataReceived >> 8) & 0xFF;
+        DataInPtr[1] = DataReceived & 0xFF;
+        DataInPtr += 2;
+      }
+      Length -= 2;
+    }
+  }
+
+  if (Length > 0) {
+    // Set 8-bit mode
+    SpiSetWordLength (SpiRegBase, FALSE);
+
+    if (DataOutPtr != NULL) {
       DataToSend = *DataOutPtr & 0xFF;
     }
-    // Transmit Data
-    MmioWrite32 (SpiRegBase + SPI_INT_CAUSE_REG, 0x0);
-    MmioWrite32 (SpiRegBase + SPI_DATA_OUT_REG, DataToSend);
-    // Wait for memory ready
-    for (Iterator = 0; Iterator < SPI_TIMEOUT; Iterator++) {
-      if (MmioRead32 (SpiRegBase + SPI_INT_CAUSE_REG)) {
-        if (DataInPtr != NULL) {
-          *DataInPtr = MmioRead32 (SpiRegBase + SPI_DATA_IN_REG);
-          DataInPtr++;
-        }
-        if (DataOutPtr != NULL) {
-          DataOutPtr++;
-        }
-        Length -= 8;
-        break;
-      }
+
+    Status = SpiTransferWord (SpiRegBase, DataToSend, &DataReceived);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
     }
 
-    if (Iterator >= SPI_TIMEOUT) {
-      DEBUG ((DEBUG_ERROR, "%a: Timeout\n", __FUNCTION__));
-      return EFI_TIMEOUT;
+    if (DataInPtr != NULL) {
+      *DataInPtr = DataReceived & 0xFF;
     }
   }
 
+Exit:
+  //
+  // Release the chip select on errors too, so that a timed out word does
+  // not leave the slave selected for the next transfer.
+  //
   if (Flag & SPI_TRANSFER_END) {
     SpiDeactivateCs (Slave);
   }
@@ -233,7 +300,7 @@ MvSpiTransfer (
     EfiReleaseLock (&SpiMaster->Lock);
   }
 
-  return EFI_SUCCESS;
+  return Status;
 }
 
 EFI_STATUS
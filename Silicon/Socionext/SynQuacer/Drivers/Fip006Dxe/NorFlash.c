@@ -558,6 +558,10 @@ NorFlashWriteFullBlock (
   for (WordIndex=0;
        WordIndex < BlockSizeInWords;
        WordIndex++, DataBuffer++, WordAddress += 4) {
+    // The block was just erased, so all-ones words are already in place
+    if (*DataBuffer == MAX_UINT32) {
+      continue;
+    }
     Status = NorFlashWriteSingleWord (Instance, WordAddress, *DataBuffer);
     if (EFI_ERROR (Status)) {
       goto EXIT;
@@ -746,6 +750,39 @@ NorFlashRead (
   return EFI_SUCCESS;
 }
 
+/*
+  Return the word at WordOffset within the block as it will read after
+  NumBytes of Buffer have been written at Offset, given its current value.
+*/
+STATIC
+UINT32
+NorFlashMergeWord (
+  IN        UINT32                OldWord,
+  IN        UINTN                 WordOffset,
+  IN        UINTN                 Offset,
+  IN        UINTN                 NumBytes,
+  IN  CONST UINT8                 *Buffer
+  )
+{
+  UINT32      NewWord;
+  UINTN       Index;
+
+  // Fast path for words fully covered by the new data
+  if (WordOffset >= Offset &&
+      WordOffset + sizeof (UINT32) <= Offset + NumBytes) {
+    return ReadUnaligned32 ((CONST UINT32 *)(Buffer + WordOffset - Offset));
+  }
+
+  NewWord = OldWord;
+  for (Index = 0; Index < sizeof (UINT32); Index++) {
+    if (WordOffset + Index >= Offset &&
+        WordOffset + Index < Offset + NumBytes) {
+      ((UINT8 *)&NewWord)[Index] = Buffer[WordOffset + Index - Offset];
+    }
+  }
+  return NewWord;
+}
+
 /*
   Write a full or portion of a block. It must not span block boundaries;
   that is, Offset + *NumBytes <= Instance->BlockSize.
@@ -760,19 +797,16 @@ NorFlashWriteSingleBlock (
   )
 {
   EFI_STATUS  TempStatus;
-  UINT32      Tmp;
-  UINT32      TmpBuf;
   UINT32      WordToWrite;
-  UINT32      Mask;
+  UINT32      *OldWords;
   BOOLEAN     DoErase;
-  UINTN       BytesToWrite;
+  BOOLEAN     NeedWrite;
   UINTN       CurOffset;
-  UINTN       WordAddr;
+  UINTN       FirstWordOffset;
+  UINTN       EndWordOffset;
+  UINTN       Index;
   UINTN       BlockSize;
   UINTN       BlockAddress;
-  UINTN       PrevBlockAddress;
-
-  PrevBlockAddress = 0;
 
   if (!Instance->Initialized && Instance->Initialize) {
     Instance->Initialize(Instance);
@@ -805,136 +839,75 @@ NorFlashWriteSingleBlock (
     return EFI_BAD_BUFFER_SIZE;
   }
 
-  // Pick 128bytes as a good start for word operations as opposed to erasing the
-  // block and writing the data regardless if an erase is really needed.
-  // It looks like most individual NV variable writes are smaller than 128bytes.
-  if (*NumBytes <= 128) {
-    // Check to see if we need to erase before programming the data into NOR.
-    // If the destination bits are only changing from 1s to 0s we can just write.
-    // After a block is erased all bits in the block is set to 1.
-    // If any byte requires us to erase we just give up and rewrite all of it.
-    DoErase      = FALSE;
-    BytesToWrite = *NumBytes;
-    CurOffset    = Offset;
-
-    while (BytesToWrite > 0) {
-      // Read full word from NOR, splice as required. A word is the smallest
-      // unit we can write.
-      TempStatus = NorFlashRead (Instance, Lba, CurOffset & ~(0x3), sizeof(Tmp),
-                     &Tmp);
-      if (EFI_ERROR (TempStatus)) {
-        return EFI_DEVICE_ERROR;
-      }
+  //
+  // Check to see if we need to erase before programming the data into NOR.
+  // If the destination bits are only changing from 1s to 0s we can just write.
+  // After a block is erased all bits in the block is set to 1.
+  // Snapshot the affected words of the block from the memory-mapped region
+  // into the shadow buffer in one go, and compare whole words against the
+  // merged new contents, so this works for writes of any size.
+  //
+  if (Instance->ShadowBuffer == NULL) {
+    DEBUG ((DEBUG_ERROR, "FvbWrite: ERROR - Buffer not ready\n"));
+    return EFI_DEVICE_ERROR;
+  }
 
-      // Physical address of word in NOR to write.
-      WordAddr = (CurOffset & ~(0x3)) +
-                 GET_NOR_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba,
-                   BlockSize);
-
-      // The word of data that is to be written.
-      TmpBuf = ReadUnaligned32 ((UINT32 *)(Buffer + (*NumBytes - BytesToWrite)));
-
-      // First do word aligned chunks.
-      if ((CurOffset & 0x3) == 0) {
-        if (BytesToWrite >= 4) {
-          // Is the destination still in 'erased' state?
-          if (~Tmp != 0) {
-            // Check to see if we are only changing bits to zero.
-            if ((Tmp ^ TmpBuf) & TmpBuf) {
-              DoErase = TRUE;
-              break;
-            }
-          }
-          // Write this word to NOR
-          WordToWrite = TmpBuf;
-          CurOffset += sizeof(TmpBuf);
-          BytesToWrite -= sizeof(TmpBuf);
-        } else {
-          // BytesToWrite < 4. Do small writes and left-overs
-          Mask = ~((~0) << (BytesToWrite * 8));
-          // Mask out the bytes we want.
-          TmpBuf &= Mask;
-          // Is the destination still in 'erased' state?
-          if ((Tmp & Mask) != Mask) {
-            // Check to see if we are only changing bits to zero.
-            if ((Tmp ^ TmpBuf) & TmpBuf) {
-              DoErase = TRUE;
-              break;
-            }
-          }
-          // Merge old and new data. Write merged word to NOR
-          WordToWrite = (Tmp & ~Mask) | TmpBuf;
-          CurOffset += BytesToWrite;
-          BytesToWrite = 0;
-        }
-      } else {
-        // Do multiple words, but starting unaligned.
-        if (BytesToWrite > (4 - (CurOffset & 0x3))) {
-          Mask = ((~0) << ((CurOffset & 0x3) * 8));
-          // Mask out the bytes we want.
-          TmpBuf &= Mask;
-          // Is the destination still in 'erased' state?
-          if ((Tmp & Mask) != Mask) {
-            // Check to see if we are only changing bits to zero.
-            if ((Tmp ^ TmpBuf) & TmpBuf) {
-              DoErase = TRUE;
-              break;
-            }
-          }
-          // Merge old and new data. Write merged word to NOR
-          WordToWrite = (Tmp & ~Mask) | TmpBuf;
-          BytesToWrite -= (4 - (CurOffset & 0x3));
-          CurOffset += (4 - (CurOffset & 0x3));
-        } else {
-          // Unaligned and fits in one word.
-          Mask = (~((~0) << (BytesToWrite * 8))) << ((CurOffset & 0x3) * 8);
-          // Mask out the bytes we want.
-          TmpBuf = (TmpBuf << ((CurOffset & 0x3) * 8)) & Mask;
-          // Is the destination still in 'erased' state?
-          if ((Tmp & Mask) != Mask) {
-            // Check to see if we are only changing bits to zero.
-            if ((Tmp ^ TmpBuf) & TmpBuf) {
-              DoErase = TRUE;
-              break;
-            }
-          }
-          // Merge old and new data. Write merged word to NOR
-          WordToWrite = (Tmp & ~Mask) | TmpBuf;
-          CurOffset += BytesToWrite;
-          BytesToWrite = 0;
-        }
-      }
+  FirstWordOffset = Offset & ~(sizeof (UINT32) - 1);
+  EndWordOffset   = ALIGN_VALUE (Offset + *NumBytes, sizeof (UINT32));
+  OldWords = (UINT32 *)((UINTN)Instance->ShadowBuffer + FirstWordOffset);
 
-      //
-      // Write the word to NOR.
-      //
-
-      BlockAddress = GET_NOR_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba,
-        BlockSize);
-      if (BlockAddress != PrevBlockAddress) {
-        TempStatus = NorFlashUnlockSingleBlockIfNecessary (Instance,
-                       BlockAddress);
-        if (EFI_ERROR (TempStatus)) {
-          return EFI_DEVICE_ERROR;
-        }
-        PrevBlockAddress = BlockAddress;
+  TempStatus = NorFlashRead (Instance, Lba, FirstWordOffset,
+                 EndWordOffset - FirstWordOffset, OldWords);
+  if (EFI_ERROR (TempStatus)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  DoErase = FALSE;
+  NeedWrite = FALSE;
+  for (CurOffset = FirstWordOffset, Index = 0;
+       CurOffset < EndWordOffset;
+       CurOffset += sizeof (UINT32), Index++) {
+    WordToWrite = NorFlashMergeWord (OldWords[Index], CurOffset, Offset,
+                    *NumBytes, Buffer);
+    // Setting any bit from 0 back to 1 requires an erase
+    if ((~OldWords[Index] & WordToWrite) != 0) {
+      DoErase = TRUE;
+      break;
+    }
+    if (WordToWrite != OldWords[Index]) {
+      NeedWrite = TRUE;
+    }
+  }
+
+  if (!DoErase) {
+    // Nothing to do if the flash already holds the new data
+    if (!NeedWrite) {
+      return EFI_SUCCESS;
+    }
+
+    BlockAddress = GET_NOR_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba,
+                     BlockSize);
+    TempStatus = NorFlashUnlockSingleBlockIfNecessary (Instance, BlockAddress);
+    if (EFI_ERROR (TempStatus)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    // Only program the words that actually change
+    for (CurOffset = FirstWordOffset, Index = 0;
+         CurOffset < EndWordOffset;
+         CurOffset += sizeof (UINT32), Index++) {
+      WordToWrite = NorFlashMergeWord (OldWords[Index], CurOffset, Offset,
+                      *NumBytes, Buffer);
+      if (WordToWrite == OldWords[Index]) {
+        continue;
       }
-      TempStatus = NorFlashWriteSingleWord (Instance, WordAddr, WordToWrite);
+      TempStatus = NorFlashWriteSingleWord (Instance, BlockAddress + CurOffset,
+                     WordToWrite);
       if (EFI_ERROR (TempStatus)) {
         return EFI_DEVICE_ERROR;
       }
     }
-    // Exit if we got here and could write all the data. Otherwise do the
-    // Erase-Write cycle.
-    if (!DoErase) {
-      return EFI_SUCCESS;
-    }
-  }
-
-  // Check we did get some memory. Buffer is BlockSize.
-  if (Instance->ShadowBuffer == NULL) {
-    DEBUG ((DEBUG_ERROR, "FvbWrite: ERROR - Buffer not ready\n"));
-    return EFI_DEVICE_ERROR;
+    return EFI_SUCCESS;
   }
 
   // Read NOR Flash data into shadow buffer
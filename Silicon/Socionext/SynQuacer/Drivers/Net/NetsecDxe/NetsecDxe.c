@@ -262,6 +262,37 @@ Fail:
   return ErrorStatus;
 }
 
+/*
+ *  Return the TX packet handles of all frames the hardware has completed to
+ *  the free list, whether or not their buffers were collected by the caller
+ *  through GetStatus (). Used when the interface is shut down or brought up
+ *  again, as callers do not recycle buffers across those transitions.
+ */
+STATIC
+VOID
+NetsecReclaimTxPackets (
+  IN  NETSEC_DRIVER   *LanDriver
+  )
+{
+  pfdep_pkt_handle_t        pkt_handle;
+  LIST_ENTRY                *Link;
+  LIST_ENTRY                *Next;
+
+  ogma_clean_tx_desc_ring (LanDriver->Handle, OGMA_DESC_RING_ID_NRM_TX);
+
+  for (Link = GetFirstNode (&LanDriver->TxBufferList);
+       !IsNull (&LanDriver->TxBufferList, Link);
+       Link = Next) {
+
+    Next = GetNextNode (&LanDriver->TxBufferList, Link);
+    pkt_handle = BASE_CR (Link, PACKET_HANDLE, Link);
+    if (pkt_handle->Released) {
+      RemoveEntryList (Link);
+      InsertTailList (&LanDriver->TxFreeList, &pkt_handle->Link);
+    }
+  }
+}
+
 /*
  *  UEFI Initialize() function
  */
@@ -326,6 +357,9 @@ SnpInitialize (
     ReturnUnlock (EFI_DEVICE_ERROR);
   }
 
+  // Drop the packet handles of frames completed since the last Shutdown ()
+  NetsecReclaimTxPackets (LanDriver);
+
   ogma_clear_desc_ring_irq_status (LanDriver->Handle, OGMA_DESC_RING_ID_NRM_TX,
                                    OGMA_CH_IRQ_REG_EMPTY);
 
@@ -420,6 +454,12 @@ SnpShutdown (
   ogma_stop_desc_ring (LanDriver->Handle, OGMA_DESC_RING_ID_NRM_RX);
   ogma_stop_desc_ring (LanDriver->Handle, OGMA_DESC_RING_ID_NRM_TX);
 
+  //
+  // Return the in-flight TX packet handles to the preallocated pool. Frames
+  // still queued on the stopped ring are reclaimed by the next Initialize ().
+  //
+  NetsecReclaimTxPackets (LanDriver);
+
   Snp->Mode->State = EfiSimpleNetworkStarted;
   Status = EFI_SUCCESS;
 
@@ -656,7 +696,7 @@ SnpGetStatus (
       if (pkt_handle->Released) {
         *TxBuff = pkt_handle->Buffer;
         RemoveEntryList (Link);
-        FreePool (pkt_handle);
+        InsertTailList (&LanDriver->TxFreeList, &pkt_handle->Link);
         break;
       }
     }
@@ -696,10 +736,10 @@ SnpTransmit (
 
   ogma_tx_pkt_ctrl_t  tx_pkt_ctrl;
   ogma_frag_info_t    scat_info;
-  ogma_uint16         tx_avail_num;
   ogma_err_t          ogma_err;
   UINT16              Proto;
   pfdep_pkt_handle_t  pkt_handle;
+  UINTN               Slot;
 
   // Check preliminaries
   if ((Snp == NULL) || (BufAddr == NULL)) {
@@ -708,14 +748,6 @@ SnpTransmit (
     return EFI_DEVICE_ERROR;
   }
 
-  pkt_handle = AllocateZeroPool (sizeof (*pkt_handle));
-  if (pkt_handle == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  pkt_handle->Buffer = BufAddr;
-  pkt_handle->RecycleForTx = TRUE;
-
   // Serialize access to data and registers
   SavedTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
@@ -748,13 +780,34 @@ SnpTransmit (
     ReturnUnlock (EFI_DEVICE_ERROR);
   }
 
-  ogma_err = ogma_clean_tx_desc_ring (LanDriver->Handle,
-                                      OGMA_DESC_RING_ID_NRM_TX);
-  if (ogma_err != OGMA_ERR_OK) {
-    DEBUG ((DEBUG_ERROR,
-      "NETSEC: ogma_clean_tx_desc_ring failed with error code: %d\n",
-      (INT32)ogma_err));
-    ReturnUnlock (EFI_DEVICE_ERROR);
+  //
+  // Only reap completed descriptors when the ring has run out of room, so
+  // that back-to-back transmits are not each paying for a full ring walk.
+  // GetStatus () cleans the ring unconditionally.
+  //
+  if (ogma_get_tx_avail_num (LanDriver->Handle,
+                             OGMA_DESC_RING_ID_NRM_TX) < SCAT_NUM) {
+    ogma_err = ogma_clean_tx_desc_ring (LanDriver->Handle,
+                                        OGMA_DESC_RING_ID_NRM_TX);
+    if (ogma_err != OGMA_ERR_OK) {
+      DEBUG ((DEBUG_ERROR,
+        "NETSEC: ogma_clean_tx_desc_ring failed with error code: %d\n",
+        (INT32)ogma_err));
+      ReturnUnlock (EFI_DEVICE_ERROR);
+    }
+
+    if (ogma_get_tx_avail_num (LanDriver->Handle,
+                               OGMA_DESC_RING_ID_NRM_TX) < SCAT_NUM) {
+      ReturnUnlock (EFI_NOT_READY);
+    }
+  }
+
+  //
+  // Packet handles only return to the free list once GetStatus () has
+  // handed the buffer back to the caller.
+  //
+  if (IsListEmpty (&LanDriver->TxFreeList)) {
+    ReturnUnlock (EFI_NOT_READY);
   }
 
   // Ensure header is correct size if non-zero
@@ -789,13 +842,28 @@ SnpTransmit (
       );
   }
 
-  Status = DmaMap (MapOperationBusMasterRead, BufAddr, &BufSize,
-             &scat_info.phys_addr, &pkt_handle->Mapping);
-  if (EFI_ERROR (Status)) {
-    goto ExitUnlock;
-  }
+  pkt_handle = BASE_CR (GetFirstNode (&LanDriver->TxFreeList),
+                 PACKET_HANDLE, Link);
+  Slot = pkt_handle - LanDriver->TxPacketPool;
 
-  scat_info.addr        = BufAddr;
+  pkt_handle->Buffer = BufAddr;
+  pkt_handle->Mapping = NULL;
+  pkt_handle->Released = FALSE;
+
+  if (BufSize <= TX_BOUNCE_SLOT_SIZE) {
+    scat_info.addr      = (VOID *)((UINTN)LanDriver->TxBounceBuffer +
+                                   Slot * TX_BOUNCE_SLOT_SIZE);
+    scat_info.phys_addr = LanDriver->TxBouncePhysAddr +
+                          Slot * TX_BOUNCE_SLOT_SIZE;
+    CopyMem (scat_info.addr, BufAddr, BufSize);
+  } else {
+    Status = DmaMap (MapOperationBusMasterRead, BufAddr, &BufSize,
+               &scat_info.phys_addr, &pkt_handle->Mapping);
+    if (EFI_ERROR (Status)) {
+      goto ExitUnlock;
+    }
+    scat_info.addr      = BufAddr;
+  }
   scat_info.len         = BufSize;
 
   SetMem (&tx_pkt_ctrl, sizeof (ogma_tx_pkt_ctrl_t), 0);
@@ -803,12 +871,6 @@ SnpTransmit (
   tx_pkt_ctrl.pass_through_flag     = OGMA_TRUE;
   tx_pkt_ctrl.target_desc_ring_id   = OGMA_DESC_RING_ID_GMAC;
 
-  // check empty slot
-  do {
-    tx_avail_num = ogma_get_tx_avail_num (LanDriver->Handle,
-                                          OGMA_DESC_RING_ID_NRM_TX);
-  } while (tx_avail_num < SCAT_NUM);
-
   // send
   ogma_err = ogma_set_tx_pkt_data (LanDriver->Handle,
                                    OGMA_DESC_RING_ID_NRM_TX,
@@ -818,8 +880,10 @@ SnpTransmit (
                                    pkt_handle);
 
   if (ogma_err != OGMA_ERR_OK) {
-    DmaUnmap (pkt_handle->Mapping);
-    FreePool (pkt_handle);
+    if (pkt_handle->Mapping != NULL) {
+      DmaUnmap (pkt_handle->Mapping);
+      pkt_handle->Mapping = NULL;
+    }
     DEBUG ((DEBUG_ERROR,
       "NETSEC: ogma_set_tx_pkt_data failed with error code: %d\n",
       (INT32)ogma_err));
@@ -830,14 +894,13 @@ SnpTransmit (
   // Queue the descriptor so we can release the buffer once it has been
   // consumed by the hardware.
   //
+  RemoveEntryList (&pkt_handle->Link);
   InsertTailList (&LanDriver->TxBufferList, &pkt_handle->Link);
 
-  gBS->RestoreTPL (SavedTpl);
-  return EFI_SUCCESS;
+  Status = EFI_SUCCESS;
 
   // Restore TPL and return
 ExitUnlock:
-  FreePool (pkt_handle);
   gBS->RestoreTPL (SavedTpl);
   return Status;
 }
@@ -923,12 +986,6 @@ SnpReceive (
     *HdrSize = LanDriver->SnpMode.MediaHeaderSize;
   }
 
-  ogma_clear_desc_ring_irq_status (LanDriver->Handle,
-                                   OGMA_DESC_RING_ID_NRM_TX,
-                                   OGMA_CH_IRQ_REG_EMPTY);
-
-  ogma_clean_tx_desc_ring (LanDriver->Handle, OGMA_DESC_RING_ID_NRM_TX);
-
   ogma_enable_top_irq (LanDriver->Handle,
                        OGMA_TOP_IRQ_REG_NRM_TX | OGMA_TOP_IRQ_REG_NRM_RX);
 
@@ -1040,6 +1097,7 @@ NetsecInit (
   NETSEC_DRIVER                     *LanDriver;
   EFI_SIMPLE_NETWORK_PROTOCOL       *Snp;
   EFI_SIMPLE_NETWORK_MODE           *SnpMode;
+  UINTN                             Index;
 
   // Allocate Resources
   LanDriver = AllocateZeroPool (sizeof (NETSEC_DRIVER));
@@ -1136,6 +1194,30 @@ NetsecInit (
   SetMem (&SnpMode->BroadcastAddress, sizeof (EFI_MAC_ADDRESS), 0xFF);
 
   InitializeListHead (&LanDriver->TxBufferList);
+  InitializeListHead (&LanDriver->TxFreeList);
+
+  // Preallocate the TX packet handles and their pre-mapped bounce slots
+  LanDriver->TxPacketPoolSize = FixedPcdGet16 (PcdEncTxDescNum);
+  LanDriver->TxPacketPool = AllocateZeroPool (LanDriver->TxPacketPoolSize *
+                                              sizeof (PACKET_HANDLE));
+  if (LanDriver->TxPacketPool == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto TerminateOgma;
+  }
+
+  if (pfdep_dma_malloc (LanDriver->Handle,
+        (pfdep_uint32)(LanDriver->TxPacketPoolSize * TX_BOUNCE_SLOT_SIZE),
+        &LanDriver->TxBounceBuffer,
+        &LanDriver->TxBouncePhysAddr) != PFDEP_ERR_OK) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto FreePacketPool;
+  }
+
+  for (Index = 0; Index < LanDriver->TxPacketPoolSize; Index++) {
+    LanDriver->TxPacketPool[Index].RecycleForTx = TRUE;
+    InsertTailList (&LanDriver->TxFreeList,
+      &LanDriver->TxPacketPool[Index].Link);
+  }
 
   // Initialise the protocol
   Status = gBS->InstallMultipleProtocolInterfaces (
@@ -1150,11 +1232,21 @@ NetsecInit (
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: InstallMultipleProtocolInterfaces failed - %r\n",
       __FUNCTION__, Status));
-    ogma_terminate (LanDriver->Handle);
-    goto CloseDeviceProtocol;
+    goto FreeBounceBuffer;
   }
   return EFI_SUCCESS;
 
+FreeBounceBuffer:
+  pfdep_dma_free (LanDriver->Handle,
+    (pfdep_uint32)(LanDriver->TxPacketPoolSize * TX_BOUNCE_SLOT_SIZE),
+    LanDriver->TxBounceBuffer, LanDriver->TxBouncePhysAddr);
+
+FreePacketPool:
+  FreePool (LanDriver->TxPacketPool);
+
+TerminateOgma:
+  ogma_terminate (LanDriver->Handle);
+
 CloseDeviceProtocol:
   gBS->CloseProtocol (ControllerHandle,
          &gEdkiiNonDiscoverableDeviceProtocolGuid, DriverBindingHandle,
@@ -1199,6 +1291,11 @@ NetsecRelease (
 
   ogma_terminate (LanDriver->Handle);
 
+  pfdep_dma_free (LanDriver->Handle,
+    (pfdep_uint32)(LanDriver->TxPacketPoolSize * TX_BOUNCE_SLOT_SIZE),
+    LanDriver->TxBounceBuffer, LanDriver->TxBouncePhysAddr);
+  FreePool (LanDriver->TxPacketPool);
+
   gBS->CloseEvent (LanDriver->ExitBootEvent);
 
   Status = gBS->CloseProtocol (ControllerHandle,
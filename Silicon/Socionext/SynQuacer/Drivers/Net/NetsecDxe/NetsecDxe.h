@@ -61,6 +61,16 @@ typedef struct {
   // List of submitted TX buffers
   LIST_ENTRY                        TxBufferList;
 
+  // Preallocated TX packet handles, one per TX descriptor, and the list of
+  // those not currently submitted
+  PACKET_HANDLE                     *TxPacketPool;
+  UINTN                             TxPacketPoolSize;
+  LIST_ENTRY                        TxFreeList;
+
+  // Pre-mapped TX bounce slots, one per packet handle
+  VOID                              *TxBounceBuffer;
+  EFI_PHYSICAL_ADDRESS              TxBouncePhysAddr;
+
   EFI_EVENT                         ExitBootEvent;
 
   EFI_EVENT                         PhyStatusEvent;
@@ -103,6 +113,10 @@ NetsecRelease (
 
 #define SCAT_NUM                    1
 
+// Frames up to this size are copied into a pre-mapped bounce slot, larger
+// ones are mapped in place
+#define TX_BOUNCE_SLOT_SIZE         2048
+
 #define RXINT_TMR_CNT_US            0
 #define RXINT_PKTCNT                1
 
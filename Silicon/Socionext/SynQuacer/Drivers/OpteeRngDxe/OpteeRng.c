@@ -1,12 +1,19 @@
 /** @file
   Device driver for the OpteeRng hardware random number generator.
 
+  The RNG pseudo trusted application session is opened once at entry and kept
+  for the duration of the boot. A periodic timer tops up a full entropy pool
+  from it in the background, and an SP800-90A HMAC_DRBG (HMAC-SHA256) seeded
+  and reseeded from that pool is exposed as the default algorithm. The raw
+  algorithm remains available for callers that need full entropy output.
+
   Copyright (c) 2018, Linaro Ltd. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
+#include <Library/BaseCryptLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
@@ -18,6 +25,367 @@
 #define PTA_COMMAND_GET_ENTROPY  0x0
 #define OPTEE_RNG_POOL_SIZE      (4 * 1024)
 
+//
+// OP-TEE RNG Trusted application takes approximately 256ms for every 32
+// bytes of full entropy output, so poll it at that rate to fill the pool.
+//
+#define OPTEE_RNG_FILL_PERIOD    EFI_TIMER_PERIOD_MILLISECONDS (256)
+#define OPTEE_RNG_FILL_SIZE      64
+
+#define DRBG_OUTLEN              SHA256_DIGEST_SIZE
+#define DRBG_SEED_SIZE           (DRBG_OUTLEN + DRBG_OUTLEN / 2)
+#define DRBG_RESEED_SIZE         DRBG_OUTLEN
+#define DRBG_MAX_REQUEST_SIZE    SIZE_64KB
+#define DRBG_RESEED_INTERVAL     1024
+
+STATIC UINT32     mSession;
+STATIC BOOLEAN    mSessionOpen;
+STATIC EFI_EVENT  mPoolFillEvent;
+STATIC EFI_EVENT  mExitBootServicesEvent;
+
+STATIC UINT8      mEntropyPool[OPTEE_RNG_POOL_SIZE];
+STATIC UINTN      mEntropyPoolFill;
+
+STATIC VOID       *mDrbgHmacContext;
+STATIC UINT8      mDrbgKey[DRBG_OUTLEN];
+STATIC UINT8      mDrbgV[DRBG_OUTLEN];
+STATIC UINTN      mDrbgReseedCounter;
+STATIC BOOLEAN    mDrbgInstantiated;
+
+STATIC EFI_RNG_ALGORITHM  *mAlgorithms[] = {
+  &gEfiRngAlgorithmSp80090Hmac256Guid,
+  &gEfiRngAlgorithmRaw
+};
+
+/**
+  Ask the RNG trusted application for up to Size bytes of entropy over the
+  persistent session. Must be called at TPL_NOTIFY, which serializes the
+  OP-TEE message buffer between the pool fill timer and GetRNG callers.
+
+  @param[out] Buffer          Buffer receiving the entropy.
+  @param[in]  Size            Maximum number of bytes to return.
+  @param[out] OutSize         Number of bytes actually returned.
+
+  @retval EFI_SUCCESS         The call succeeded; OutSize may be zero.
+  @retval EFI_DEVICE_ERROR    The session is closed or the call failed.
+
+**/
+STATIC
+EFI_STATUS
+OpteeRngInvoke (
+  OUT UINT8     *Buffer,
+  IN  UINTN     Size,
+  OUT UINTN     *OutSize
+  )
+{
+  EFI_STATUS                 Status;
+  OPTEE_INVOKE_FUNCTION_ARG  InvokeFunctionArg;
+
+  *OutSize = 0;
+
+  if (!mSessionOpen) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  ZeroMem (&InvokeFunctionArg, sizeof (OPTEE_INVOKE_FUNCTION_ARG));
+
+  InvokeFunctionArg.Function = PTA_COMMAND_GET_ENTROPY;
+  InvokeFunctionArg.Session = mSession;
+
+  InvokeFunctionArg.Params[0].Attribute =
+    OPTEE_MESSAGE_ATTRIBUTE_TYPE_MEMORY_INOUT;
+  InvokeFunctionArg.Params[0].Union.Memory.BufferAddress = (UINTN) Buffer;
+  InvokeFunctionArg.Params[0].Union.Memory.Size = Size;
+
+  Status = OpteeInvokeFunction (&InvokeFunctionArg);
+  if ((Status != EFI_SUCCESS) ||
+      (InvokeFunctionArg.Return != OPTEE_SUCCESS)) {
+    DEBUG ((DEBUG_ERROR, "OP-TEE Invoke Function failed with return: %x and"
+      "return origin: %d\n", InvokeFunctionArg.Return,
+      InvokeFunctionArg.ReturnOrigin));
+    return EFI_DEVICE_ERROR;
+  }
+
+  *OutSize = MIN (InvokeFunctionArg.Params[0].Union.Memory.Size, Size);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Periodic timer notification that tops up the entropy pool with whatever
+  the trusted application has accumulated since the previous tick.
+
+  @param[in] Event            The timer event.
+  @param[in] Context          Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+OpteeRngFillPool (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       OutSize;
+
+  if (mEntropyPoolFill == OPTEE_RNG_POOL_SIZE) {
+    return;
+  }
+
+  Status = OpteeRngInvoke (&mEntropyPool[mEntropyPoolFill],
+             MIN (OPTEE_RNG_FILL_SIZE, OPTEE_RNG_POOL_SIZE - mEntropyPoolFill),
+             &OutSize);
+  if (EFI_ERROR (Status)) {
+    //
+    // Stop polling; GetRNG will report the failure on direct access.
+    //
+    gBS->SetTimer (mPoolFillEvent, TimerCancel, 0);
+    return;
+  }
+
+  mEntropyPoolFill += OutSize;
+}
+
+/**
+  Collect Length bytes of full entropy output, draining the pool first and
+  invoking the trusted application directly for the remainder.
+
+  @param[out] Buffer          Buffer receiving the entropy.
+  @param[in]  Length          Number of bytes to collect.
+
+  @retval EFI_SUCCESS         Length bytes were returned.
+  @retval EFI_DEVICE_ERROR    The trusted application failed.
+
+**/
+STATIC
+EFI_STATUS
+OpteeRngGetEntropy (
+  OUT UINT8     *Buffer,
+  IN  UINTN     Length
+  )
+{
+  EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
+  UINTN       Size;
+  UINTN       OutSize;
+  UINTN       WaitMiliSeconds;
+
+  while (Length > 0) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+    if (mEntropyPoolFill > 0) {
+      //
+      // Consume from the tail of the pool and wipe what was handed out.
+      //
+      Size = MIN (Length, mEntropyPoolFill);
+      mEntropyPoolFill -= Size;
+      CopyMem (Buffer, &mEntropyPool[mEntropyPoolFill], Size);
+      ZeroMem (&mEntropyPool[mEntropyPoolFill], Size);
+      OutSize = Size;
+      Status = EFI_SUCCESS;
+    } else {
+      Size = MIN (Length, OPTEE_RNG_POOL_SIZE);
+      Status = OpteeRngInvoke (Buffer, Size, &OutSize);
+    }
+
+    gBS->RestoreTPL (OldTpl);
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Buffer += OutSize;
+    Length -= OutSize;
+
+    if (Length > 0 && OutSize < Size) {
+      //
+      // The trusted application ran dry: wait for it to generate the missing
+      // bytes before asking again.
+      //
+      WaitMiliSeconds = ((MIN (Length, OPTEE_RNG_POOL_SIZE) + 31) / 32) * 256;
+      MicroSecondDelay (WaitMiliSeconds * 1000);
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Compute HMAC-SHA256 (Key, Data || [Separator] || [Provided]).
+
+  @retval TRUE                The digest was computed.
+  @retval FALSE               The crypto library failed.
+
+**/
+STATIC
+BOOLEAN
+DrbgHmac (
+  IN  CONST UINT8   *Key,
+  IN  CONST UINT8   *Data,
+  IN  CONST UINT8   *Separator  OPTIONAL,
+  IN  CONST UINT8   *Provided   OPTIONAL,
+  IN  UINTN         ProvidedSize,
+  OUT UINT8         *Digest
+  )
+{
+  if (!HmacSha256SetKey (mDrbgHmacContext, Key, DRBG_OUTLEN) ||
+      !HmacSha256Update (mDrbgHmacContext, Data, DRBG_OUTLEN)) {
+    return FALSE;
+  }
+  if (Separator != NULL &&
+      !HmacSha256Update (mDrbgHmacContext, Separator, 1)) {
+    return FALSE;
+  }
+  if (ProvidedSize > 0 &&
+      !HmacSha256Update (mDrbgHmacContext, Provided, ProvidedSize)) {
+    return FALSE;
+  }
+  return HmacSha256Final (mDrbgHmacContext, Digest);
+}
+
+/**
+  HMAC_DRBG_Update process from SP800-90A section 10.1.2.2.
+
+  @param[in] Provided         Provided data, may be NULL.
+  @param[in] ProvidedSize     Size of the provided data in bytes.
+
+  @retval TRUE                The internal state was updated.
+  @retval FALSE               The crypto library failed.
+
+**/
+STATIC
+BOOLEAN
+DrbgUpdate (
+  IN CONST UINT8  *Provided OPTIONAL,
+  IN UINTN        ProvidedSize
+  )
+{
+  STATIC CONST UINT8  Zero = 0x00;
+  STATIC CONST UINT8  One = 0x01;
+
+  if (!DrbgHmac (mDrbgKey, mDrbgV, &Zero, Provided, ProvidedSize, mDrbgKey) ||
+      !DrbgHmac (mDrbgKey, mDrbgV, NULL, NULL, 0, mDrbgV)) {
+    return FALSE;
+  }
+  if (ProvidedSize == 0) {
+    return TRUE;
+  }
+  return DrbgHmac (mDrbgKey, mDrbgV, &One, Provided, ProvidedSize, mDrbgKey) &&
+         DrbgHmac (mDrbgKey, mDrbgV, NULL, NULL, 0, mDrbgV);
+}
+
+/**
+  Instantiate the DRBG, or reseed it if it is already instantiated, from the
+  entropy pool.
+
+  @retval EFI_SUCCESS         The DRBG is seeded.
+  @retval EFI_DEVICE_ERROR    Entropy could not be collected, or the crypto
+                              library failed.
+
+**/
+STATIC
+EFI_STATUS
+DrbgSeed (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
+  UINT8       Seed[DRBG_SEED_SIZE];
+  UINTN       SeedSize;
+  BOOLEAN     Success;
+
+  //
+  // Instantiation takes entropy input and a nonce, reseeding only the former.
+  //
+  SeedSize = mDrbgInstantiated ? DRBG_RESEED_SIZE : DRBG_SEED_SIZE;
+
+  Status = OpteeRngGetEntropy (Seed, SeedSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if (!mDrbgInstantiated) {
+    SetMem (mDrbgKey, sizeof (mDrbgKey), 0x00);
+    SetMem (mDrbgV, sizeof (mDrbgV), 0x01);
+  }
+  Success = DrbgUpdate (Seed, SeedSize);
+  mDrbgInstantiated = Success;
+  mDrbgReseedCounter = 1;
+
+  gBS->RestoreTPL (OldTpl);
+
+  ZeroMem (Seed, sizeof (Seed));
+
+  return Success ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+/**
+  Produce Length bytes of DRBG output, reseeding from the entropy pool when
+  the reseed interval is reached.
+
+  @param[out] Value           Buffer receiving the output.
+  @param[in]  Length          Number of bytes to produce.
+
+  @retval EFI_SUCCESS         Length bytes were returned.
+  @retval EFI_DEVICE_ERROR    Seeding or generation failed.
+
+**/
+STATIC
+EFI_STATUS
+DrbgGenerate (
+  OUT UINT8     *Value,
+  IN  UINTN     Length
+  )
+{
+  EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
+  UINTN       Request;
+  UINTN       Size;
+  BOOLEAN     Success;
+
+  while (Length > 0) {
+    if (!mDrbgInstantiated || mDrbgReseedCounter > DRBG_RESEED_INTERVAL) {
+      Status = DrbgSeed ();
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
+    Request = MIN (Length, DRBG_MAX_REQUEST_SIZE);
+    Length -= Request;
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+    Success = TRUE;
+    while (Success && Request > 0) {
+      Success = DrbgHmac (mDrbgKey, mDrbgV, NULL, NULL, 0, mDrbgV);
+      Size = MIN (Request, DRBG_OUTLEN);
+      CopyMem (Value, mDrbgV, Size);
+      Value += Size;
+      Request -= Size;
+    }
+    Success = Success && DrbgUpdate (NULL, 0);
+    mDrbgReseedCounter++;
+
+    if (!Success) {
+      mDrbgInstantiated = FALSE;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+
+    if (!Success) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Returns information about the random number generation implementation.
 
@@ -57,18 +425,22 @@ GetInfo (
 )
 {
   UINTN Size;
+  UINTN Index;
 
   //
-  // We only implement the raw algorithm
+  // The HMAC DRBG is the default, the raw algorithm bypasses it
   //
-  Size = sizeof gEfiRngAlgorithmRaw;
+  Size = ARRAY_SIZE (mAlgorithms) * sizeof (EFI_RNG_ALGORITHM);
 
   if (*AlgorithmListSize < Size) {
     *AlgorithmListSize = Size;
     return EFI_BUFFER_TOO_SMALL;
   }
 
-  gBS->CopyMem (AlgorithmList, &gEfiRngAlgorithmRaw, Size);
+  for (Index = 0; Index < ARRAY_SIZE (mAlgorithms); Index++) {
+    gBS->CopyMem (&AlgorithmList[Index], mAlgorithms[Index],
+           sizeof (EFI_RNG_ALGORITHM));
+  }
   *AlgorithmListSize = Size;
 
   return EFI_SUCCESS;
@@ -111,80 +483,20 @@ GetRNG (
   OUT UINT8             *Value
 )
 {
-  EFI_STATUS                 Status;
-  OPTEE_OPEN_SESSION_ARG     OpenSessionArg;
-  OPTEE_INVOKE_FUNCTION_ARG  InvokeFunctionArg;
-  UINT8                      *OutPointer;
-  UINTN                      OutSize;
-  UINTN                      WaitMiliSeconds;
-
   if ((Value == NULL) || (ValueLength == 0)) {
     return EFI_INVALID_PARAMETER;
   }
 
-  if (ValueLength > OPTEE_RNG_POOL_SIZE) {
-    return EFI_UNSUPPORTED;
+  if (Algorithm == NULL ||
+      CompareGuid (Algorithm, &gEfiRngAlgorithmSp80090Hmac256Guid)) {
+    return DrbgGenerate (Value, ValueLength);
   }
 
-  if (Algorithm != NULL && !CompareGuid (Algorithm, &gEfiRngAlgorithmRaw)) {
-    return EFI_UNSUPPORTED;
+  if (CompareGuid (Algorithm, &gEfiRngAlgorithmRaw)) {
+    return OpteeRngGetEntropy (Value, ValueLength);
   }
 
-  ZeroMem (&OpenSessionArg, sizeof (OPTEE_OPEN_SESSION_ARG));
-  CopyMem (&OpenSessionArg.Uuid, &gOpteeRngTaGuid, sizeof (EFI_GUID));
-
-  Status = OpteeOpenSession (&OpenSessionArg);
-  if ((Status != EFI_SUCCESS) || (OpenSessionArg.Return != OPTEE_SUCCESS)) {
-    DEBUG ((DEBUG_ERROR, "OP-TEE Open Session failed with return: %08x and"
-      "return origin: %d\n", OpenSessionArg.Return,
-      OpenSessionArg.ReturnOrigin));
-    return EFI_DEVICE_ERROR;
-  }
-
-  OutPointer = Value;
-
-  while (ValueLength > 0) {
-    ZeroMem (&InvokeFunctionArg, sizeof (OPTEE_INVOKE_FUNCTION_ARG));
-
-    InvokeFunctionArg.Function = PTA_COMMAND_GET_ENTROPY;
-    InvokeFunctionArg.Session = OpenSessionArg.Session;
-
-    InvokeFunctionArg.Params[0].Attribute =
-      OPTEE_MESSAGE_ATTRIBUTE_TYPE_MEMORY_INOUT;
-    InvokeFunctionArg.Params[0].Union.Memory.BufferAddress =
-      (UINTN) OutPointer;
-    InvokeFunctionArg.Params[0].Union.Memory.Size = ValueLength;
-
-    Status = OpteeInvokeFunction (&InvokeFunctionArg);
-    if ((Status != EFI_SUCCESS) ||
-        (InvokeFunctionArg.Return != OPTEE_SUCCESS)) {
-      DEBUG ((DEBUG_ERROR, "OP-TEE Invoke Function failed with return: %x and"
-        "return origin: %d\n", InvokeFunctionArg.Return,
-        InvokeFunctionArg.ReturnOrigin));
-
-      OpteeCloseSession (OpenSessionArg.Session);
-
-      return EFI_DEVICE_ERROR;
-    }
-
-    OutSize = MIN (InvokeFunctionArg.Params[0].Union.Memory.Size, ValueLength);
-
-    OutPointer += OutSize;
-    ValueLength -= OutSize;
-
-    //
-    // OP-TEE RNG Trusted application takes approximately 256ms for every 32
-    // bytes of full entropy output.
-    //
-    if (ValueLength > 0) {
-      WaitMiliSeconds = ((ValueLength + 32) * 256) / 32;
-      MicroSecondDelay (WaitMiliSeconds * 1000);
-    }
-  }
-
-  OpteeCloseSession (OpenSessionArg.Session);
-
-  return EFI_SUCCESS;
+  return EFI_UNSUPPORTED;
 }
 
 //
@@ -195,6 +507,37 @@ EFI_RNG_PROTOCOL mOpteeRng = {
   GetRNG
 };
 
+/**
+  Stop the pool timer, close the trusted application session and wipe the
+  DRBG state and pool at ExitBootServices().
+
+  @param[in] Event            The ExitBootServices event.
+  @param[in] Context          Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+OpteeRngExitBootServices (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  gBS->SetTimer (mPoolFillEvent, TimerCancel, 0);
+
+  if (mSessionOpen) {
+    OpteeCloseSession (mSession);
+    mSessionOpen = FALSE;
+  }
+
+  ZeroMem (mEntropyPool, sizeof (mEntropyPool));
+  mEntropyPoolFill = 0;
+
+  ZeroMem (mDrbgKey, sizeof (mDrbgKey));
+  ZeroMem (mDrbgV, sizeof (mDrbgV));
+  mDrbgInstantiated = FALSE;
+}
+
 /**
   The user Entry Point for the OP-TEE Random Number Generator (RNG) driver.
 
@@ -233,13 +576,38 @@ OpteeRngEntry (
   CopyMem (&OpenSessionArg.Uuid, &gOpteeRngTaGuid, sizeof (EFI_GUID));
 
   //
-  //  Try to open session with RNG Trusted Application to check if its present
+  //  Open the session with the RNG Trusted Application, which also checks
+  //  that it is present, and keep it open until ExitBootServices()
   //
   Status = OpteeOpenSession (&OpenSessionArg);
   if ((Status != EFI_SUCCESS) || (OpenSessionArg.Return != OPTEE_SUCCESS)) {
     return EFI_NOT_FOUND;
-  } else {
-    OpteeCloseSession (OpenSessionArg.Session);
+  }
+  mSession = OpenSessionArg.Session;
+  mSessionOpen = TRUE;
+
+  mDrbgHmacContext = HmacSha256New ();
+  if (mDrbgHmacContext == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto CloseSession;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL, TPL_NOTIFY,
+                  OpteeRngFillPool, NULL, &mPoolFillEvent);
+  if (EFI_ERROR (Status)) {
+    goto FreeHmac;
+  }
+
+  Status = gBS->SetTimer (mPoolFillEvent, TimerPeriodic,
+                  OPTEE_RNG_FILL_PERIOD);
+  if (EFI_ERROR (Status)) {
+    goto CloseFillEvent;
+  }
+
+  Status = gBS->CreateEvent (EVT_SIGNAL_EXIT_BOOT_SERVICES, TPL_NOTIFY,
+                  OpteeRngExitBootServices, NULL, &mExitBootServicesEvent);
+  if (EFI_ERROR (Status)) {
+    goto CloseFillEvent;
   }
 
   //
@@ -254,10 +622,25 @@ OpteeRngEntry (
     DEBUG ((DEBUG_ERROR,
       "Failed to install OP-TEE RNG protocol interface (Status == %r)\n",
     Status));
-    return Status;
+    goto CloseExitBootServicesEvent;
   }
 
   DEBUG ((DEBUG_INIT | DEBUG_INFO, "*** Installed OpteeRng driver! ***\n"));
 
   return EFI_SUCCESS;
+
+CloseExitBootServicesEvent:
+  gBS->CloseEvent (mExitBootServicesEvent);
+
+CloseFillEvent:
+  gBS->CloseEvent (mPoolFillEvent);
+
+FreeHmac:
+  HmacSha256Free (mDrbgHmacContext);
+
+CloseSession:
+  OpteeCloseSession (mSession);
+  mSessionOpen = FALSE;
+
+  return Status;
 }
@@ -119,8 +119,6 @@ DriverStart (
   EFI_MAC_ADDRESS                  *SwapMacAddressPtr;
   UINTN                            DescriptorSize;
   UINTN                            BufferSize;
-  UINTN                            *RxBufferAddr;
-  EFI_PHYSICAL_ADDRESS             RxBufferAddrMap;
 
   // Allocate Resources
   Snp = AllocatePages (EFI_SIZE_TO_PAGES (sizeof (SIMPLE_NETWORK_DRIVER)));
@@ -137,9 +135,6 @@ DriverStart (
 
   // Size for descriptor
   DescriptorSize = EFI_PAGES_TO_SIZE (sizeof (DESIGNWARE_HW_DESCRIPTOR));
-  // Size for transmit and receive buffer
-  BufferSize = ETH_BUFSIZE;
-
   for (int Index=0; Index < DESC_NUM; Index++) {
     //DMA TxdescRing allocate buffer and map
     Status = DmaAllocateBuffer (EfiBootServicesData,
@@ -170,16 +165,38 @@ DriverStart (
       DEBUG ((DEBUG_ERROR, "%a () for RxdescRing: %r\n", __FUNCTION__, Status));
       return Status;
     }
+  }
 
-    //DMA mapping for receive buffer
-    RxBufferAddr = (UINTN*)((UINTN)Snp->MacDriver.RxBuffer + (Index * BufferSize));
-    Status = DmaMap (MapOperationBusMasterWrite,  (VOID *) RxBufferAddr,
-               &BufferSize, &RxBufferAddrMap, &Snp->MacDriver.RxBufNum[Index].Mapping);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "%a () for Rxbuffer: %r\n", __FUNCTION__, Status));
-      return Status;
-    }
-    Snp->MacDriver.RxBufNum[Index].AddrMap= RxBufferAddrMap;
+  // DMA TxBuffer allocate buffer and map once, Transmit () copies into it
+  Status = DmaAllocateBuffer (EfiBootServicesData,
+             EFI_SIZE_TO_PAGES (TX_TOTAL_BUFSIZE), (VOID *)&Snp->MacDriver.TxBuffer);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a () for TxBuffer: %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  BufferSize = TX_TOTAL_BUFSIZE;
+  Status = DmaMap (MapOperationBusMasterCommonBuffer, Snp->MacDriver.TxBuffer,
+             &BufferSize, &Snp->MacDriver.TxBufferMap.AddrMap, &Snp->MacDriver.TxBufferMap.Mapping);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a () for TxBuffer: %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  // DMA RxBuffer allocate buffer and map once, Receive () copies out of it
+  Status = DmaAllocateBuffer (EfiBootServicesData,
+             EFI_SIZE_TO_PAGES (RX_TOTAL_BUFSIZE), (VOID *)&Snp->MacDriver.RxBuffer);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a () for RxBuffer: %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  BufferSize = RX_TOTAL_BUFSIZE;
+  Status = DmaMap (MapOperationBusMasterCommonBuffer, Snp->MacDriver.RxBuffer,
+             &BufferSize, &Snp->MacDriver.RxBufferMap.AddrMap, &Snp->MacDriver.RxBufferMap.Mapping);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a () for RxBuffer: %r\n", __FUNCTION__, Status));
+    return Status;
   }
 
   DevicePath = (SIMPLE_NETWORK_DEVICE_PATH*)AllocateCopyPool (sizeof (SIMPLE_NETWORK_DEVICE_PATH), &PathTemplate);
@@ -216,12 +233,7 @@ DriverStart (
   Snp->Snp.Transmit = SnpTransmit;
   Snp->Snp.Receive = SnpReceive;
 
-  Snp->RecycledTxBuf = AllocatePool (sizeof (UINT64) * SNP_TX_BUFFER_INCREASE);
-  if (Snp->RecycledTxBuf == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-  }
-
-  Snp->MaxRecycledTxBuf = SNP_TX_BUFFER_INCREASE;
+  Snp->RecycledTxBufHead = 0;
   Snp->RecycledTxBufCount = 0;
 
   // Start completing simple network mode structure
@@ -335,7 +347,11 @@ DriverStop (
     return Status;
   }
 
-  FreePool (Snp->RecycledTxBuf);
+  DmaUnmap (Snp->MacDriver.TxBufferMap.Mapping);
+  DmaFreeBuffer (EFI_SIZE_TO_PAGES (TX_TOTAL_BUFSIZE), Snp->MacDriver.TxBuffer);
+  DmaUnmap (Snp->MacDriver.RxBufferMap.Mapping);
+  DmaFreeBuffer (EFI_SIZE_TO_PAGES (RX_TOTAL_BUFSIZE), Snp->MacDriver.RxBuffer);
+
   FreePages (Snp, EFI_SIZE_TO_PAGES (sizeof (SIMPLE_NETWORK_DRIVER)));
 
   return Status;
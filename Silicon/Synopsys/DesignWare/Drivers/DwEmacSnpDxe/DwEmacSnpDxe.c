@@ -768,6 +768,50 @@ SnpNvData (
 }
 
 
+/**
+  Move the caller buffers of the transmit descriptors the DMA engine has
+  completed into the recycled transmit buffer ring.
+
+  Descriptors are reclaimed oldest first and only once their OWN bit has been
+  cleared by the hardware, so a buffer is never reported as transmitted while
+  the frame is still in flight.
+
+  @param Snp        A pointer to the SIMPLE_NETWORK_DRIVER instance.
+
+**/
+STATIC
+VOID
+SnpReclaimTxDescriptors (
+  IN  SIMPLE_NETWORK_DRIVER   *Snp
+  )
+{
+  EMAC_DRIVER                *MacDriver;
+  DESIGNWARE_HW_DESCRIPTOR   *TxDescriptor;
+  UINT32                     DescNum;
+  UINT32                     Tail;
+
+  MacDriver = &Snp->MacDriver;
+
+  while (MacDriver->TxDescriptorsInUse > 0) {
+    DescNum = MacDriver->TxCurrentDescriptorNum;
+    TxDescriptor = MacDriver->TxdescRing[DescNum];
+    if (TxDescriptor->Tdes0 & TDES0_OWN) {
+      break;
+    }
+
+    // Transmit () never queues more frames than the recycle ring can hold
+    ASSERT (Snp->RecycledTxBufCount < SNP_TX_RECYCLED_BUF_NUM);
+    Tail = (Snp->RecycledTxBufHead + Snp->RecycledTxBufCount) % SNP_TX_RECYCLED_BUF_NUM;
+    Snp->RecycledTxBuf[Tail] = MacDriver->TxPacket[DescNum];
+    Snp->RecycledTxBufCount++;
+    MacDriver->TxPacket[DescNum] = NULL;
+
+    MacDriver->TxDescriptorsInUse--;
+    MacDriver->TxCurrentDescriptorNum = (DescNum + 1) % CONFIG_TX_DESCR_NUM;
+  }
+}
+
+
 /**
   Reads the current interrupt status and recycled transmit buffer status from a
   network interface.
@@ -837,13 +881,22 @@ SnpGetStatus (
 
   // TxBuff
   if (TxBuff != NULL) {
-    // Get a recycled buf from Snp->RecycledTxBuf
+    if (EFI_ERROR (EfiAcquireLockOrFail (&Snp->Lock))) {
+      return EFI_ACCESS_DENIED;
+    }
+
+    SnpReclaimTxDescriptors (Snp);
+
+    // Get the oldest recycled buf from Snp->RecycledTxBuf
     if (Snp->RecycledTxBufCount == 0) {
       *TxBuff = NULL;
     } else {
+      *TxBuff = Snp->RecycledTxBuf[Snp->RecycledTxBufHead];
+      Snp->RecycledTxBufHead = (Snp->RecycledTxBufHead + 1) % SNP_TX_RECYCLED_BUF_NUM;
       Snp->RecycledTxBufCount--;
-      *TxBuff = (VOID *)(UINTN) Snp->RecycledTxBuf[Snp->RecycledTxBufCount];
     }
+
+    EfiReleaseLock (&Snp->Lock);
   }
 
   // Check DMA Irq status
@@ -923,40 +976,22 @@ SnpTransmit (
   SIMPLE_NETWORK_DRIVER      *Snp;
   UINT32                     DescNum;
   DESIGNWARE_HW_DESCRIPTOR   *TxDescriptor;
-  DESIGNWARE_HW_DESCRIPTOR   *TxDescriptorMap;
   UINT8                      *EthernetPacket;
-  UINT64                     *Tmp;
   EFI_STATUS                 Status;
-  UINTN                      BufferSizeBuf;
-  EFI_PHYSICAL_ADDRESS       TxBufferAddrMap;
 
-  BufferSizeBuf = ETH_BUFSIZE;
   EthernetPacket = Data;
 
-  Snp = INSTANCE_FROM_SNP_THIS (This);
-
-  if (EFI_ERROR (EfiAcquireLockOrFail (&Snp->Lock))) {
-    return EFI_ACCESS_DENIED;
-  }
-
-  if ((Snp->MaxRecycledTxBuf + SNP_TX_BUFFER_INCREASE) >= SNP_MAX_TX_BUFFER_NUM) {
-    return EFI_NOT_READY;
-  }
-
   // Check preliminaries
   if ((This == NULL) || (Data == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
+
+  Snp = INSTANCE_FROM_SNP_THIS (This);
+
   if (Snp->SnpMode.State != EfiSimpleNetworkInitialized) {
     return EFI_NOT_STARTED;
   }
 
-  Snp->MacDriver.TxCurrentDescriptorNum = Snp->MacDriver.TxNextDescriptorNum;
-  DescNum = Snp->MacDriver.TxCurrentDescriptorNum;
-
-  TxDescriptor = Snp->MacDriver.TxdescRing[DescNum];
-  TxDescriptorMap = (VOID *)(UINTN)Snp->MacDriver.TxdescRingMap[DescNum].AddrMap;
-
   // Ensure header is correct size if non-zero
   if (HdrSize) {
     if (HdrSize != Snp->SnpMode.MediaHeaderSize) {
@@ -972,6 +1007,25 @@ SnpTransmit (
   if (BuffSize < Snp->SnpMode.MediaHeaderSize) {
     return EFI_BUFFER_TOO_SMALL;
   }
+  if (BuffSize > CONFIG_ETH_BUFSIZE) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (EFI_ERROR (EfiAcquireLockOrFail (&Snp->Lock))) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  SnpReclaimTxDescriptors (Snp);
+
+  // Every queued frame must fit in the recycle ring once it completes
+  if ((Snp->MacDriver.TxDescriptorsInUse >= CONFIG_TX_DESCR_NUM) ||
+      (Snp->MacDriver.TxDescriptorsInUse + Snp->RecycledTxBufCount >= SNP_TX_RECYCLED_BUF_NUM)) {
+    Status = EFI_NOT_READY;
+    goto ReleaseLock;
+  }
+
+  DescNum = Snp->MacDriver.TxNextDescriptorNum;
+  TxDescriptor = Snp->MacDriver.TxdescRing[DescNum];
 
   if (HdrSize) {
     EthernetPacket[0] = DstAddr->Addr[0];
@@ -992,23 +1046,23 @@ SnpTransmit (
     EthernetPacket[12] = (*Protocol & 0xFF00) >> 8;
   }
 
-  CopyMem ((VOID *)(UINTN)TxDescriptor->Addr, EthernetPacket, BuffSize);
-
-  Status = DmaMap (MapOperationBusMasterRead, (VOID *)(UINTN)TxDescriptor->Addr,
-             &BufferSizeBuf, &TxBufferAddrMap, &Snp->MappingTxbuf);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a () for Txbuffer: %r\n", __FUNCTION__, Status));
-    return Status;
-  }
-  TxDescriptorMap->Addr = TxBufferAddrMap;
+  // The transmit buffer is mapped as a common buffer, no per-frame mapping
+  CopyMem (Snp->MacDriver.TxBuffer + DescNum * CONFIG_ETH_BUFSIZE, EthernetPacket, BuffSize);
 
   TxDescriptor->Tdes1 = (BuffSize << TDES1_SIZE1SHFT) &
                          TDES1_SIZE1MASK;
 
+  // Make sure the frame and the size are visible before handing it over
+  MemoryFence ();
+
   TxDescriptor->Tdes0 |= (TDES0_TXFIRST |
                           TDES0_TXLAST |
                           TDES0_OWN);
 
+  // Data is recycled by GetStatus () once the descriptor has been completed
+  Snp->MacDriver.TxPacket[DescNum] = Data;
+  Snp->MacDriver.TxDescriptorsInUse++;
+
   // Increase descriptor number
   DescNum++;
 
@@ -1018,26 +1072,14 @@ SnpTransmit (
 
   Snp->MacDriver.TxNextDescriptorNum = DescNum;
 
-  if (Snp->RecycledTxBufCount < Snp->MaxRecycledTxBuf) {
-    Snp->RecycledTxBuf[Snp->RecycledTxBufCount] = (UINT64)(UINTN)Data;
-    Snp->RecycledTxBufCount ++;
-  } else {
-    Tmp = AllocatePool (sizeof (UINT64) * (Snp->MaxRecycledTxBuf + SNP_TX_BUFFER_INCREASE));
-    if (Tmp == NULL) {
-      return EFI_DEVICE_ERROR;
-    }
-    CopyMem (Tmp, Snp->RecycledTxBuf, sizeof (UINT64) * Snp->RecycledTxBufCount);
-    FreePool (Snp->RecycledTxBuf);
-    Snp->RecycledTxBuf = Tmp;
-    Snp->MaxRecycledTxBuf += SNP_TX_BUFFER_INCREASE;
-  }
-
   // Start the transmission
   EmacDmaStart (Snp->MacBase);
 
-  DmaUnmap (Snp->MappingTxbuf);
+  Status = EFI_SUCCESS;
+
+ReleaseLock:
   EfiReleaseLock (&Snp->Lock);
-  return EFI_SUCCESS;
+  return Status;
 }
 
 /**
@@ -1109,21 +1151,16 @@ SnpReceive (
   UINT8                      *RawData;
   UINT32                     DescNum;
   DESIGNWARE_HW_DESCRIPTOR   *RxDescriptor;
-  DESIGNWARE_HW_DESCRIPTOR   *RxDescriptorMap;
-  UINTN                      BufferSizeBuf;
-  UINTN                      *RxBufferAddr;
-  EFI_PHYSICAL_ADDRESS       RxBufferAddrMap;
+  UINT8                      *RxBufferAddr;
   EFI_STATUS                 Status;
 
-  BufferSizeBuf = ETH_BUFSIZE;
-
-  Snp = INSTANCE_FROM_SNP_THIS (This);
-
   // Check preliminaries
-  if ((This == NULL) || (Data == NULL)) {
+  if ((This == NULL) || (BuffSize == NULL) || (Data == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
+  Snp = INSTANCE_FROM_SNP_THIS (This);
+
   if (Snp->SnpMode.State != EfiSimpleNetworkInitialized) {
     return EFI_NOT_STARTED;
   }
@@ -1135,25 +1172,27 @@ SnpReceive (
   Snp->MacDriver.RxCurrentDescriptorNum = Snp->MacDriver.RxNextDescriptorNum;
   DescNum = Snp->MacDriver.RxCurrentDescriptorNum;
   RxDescriptor = Snp->MacDriver.RxdescRing[DescNum];
-  RxBufferAddr = (UINTN*)((UINTN)Snp->MacDriver.RxBuffer +
-                          (DescNum * BufferSizeBuf));
-  RxDescriptorMap = (VOID *)(UINTN)Snp->MacDriver.RxdescRingMap[DescNum].AddrMap;
+  // The receive buffer is mapped as a common buffer, read the frame in place
+  RxBufferAddr = (UINT8 *)Snp->MacDriver.RxBuffer + DescNum * CONFIG_ETH_BUFSIZE;
 
   RawData = (UINT8 *) Data;
 
   DescriptorStatus = RxDescriptor->Tdes0;
   if (DescriptorStatus & ((UINT32)RDES0_OWN)) {
-    goto ReleaseLock;
+    EfiReleaseLock (&Snp->Lock);
+    return EFI_NOT_READY;
   }
 
   if (DescriptorStatus & RDES0_SAF) {
     DEBUG ((DEBUG_WARN, "SNP:DXE: Rx Descritpor Status Error: Source Address Filter Fail\n"));
-    return EFI_DEVICE_ERROR;
+    Status = EFI_DEVICE_ERROR;
+    goto RecycleDescriptor;
   }
 
   if (DescriptorStatus & RDES0_AFM) {
     DEBUG ((DEBUG_WARN, "SNP:DXE: Rx Descritpor Status Error: Destination Address Filter Fail\n"));
-    return EFI_DEVICE_ERROR;
+    Status = EFI_DEVICE_ERROR;
+    goto RecycleDescriptor;
   }
 
   if (DescriptorStatus & RDES0_ES) {
@@ -1187,17 +1226,21 @@ SnpReceive (
     if (DescriptorStatus & RDES0_CE) {
       DEBUG ((DEBUG_WARN, "SNP:DXE: Rx Descritpor Status Error: CRC Error\n"));
     }
-    return EFI_DEVICE_ERROR;
+    Status = EFI_DEVICE_ERROR;
+    goto RecycleDescriptor;
   }
 
   Length = (DescriptorStatus >> RDES0_FL_SHIFT) & RDES0_FL_MASK;
-  if (!Length) {
+  if (!Length || (Length > CONFIG_ETH_BUFSIZE)) {
     DEBUG ((DEBUG_WARN, "SNP:DXE: Error: Invalid Frame Packet length \r\n"));
-    return EFI_NOT_READY;
+    Status = EFI_NOT_READY;
+    goto RecycleDescriptor;
   }
-  // Check buffer size
+  // Check buffer size, the frame stays queued until the caller retries
   if (*BuffSize < Length) {
     DEBUG ((DEBUG_WARN, "SNP:DXE: Error: Buffer size is too small\n"));
+    *BuffSize = Length;
+    EfiReleaseLock (&Snp->Lock);
     return EFI_BUFFER_TOO_SMALL;
   }
   *BuffSize = Length;
@@ -1205,10 +1248,7 @@ SnpReceive (
   if (HdrSize != NULL)
     *HdrSize = Snp->SnpMode.MediaHeaderSize;
 
-  DmaUnmap (Snp->MacDriver.RxBufNum[DescNum].Mapping);
-  Snp->MacDriver.RxBufNum[DescNum].Mapping = NULL;
-
-  CopyMem (RawData, (VOID *)RxBufferAddr, *BuffSize);
+  CopyMem (RawData, RxBufferAddr, *BuffSize);
 
   if (DstAddr != NULL) {
     Dst.Addr[0] = RawData[0];
@@ -1238,17 +1278,11 @@ SnpReceive (
     *Protocol = NTOHS (RawData[12] | (RawData[13] >> 8) | (RawData[14] >> 16) | (RawData[15] >> 24));
   }
 
-  // DMA map for the current receive buffer
-  Status = DmaMap (MapOperationBusMasterWrite,  (VOID *)RxBufferAddr,
-             &BufferSizeBuf, &RxBufferAddrMap, &Snp->MacDriver.RxBufNum[DescNum].Mapping);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a () for Rxbuffer: %r\n", __FUNCTION__, Status));
-    return Status;
-  }
-  Snp->MacDriver.RxBufNum[DescNum].AddrMap = RxBufferAddrMap;
-  RxDescriptorMap->Addr = Snp->MacDriver.RxBufNum[DescNum].AddrMap;
+  Status = EFI_SUCCESS;
 
-  RxDescriptor->Tdes0 |= (UINT32)RDES0_OWN;
+RecycleDescriptor:
+  // Hand the descriptor back to the DMA engine, the buffer stays mapped
+  RxDescriptor->Tdes0 = (UINT32)RDES0_OWN;
 
   // Increase descriptor number
   DescNum++;
@@ -1259,10 +1293,6 @@ SnpReceive (
   Snp->MacDriver.RxNextDescriptorNum = DescNum;
 
   EfiReleaseLock (&Snp->Lock);
-  return EFI_SUCCESS;
-
-ReleaseLock:
-  EfiReleaseLock (&Snp->Lock);
-  return EFI_NOT_READY;
+  return Status;
 }
 
@@ -232,7 +232,7 @@ EmacSetupTxdesc (
 
   for (Index = 0; Index < CONFIG_TX_DESCR_NUM; Index++) {
     TxDescriptor = (VOID *)(UINTN)EmacDriver->TxdescRingMap[Index].AddrMap;
-    TxDescriptor->Addr = (UINT32)(UINTN)&EmacDriver->TxBuffer[Index * CONFIG_ETH_BUFSIZE];
+    TxDescriptor->Addr = (UINT32)(EmacDriver->TxBufferMap.AddrMap + Index * CONFIG_ETH_BUFSIZE);
     if (Index < 9) {
       TxDescriptor->AddrNext = (UINT32)(UINTN)EmacDriver->TxdescRingMap[Index + 1].AddrMap;
     }
@@ -251,6 +251,7 @@ EmacSetupTxdesc (
   // Initialize the descriptor number
   EmacDriver->TxCurrentDescriptorNum = 0;
   EmacDriver->TxNextDescriptorNum = 0;
+  EmacDriver->TxDescriptorsInUse = 0;
 
   return EFI_SUCCESS;
 }
@@ -268,7 +269,7 @@ EmacSetupRxdesc (
 
   for (Index = 0; Index < CONFIG_RX_DESCR_NUM; Index++) {
     RxDescriptor = (VOID *)(UINTN)EmacDriver->RxdescRingMap[Index].AddrMap;
-    RxDescriptor->Addr = EmacDriver->RxBufNum[Index].AddrMap;
+    RxDescriptor->Addr = (UINT32)(EmacDriver->RxBufferMap.AddrMap + Index * CONFIG_ETH_BUFSIZE);
     if (Index < 9) {
       RxDescriptor->AddrNext = (UINT32)(UINTN)EmacDriver->RxdescRingMap[Index + 1].AddrMap;
     }
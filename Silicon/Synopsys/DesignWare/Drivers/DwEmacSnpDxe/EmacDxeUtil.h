@@ -244,11 +244,17 @@ typedef struct {
 typedef struct {
   DESIGNWARE_HW_DESCRIPTOR    *TxdescRing[CONFIG_TX_DESCR_NUM];
   DESIGNWARE_HW_DESCRIPTOR    *RxdescRing[CONFIG_RX_DESCR_NUM];
-  CHAR8                       TxBuffer[TX_TOTAL_BUFSIZE];
-  CHAR8                       RxBuffer[RX_TOTAL_BUFSIZE];
+  // Transmit and receive buffers, mapped once as common buffers
+  CHAR8                       *TxBuffer;
+  CHAR8                       *RxBuffer;
+  MAP_INFO                    TxBufferMap;
+  MAP_INFO                    RxBufferMap;
   MAP_INFO                    TxdescRingMap[CONFIG_TX_DESCR_NUM ];
   MAP_INFO                    RxdescRingMap[CONFIG_RX_DESCR_NUM ];
-  MAP_INFO                    RxBufNum[CONFIG_TX_DESCR_NUM];
+  // Caller buffers of the frames owned by the transmit descriptors
+  VOID                        *TxPacket[CONFIG_TX_DESCR_NUM];
+  UINT32                      TxDescriptorsInUse;
+  // Oldest in-flight and next free transmit descriptor
   UINT32                      TxCurrentDescriptorNum;
   UINT32                      TxNextDescriptorNum;
   UINT32                      RxCurrentDescriptorNum;
@@ -93,6 +93,9 @@
 #define DWEMMC_INT_DTO                          (1 << 3)        /* Data trans over */
 #define DWEMMC_INT_CMD_DONE                     (1 << 2)
 #define DWEMMC_INT_RE                           (1 << 1)
+#define DWEMMC_INT_ERROR_MASK                   (DWEMMC_INT_EBE | DWEMMC_INT_HLE | DWEMMC_INT_RTO | \
+                                                 DWEMMC_INT_RCRC | DWEMMC_INT_RE | DWEMMC_INT_DCRC | \
+                                                 DWEMMC_INT_DRT | DWEMMC_INT_SBE)
 
 #define DWEMMC_IDMAC_DES0_DIC                   (1 << 1)
 #define DWEMMC_IDMAC_DES0_LD                    (1 << 2)
@@ -29,8 +29,16 @@
 
 #define DWEMMC_DESC_PAGE                1
 #define DWEMMC_BLOCK_SIZE               512
-#define DWEMMC_DMA_BUF_SIZE             (512 * 8)
+// Largest block multiple that fits the 13-bit IDMAC buffer size field
+#define DWEMMC_DMA_BUF_SIZE             (512 * 15)
 #define DWEMMC_MAX_DESC_PAGES           512
+#define DWEMMC_MAX_DESC_COUNT           (DWEMMC_MAX_DESC_PAGES * EFI_PAGE_SIZE / \
+                                         sizeof (DWEMMC_IDMAC_DESCRIPTOR))
+
+// Data transfer deadline: a fixed allowance plus a per-MiB allowance
+#define DWEMMC_DATA_TIMEOUT_BASE_MS     1000
+#define DWEMMC_DATA_TIMEOUT_PER_MB_MS   250
+#define DWEMMC_DATA_POLL_INTERVAL_US    10
 
 typedef struct {
   UINT32                        Des0;
@@ -44,6 +52,7 @@ DWEMMC_IDMAC_DESCRIPTOR   *gpIdmacDesc;
 EFI_GUID mDwEmmcDevicePathGuid = EFI_CALLER_ID_GUID;
 STATIC UINT32 mDwEmmcCommand;
 STATIC UINT32 mDwEmmcArgument;
+STATIC EFI_EVENT mDwEmmcDataTimeoutEvent;
 
 EFI_STATUS
 DwEmmcReadBlockData (
@@ -269,13 +278,13 @@ IsPendingWriteCommand (
   return FALSE;
 }
 
-EFI_STATUS
-SendCommand (
+VOID
+IssueCommand (
   IN MMC_CMD                    MmcCmd,
   IN UINT32                     Argument
   )
 {
-  UINT32      Data, ErrMask;
+  UINT32      Data;
 
   // Wait until MMC is idle
   do {
@@ -285,10 +294,19 @@ SendCommand (
   MmioWrite32 (DWEMMC_RINTSTS, ~0);
   MmioWrite32 (DWEMMC_CMDARG, Argument);
   MmioWrite32 (DWEMMC_CMD, MmcCmd);
+}
+
+EFI_STATUS
+SendCommand (
+  IN MMC_CMD                    MmcCmd,
+  IN UINT32                     Argument
+  )
+{
+  UINT32      Data, ErrMask;
 
-  ErrMask = DWEMMC_INT_EBE | DWEMMC_INT_HLE | DWEMMC_INT_RTO |
-            DWEMMC_INT_RCRC | DWEMMC_INT_RE;
-  ErrMask |= DWEMMC_INT_DCRC | DWEMMC_INT_DRT | DWEMMC_INT_SBE;
+  IssueCommand (MmcCmd, Argument);
+
+  ErrMask = DWEMMC_INT_ERROR_MASK;
   do {
     MicroSecondDelay(500);
     Data = MmioRead32 (DWEMMC_RINTSTS);
@@ -465,6 +483,9 @@ PrepareDmaData (
   UINTN  Cnt, Blks, Idx, LastIdx;
 
   Cnt = (Length + DWEMMC_DMA_BUF_SIZE - 1) / DWEMMC_DMA_BUF_SIZE;
+  if ((Cnt == 0) || (Cnt > DWEMMC_MAX_DESC_COUNT)) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
   Blks = (Length + DWEMMC_BLOCK_SIZE - 1) / DWEMMC_BLOCK_SIZE;
   Length = DWEMMC_BLOCK_SIZE * Blks;
 
@@ -511,6 +532,73 @@ StartDma (
   MmioWrite32 (DWEMMC_BYTCNT, Length);
 }
 
+/**
+  Issue the pending data command and wait for the IDMAC chain to complete.
+
+  The command is started as soon as the descriptor chain is live, and the
+  data phase is then polled at a short interval against a deadline tracked
+  by a one-shot timer event, scaled with the size of the transfer. This
+  replaces the fixed 500us sleep per poll of SendCommand (), which dominated
+  small transfers and returned on CMD_DONE before the data phase of large
+  chains had finished.
+
+  The caller holds TPL_NOTIFY while the transfer is set up. Once the command
+  has been issued, the TPL is dropped to WaitTpl for the data phase so that
+  timer and other notify-level events keep running while the transfer is in
+  flight, and raised back to TPL_NOTIFY before returning.
+
+  @param[in]  Length    The number of bytes being transferred.
+  @param[in]  WaitTpl   The TPL to wait for the data phase at, no higher than
+                        TPL_NOTIFY.
+
+  @retval EFI_SUCCESS       The data phase completed.
+  @retval EFI_DEVICE_ERROR  The controller reported a command or data error.
+  @retval EFI_TIMEOUT       The data phase did not complete in time.
+
+**/
+EFI_STATUS
+DwEmmcTransferData (
+  IN UINTN                      Length,
+  IN EFI_TPL                    WaitTpl
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Data;
+  UINT64      TimeoutMs;
+
+  TimeoutMs = DWEMMC_DATA_TIMEOUT_BASE_MS +
+              DWEMMC_DATA_TIMEOUT_PER_MB_MS * (Length >> 20);
+  Status = gBS->SetTimer (mDwEmmcDataTimeoutEvent, TimerRelative,
+                  EFI_TIMER_PERIOD_MILLISECONDS (TimeoutMs));
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  IssueCommand (mDwEmmcCommand, mDwEmmcArgument);
+  gBS->RestoreTPL (WaitTpl);
+
+  for (;;) {
+    Data = MmioRead32 (DWEMMC_RINTSTS);
+    if (Data & DWEMMC_INT_ERROR_MASK) {
+      Status = EFI_DEVICE_ERROR;
+      break;
+    }
+    if (Data & DWEMMC_INT_DTO) {     // Transfer Done
+      Status = EFI_SUCCESS;
+      break;
+    }
+    if (!EFI_ERROR (gBS->CheckEvent (mDwEmmcDataTimeoutEvent))) {
+      Status = EFI_TIMEOUT;
+      break;
+    }
+    MicroSecondDelay (DWEMMC_DATA_POLL_INTERVAL_US);
+  }
+
+  gBS->RaiseTPL (TPL_NOTIFY);
+  gBS->SetTimer (mDwEmmcDataTimeoutEvent, TimerCancel, 0);
+  return Status;
+}
+
 EFI_STATUS
 DwEmmcReadBlockData (
   IN EFI_MMC_HOST_PROTOCOL     *This,
@@ -539,11 +627,18 @@ DwEmmcReadBlockData (
   WriteBackDataCacheRange (gpIdmacDesc, DescPages * EFI_PAGE_SIZE);
   StartDma (Length);
 
-  Status = SendCommand (mDwEmmcCommand, mDwEmmcArgument);
+  //
+  // BlockIo callers run at TPL_CALLBACK or below, so waiting at TPL_CALLBACK
+  // still keeps them from re-entering the controller during the data phase.
+  //
+  Status = DwEmmcTransferData (Length, MAX (Tpl, TPL_CALLBACK));
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to read data, mDwEmmcCommand:%x, mDwEmmcArgument:%x, Status:%r\n", mDwEmmcCommand, mDwEmmcArgument, Status));
     goto out;
   }
+
+  // Drop any lines speculatively fetched while the transfer was in flight
+  InvalidateDataCacheRange (Buffer, Length);
 out:
   // Restore Tpl
   gBS->RestoreTPL (Tpl);
@@ -578,7 +673,11 @@ DwEmmcWriteBlockData (
   WriteBackDataCacheRange (gpIdmacDesc, DescPages * EFI_PAGE_SIZE);
   StartDma (Length);
 
-  Status = SendCommand (mDwEmmcCommand, mDwEmmcArgument);
+  //
+  // BlockIo callers run at TPL_CALLBACK or below, so waiting at TPL_CALLBACK
+  // still keeps them from re-entering the controller during the data phase.
+  //
+  Status = DwEmmcTransferData (Length, MAX (Tpl, TPL_CALLBACK));
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to write data, mDwEmmcCommand:%x, mDwEmmcArgument:%x, Status:%r\n", mDwEmmcCommand, mDwEmmcArgument, Status));
     goto out;
@@ -684,6 +783,13 @@ DwEmmcDxeInitialize (
     return EFI_BUFFER_TOO_SMALL;
   }
 
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL,
+                  &mDwEmmcDataTimeoutEvent);
+  if (EFI_ERROR (Status)) {
+    FreePages (gpIdmacDesc, DWEMMC_MAX_DESC_PAGES);
+    return Status;
+  }
+
   DEBUG ((DEBUG_BLKIO, "DwEmmcDxeInitialize()\n"));
 
   //Publish Component Name, BlockIO protocol interfaces